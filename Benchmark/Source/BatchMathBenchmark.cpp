@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BatchMath.h"
+#include "Mtx44Kernels.h"
+
+static const unsigned NUM_VECTORS = 4096;
+static const unsigned ITERATIONS = 256;
+
+/******************************************************************************/
+/*!
+\brief
+Compare BatchMath on SoA streams against the one vector at a time code it
+replaces: Mtx44Kernels::Transform per point, as operator*(Mtx44, Position)
+does, and Vector3::Normalize with its exception check.
+
+\return true if the batch results match the per vector results
+*/
+/******************************************************************************/
+bool RunBatchMathBenchmark()
+{
+	std::vector<Vector3> points(NUM_VECTORS);
+	std::vector<Vector3> pointsOut(NUM_VECTORS);
+	std::vector<float> soa(NUM_VECTORS * 3);
+	std::vector<float> soaOut(NUM_VECTORS * 3);
+	BatchMath::Stream3 in = { &soa[0], &soa[NUM_VECTORS], &soa[NUM_VECTORS * 2] };
+	BatchMath::Stream3 out = { &soaOut[0], &soaOut[NUM_VECTORS], &soaOut[NUM_VECTORS * 2] };
+
+	srand(2122);
+	for (unsigned i = 0; i < NUM_VECTORS; ++i)
+	{
+		points[i].Set(rand() / (float)RAND_MAX * 20 - 10, rand() / (float)RAND_MAX * 20 - 10, rand() / (float)RAND_MAX * 20 - 10);
+	}
+	points[NUM_VECTORS / 2].SetZero();
+	BatchMath::Gather(&points[0], sizeof(Vector3), NUM_VECTORS, in);
+
+	Mtx44 m;
+	m.SetToRotation(30, 1, 2, 3);
+	m.a[12] = 4;
+	m.a[13] = -5;
+	m.a[14] = 6;
+
+	bool passed = true;
+	bool matches;
+	double scalarNs, batchNs;
+
+	printf("BatchMath, %u vectors\n", NUM_VECTORS);
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned) {
+		for (unsigned i = 0; i < NUM_VECTORS; ++i)
+		{
+			float b[4] = { points[i].x, points[i].y, points[i].z, 1 };
+			Mtx44Kernels::Transform(m.a, b, b);
+			pointsOut[i].Set(b[0], b[1], b[2]);
+		}
+	}) / NUM_VECTORS;
+	batchNs = TimeNs(ITERATIONS, [&](unsigned) { BatchMath::TransformPoints(m, in, out, NUM_VECTORS); }) / NUM_VECTORS;
+	matches = true;
+	for (unsigned i = 0; i < NUM_VECTORS; ++i)
+		matches = matches && fabs(pointsOut[i].x - out.x[i]) < 1e-4f && fabs(pointsOut[i].y - out.y[i]) < 1e-4f && fabs(pointsOut[i].z - out.z[i]) < 1e-4f;
+	printf("%-16s per vector %6.2f ns  batch %6.2f ns  x%.2f%s\n", "TransformPoints", scalarNs, batchNs, scalarNs / batchNs, matches ? "" : "  MISMATCH");
+	passed = passed && matches;
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned) {
+		for (unsigned i = 0; i < NUM_VECTORS; ++i)
+		{
+			try
+			{
+				pointsOut[i] = points[i].Normalized();
+			}
+			catch (DivideByZero&)
+			{
+				pointsOut[i].SetZero();
+			}
+		}
+	}) / NUM_VECTORS;
+	batchNs = TimeNs(ITERATIONS, [&](unsigned) { BatchMath::Normalize(in, out, NUM_VECTORS); }) / NUM_VECTORS;
+	matches = true;
+	for (unsigned i = 0; i < NUM_VECTORS; ++i)
+		matches = matches && fabs(pointsOut[i].x - out.x[i]) < 1e-5f && fabs(pointsOut[i].y - out.y[i]) < 1e-5f && fabs(pointsOut[i].z - out.z[i]) < 1e-5f;
+	printf("%-16s per vector %6.2f ns  batch %6.2f ns  x%.2f%s\n", "Normalize", scalarNs, batchNs, scalarNs / batchNs, matches ? "" : "  MISMATCH");
+	passed = passed && matches;
+
+	Vector3 scalarMin = points[0], scalarMax = points[0];
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned) {
+		scalarMin = scalarMax = points[0];
+		for (unsigned i = 1; i < NUM_VECTORS; ++i)
+		{
+			scalarMin.Set(Math::Min(scalarMin.x, points[i].x), Math::Min(scalarMin.y, points[i].y), Math::Min(scalarMin.z, points[i].z));
+			scalarMax.Set(Math::Max(scalarMax.x, points[i].x), Math::Max(scalarMax.y, points[i].y), Math::Max(scalarMax.z, points[i].z));
+		}
+	}) / NUM_VECTORS;
+	Vector3 batchMin, batchMax;
+	batchNs = TimeNs(ITERATIONS, [&](unsigned) { BatchMath::ComputeAABB(in, NUM_VECTORS, batchMin, batchMax); }) / NUM_VECTORS;
+	matches = scalarMin == batchMin && scalarMax == batchMax;
+	printf("%-16s per vector %6.2f ns  batch %6.2f ns  x%.2f%s\n", "ComputeAABB", scalarNs, batchNs, scalarNs / batchNs, matches ? "" : "  MISMATCH");
+	passed = passed && matches;
+
+	return passed;
+}
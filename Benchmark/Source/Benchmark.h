@@ -0,0 +1,42 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+
+/******************************************************************************/
+/*!
+\brief
+Time iterations calls of body, best of a few runs so a stray context switch
+does not skew the result
+
+\param iterations - calls per run
+\param body - function to time
+
+\return nanoseconds per call
+*/
+/******************************************************************************/
+template<typename Body>
+double TimeNs(unsigned iterations, Body body)
+{
+	double best = 0;
+	for (int run = 0; run < 5; ++run)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < iterations; ++i)
+		{
+			body(i);
+		}
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::high_resolution_clock::now() - start;
+		double perCall = elapsed.count() / iterations;
+		if (run == 0 || perCall < best)
+			best = perCall;
+	}
+	return best;
+}
+
+//Each returns false if the fast path disagrees with the reference code
+bool RunMtx44Benchmark();
+bool RunBatchMathBenchmark();
+bool RunVertexBenchmark();
+
+#endif
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Mtx44Kernels.h"
+
+static const unsigned NUM_MATRICES = 1024;
+static const unsigned ITERATIONS = 1 << 20;
+
+struct alignas(16) Matrix
+{
+	float a[16];
+};
+
+static bool Matches(const float *lhs, const float *rhs, int count, float tolerance)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (fabs(lhs[i] - rhs[i]) > tolerance * (1 + fabs(lhs[i])))
+			return false;
+	}
+	return true;
+}
+
+static void Report(const char *name, double scalarNs, double simdNs, bool matches)
+{
+	printf("%-10s scalar %6.2f ns  %s %6.2f ns  x%.2f%s\n", name, scalarNs, Mtx44Kernels::InstructionSet(), simdNs,
+		scalarNs / simdNs, matches ? "" : "  MISMATCH");
+}
+
+/******************************************************************************/
+/*!
+\brief
+Compare the Mtx44Kernels fast paths against the scalar code Mtx44 used before
+them, on a ring of random well conditioned matrices so the loop is not
+simply timing one matrix sitting in registers.
+
+\return true if every fast path matches the scalar result
+*/
+/******************************************************************************/
+bool RunMtx44Benchmark()
+{
+	std::vector<Matrix> input(NUM_MATRICES);
+	std::vector<Matrix> scalarOut(NUM_MATRICES);
+	std::vector<Matrix> simdOut(NUM_MATRICES);
+	srand(2122);
+	for (unsigned i = 0; i < NUM_MATRICES; ++i)
+	{
+		for (int j = 0; j < 16; ++j)
+		{
+			input[i].a[j] = rand() / (float)RAND_MAX - 0.5f;
+		}
+		//Diagonally dominant, so every matrix has an inverse
+		for (int j = 0; j < 4; ++j)
+		{
+			input[i].a[j * 5] += 4;
+		}
+	}
+
+	const unsigned mask = NUM_MATRICES - 1;
+	bool passed = true;
+	bool matches;
+	double scalarNs, simdNs;
+
+	printf("Mtx44 kernels, %u calls each\n", ITERATIONS);
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::MultiplyScalar(input[i & mask].a, input[(i + 1) & mask].a, scalarOut[i & mask].a); });
+	simdNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::Multiply(input[i & mask].a, input[(i + 1) & mask].a, simdOut[i & mask].a); });
+	matches = true;
+	for (unsigned i = 0; i < NUM_MATRICES; ++i)
+		matches = matches && Matches(scalarOut[i].a, simdOut[i].a, 16, 1e-5f);
+	Report("Multiply", scalarNs, simdNs, matches);
+	passed = passed && matches;
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::TransformScalar(input[i & mask].a, input[(i + 1) & mask].a, scalarOut[i & mask].a); });
+	simdNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::Transform(input[i & mask].a, input[(i + 1) & mask].a, simdOut[i & mask].a); });
+	matches = true;
+	for (unsigned i = 0; i < NUM_MATRICES; ++i)
+		matches = matches && Matches(scalarOut[i].a, simdOut[i].a, 4, 1e-5f);
+	Report("Transform", scalarNs, simdNs, matches);
+	passed = passed && matches;
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::TransposeScalar(input[i & mask].a, scalarOut[i & mask].a); });
+	simdNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::Transpose(input[i & mask].a, simdOut[i & mask].a); });
+	matches = true;
+	for (unsigned i = 0; i < NUM_MATRICES; ++i)
+		matches = matches && Matches(scalarOut[i].a, simdOut[i].a, 16, 0);
+	Report("Transpose", scalarNs, simdNs, matches);
+	passed = passed && matches;
+
+	scalarNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::InverseScalar(input[i & mask].a, scalarOut[i & mask].a); });
+	simdNs = TimeNs(ITERATIONS, [&](unsigned i) { Mtx44Kernels::Inverse(input[i & mask].a, simdOut[i & mask].a); });
+	matches = true;
+	for (unsigned i = 0; i < NUM_MATRICES; ++i)
+		matches = matches && Matches(scalarOut[i].a, simdOut[i].a, 16, 1e-4f);
+	Report("Inverse", scalarNs, simdNs, matches);
+	passed = passed && matches;
+
+	return passed;
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Vertex.h"
+
+static const unsigned NUM_VERTICES = 4096;
+static const unsigned ITERATIONS = 1024;
+
+//Vector3 as it was before it became trivially copyable: user declared copy,
+//assignment and destructor, defined out of line like they were in Vector3.cpp
+struct LegacyVector3
+{
+	float x, y, z;
+
+	LegacyVector3(float a = 0, float b = 0, float c = 0);
+	LegacyVector3(const LegacyVector3 &rhs);
+	~LegacyVector3();
+	LegacyVector3& operator=(const LegacyVector3 &rhs);
+};
+
+struct LegacyVertex
+{
+	Position pos;
+	Color color;
+	LegacyVector3 normal;
+	TexCoord texCoord;
+};
+
+LegacyVector3::LegacyVector3(float a, float b, float c) : x(a), y(b), z(c)
+{
+}
+
+LegacyVector3::LegacyVector3(const LegacyVector3 &rhs) : x(rhs.x), y(rhs.y), z(rhs.z)
+{
+}
+
+LegacyVector3::~LegacyVector3()
+{
+}
+
+LegacyVector3& LegacyVector3::operator=(const LegacyVector3 &rhs)
+{
+	x = rhs.x;
+	y = rhs.y;
+	z = rhs.z;
+	return *this;
+}
+
+static_assert(!std::is_trivially_copyable<LegacyVertex>::value, "LegacyVertex should model the old Vertex");
+
+/******************************************************************************/
+/*!
+\brief
+Fill a vector of vertices the way the MeshBuilder generators do, then copy
+it as a whole
+
+\param fillNs - receives ns per vertex for the fill
+\param copyNs - receives ns per vertex for the copy
+\param copy - receives the copied vertices
+*/
+/******************************************************************************/
+template<typename VertexType>
+static void TimeVertices(double &fillNs, double &copyNs, std::vector<VertexType> &copy)
+{
+	std::vector<VertexType> vertices;
+	fillNs = TimeNs(ITERATIONS, [&](unsigned) {
+		vertices.clear();
+		vertices.reserve(NUM_VERTICES);
+		VertexType v;
+		for (unsigned i = 0; i < NUM_VERTICES; ++i)
+		{
+			v.pos.Set((float)i, 0, 0);
+			v.normal = decltype(v.normal)(0, 1, 0);
+			v.texCoord.Set(0, (float)i);
+			vertices.push_back(v);
+		}
+	}) / NUM_VERTICES;
+
+	copyNs = TimeNs(ITERATIONS, [&](unsigned) { copy = vertices; }) / NUM_VERTICES;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Compare filling and copying std::vector<Vertex> against the same vertex with
+the old, non trivially copyable Vector3
+
+\return true if both produce the same bytes
+*/
+/******************************************************************************/
+bool RunVertexBenchmark()
+{
+	std::vector<Vertex> vertices;
+	std::vector<LegacyVertex> legacyVertices;
+	double fillNs, copyNs, legacyFillNs, legacyCopyNs;
+	TimeVertices(fillNs, copyNs, vertices);
+	TimeVertices(legacyFillNs, legacyCopyNs, legacyVertices);
+
+	static_assert(sizeof(Vertex) == sizeof(LegacyVertex), "Layouts must match to compare bytes");
+	bool matches = vertices.size() == legacyVertices.size() &&
+		memcmp(&vertices[0], &legacyVertices[0], vertices.size() * sizeof(Vertex)) == 0;
+
+	printf("std::vector<Vertex>, %u vertices\n", NUM_VERTICES);
+	printf("%-6s before %6.2f ns  after %6.2f ns  x%.2f\n", "Fill", legacyFillNs, fillNs, legacyFillNs / fillNs);
+	printf("%-6s before %6.2f ns  after %6.2f ns  x%.2f%s\n", "Copy", legacyCopyNs, copyNs, legacyCopyNs / copyNs, matches ? "" : "  MISMATCH");
+	return matches;
+}
@@ -0,0 +1,18 @@
+#include <iostream>
+
+#include "Benchmark.h"
+
+int main(void)
+{
+	bool passed = true;
+	passed = RunMtx44Benchmark() && passed;
+	passed = RunBatchMathBenchmark() && passed;
+	passed = RunVertexBenchmark() && passed;
+
+	if (!passed)
+	{
+		std::cout << "Benchmark results did not match the reference code\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,92 @@
+/******************************************************************************/
+/*!
+\file	Animation.cpp
+\brief
+Keyframed animation clips sampled into skeleton poses, and pose blending
+*/
+/******************************************************************************/
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "Animation.h"
+
+AnimationClip::AnimationClip() : m_duration(0), m_loop(false)
+{
+}
+
+AnimationClip::AnimationClip( float duration, bool loop ) : m_duration(duration), m_loop(loop)
+{
+}
+
+AnimationClip::~AnimationClip()
+{
+}
+
+void AnimationClip::AddKey( unsigned joint, float time, const Transform& local )
+{
+	unsigned i = 0;
+	while (i < m_tracks.size() && m_tracks[i].joint != joint)
+	{
+		++i;
+	}
+	if (i == m_tracks.size())
+	{
+		m_tracks.push_back(Track());
+		m_tracks.back().joint = joint;
+	}
+
+	Track &track = m_tracks[i];
+	assert(track.times.empty() || time >= track.times.back());
+	track.times.push_back(time);
+	track.keys.push_back(local);
+}
+
+float AnimationClip::GetDuration( void ) const
+{
+	return m_duration;
+}
+
+bool AnimationClip::IsLooping( void ) const
+{
+	return m_loop;
+}
+
+void AnimationClip::Sample( float time, Pose &pose ) const
+{
+	if (m_loop && m_duration > 0)
+	{
+		time = fmod(time, m_duration);
+		if (time < 0)
+			time += m_duration;
+	}
+
+	for (unsigned i = 0; i < m_tracks.size(); ++i)
+	{
+		const Track &track = m_tracks[i];
+		assert(track.joint < pose.size());
+
+		//First key after time; the pair either side of it is interpolated
+		unsigned next = std::upper_bound(track.times.begin(), track.times.end(), time) - track.times.begin();
+		if (next == 0)
+		{
+			pose[track.joint] = track.keys.front();
+		}
+		else if (next == track.times.size())
+		{
+			pose[track.joint] = track.keys.back();
+		}
+		else
+		{
+			float t0 = track.times[next - 1], t1 = track.times[next];
+			pose[track.joint] = Transform::Lerp(track.keys[next - 1], track.keys[next], (time - t0) / (t1 - t0));
+		}
+	}
+}
+
+void BlendPoses( const Pose& from, const Pose& to, float weight, Pose &out )
+{
+	assert(from.size() == to.size());
+	out.resize(from.size());
+	if (!from.empty())
+		Transform::Lerp(&from[0], &to[0], weight, &out[0], from.size());
+}
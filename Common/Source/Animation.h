@@ -0,0 +1,58 @@
+/******************************************************************************/
+/*!
+\file	Animation.h
+\brief
+Keyframed animation clips sampled into skeleton poses, and pose blending
+*/
+/******************************************************************************/
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <vector>
+#include "Skeleton.h"
+
+/******************************************************************************/
+/*!
+		Class AnimationClip:
+\brief	One track of keyframes per animated joint, each key a joint's whole
+		local transform at a time. Sampling finds the keys either side of
+		the time by binary search and interpolates them with
+		Transform::Lerp; joints without a track are left as they are in
+		the pose, so a clip can animate part of a skeleton over another
+		pose.
+*/
+/******************************************************************************/
+class AnimationClip
+{
+public:
+	AnimationClip();
+	AnimationClip( float duration, bool loop );
+	~AnimationClip();
+
+	//Keys of a joint must be added in time order
+	void AddKey( unsigned joint, float time, const Transform& local );
+
+	float GetDuration( void ) const;
+	bool IsLooping( void ) const;
+
+	//Set the animated joints of pose at time; looping clips wrap it, the
+	//others hold their first and last keys
+	void Sample( float time, Pose &pose ) const;
+
+private:
+	struct Track
+	{
+		unsigned joint;
+		std::vector<float> times;
+		std::vector<Transform> keys;
+	};
+
+	std::vector<Track> m_tracks;
+	float m_duration;
+	bool m_loop;
+};
+
+//Lerp every joint of from towards to by weight, 0 giving from and 1 to
+void BlendPoses( const Pose& from, const Pose& to, float weight, Pose &out );
+
+#endif //ANIMATION_H
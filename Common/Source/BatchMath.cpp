@@ -0,0 +1,194 @@
+/******************************************************************************/
+/*!
+\file	BatchMath.cpp
+\brief
+Vector math over structure of arrays float streams
+*/
+/******************************************************************************/
+#include <cmath>
+#include <cstring>
+#include "BatchMath.h"
+#include "SimdFloat4.h"
+
+//Each kernel runs the Float4 code over groups of four vectors, one component
+//per register, and finishes the last count % 4 with the scalar code
+#if defined(MTX44_SSE)
+//1 / sqrt(v) where v > 0, else 0
+static inline Float4 InvLength4(Float4 lengthSquared)
+{
+	Float4 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+	return _mm_and_ps(inv, _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps()));
+}
+#elif defined(MTX44_NEON)
+static inline Float4 InvLength4(Float4 lengthSquared)
+{
+	//Estimate refined by two Newton-Raphson steps, close to full precision
+	Float4 inv = vrsqrteq_f32(lengthSquared);
+	inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lengthSquared, inv), inv));
+	inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lengthSquared, inv), inv));
+	uint32x4_t nonZero = vcgtq_f32(lengthSquared, vdupq_n_f32(0));
+	return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(inv), nonZero));
+}
+#endif
+
+static inline float InvLength(float lengthSquared)
+{
+	return lengthSquared > 0 ? 1.0f / sqrt(lengthSquared) : 0;
+}
+
+void BatchMath::Gather(const void *src, size_t stride, unsigned count, const Stream3 &out)
+{
+	const unsigned char *bytes = (const unsigned char*)src;
+	for (unsigned i = 0; i < count; ++i, bytes += stride)
+	{
+		float v[3];
+		memcpy(v, bytes, sizeof(v));
+		out.x[i] = v[0];
+		out.y[i] = v[1];
+		out.z[i] = v[2];
+	}
+}
+
+void BatchMath::Scatter(const Stream3 &in, unsigned count, void *dst, size_t stride)
+{
+	unsigned char *bytes = (unsigned char*)dst;
+	for (unsigned i = 0; i < count; ++i, bytes += stride)
+	{
+		float v[3] = { in.x[i], in.y[i], in.z[i] };
+		memcpy(bytes, v, sizeof(v));
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Transform a stream by the upper 3x4 of a matrix, w is 1 for points and 0 for
+directions, which drops the translation
+*/
+/******************************************************************************/
+static void TransformStream(const Mtx44 &m, float w, const BatchMath::Stream3 &in, const BatchMath::Stream3 &out, unsigned count)
+{
+	const float *a = m.a;
+	float tx = a[12] * w, ty = a[13] * w, tz = a[14] * w;
+	unsigned i = 0;
+#if defined(SIMD_FLOAT4_NATIVE)
+	Float4 m0 = Splat4(a[0]), m1 = Splat4(a[1]), m2 = Splat4(a[2]);
+	Float4 m4 = Splat4(a[4]), m5 = Splat4(a[5]), m6 = Splat4(a[6]);
+	Float4 m8 = Splat4(a[8]), m9 = Splat4(a[9]), m10 = Splat4(a[10]);
+	Float4 t0 = Splat4(tx), t1 = Splat4(ty), t2 = Splat4(tz);
+	for (; i + 4 <= count; i += 4)
+	{
+		Float4 x = Load4(in.x + i), y = Load4(in.y + i), z = Load4(in.z + i);
+		Store4(out.x + i, Add4(Add4(Mul4(m0, x), Mul4(m4, y)), Add4(Mul4(m8, z), t0)));
+		Store4(out.y + i, Add4(Add4(Mul4(m1, x), Mul4(m5, y)), Add4(Mul4(m9, z), t1)));
+		Store4(out.z + i, Add4(Add4(Mul4(m2, x), Mul4(m6, y)), Add4(Mul4(m10, z), t2)));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		float x = in.x[i], y = in.y[i], z = in.z[i];
+		out.x[i] = a[0] * x + a[4] * y + a[8] * z + tx;
+		out.y[i] = a[1] * x + a[5] * y + a[9] * z + ty;
+		out.z[i] = a[2] * x + a[6] * y + a[10] * z + tz;
+	}
+}
+
+void BatchMath::TransformPoints(const Mtx44 &m, const Stream3 &in, const Stream3 &out, unsigned count)
+{
+	TransformStream(m, 1, in, out, count);
+}
+
+void BatchMath::TransformNormals(const Mtx44 &m, const Stream3 &in, const Stream3 &out, unsigned count)
+{
+	TransformStream(m, 0, in, out, count);
+}
+
+void BatchMath::Normalize(const Stream3 &in, const Stream3 &out, unsigned count)
+{
+	unsigned i = 0;
+#if defined(SIMD_FLOAT4_NATIVE)
+	for (; i + 4 <= count; i += 4)
+	{
+		Float4 x = Load4(in.x + i), y = Load4(in.y + i), z = Load4(in.z + i);
+		Float4 inv = InvLength4(Add4(Add4(Mul4(x, x), Mul4(y, y)), Mul4(z, z)));
+		Store4(out.x + i, Mul4(x, inv));
+		Store4(out.y + i, Mul4(y, inv));
+		Store4(out.z + i, Mul4(z, inv));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		float x = in.x[i], y = in.y[i], z = in.z[i];
+		float inv = InvLength(x * x + y * y + z * z);
+		out.x[i] = x * inv;
+		out.y[i] = y * inv;
+		out.z[i] = z * inv;
+	}
+}
+
+void BatchMath::Dot(const Stream3 &a, const Stream3 &b, float *out, unsigned count)
+{
+	unsigned i = 0;
+#if defined(SIMD_FLOAT4_NATIVE)
+	for (; i + 4 <= count; i += 4)
+	{
+		Float4 dot = Add4(Add4(Mul4(Load4(a.x + i), Load4(b.x + i)), Mul4(Load4(a.y + i), Load4(b.y + i))), Mul4(Load4(a.z + i), Load4(b.z + i)));
+		Store4(out + i, dot);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+	}
+}
+
+bool BatchMath::ComputeAABB(const Stream3 &in, unsigned count, Vector3 &min, Vector3 &max)
+{
+	if (count == 0)
+	{
+		return false;
+	}
+
+	float lo[3] = { in.x[0], in.y[0], in.z[0] };
+	float hi[3] = { in.x[0], in.y[0], in.z[0] };
+	unsigned i = 0;
+#if defined(SIMD_FLOAT4_NATIVE)
+	if (count >= 4)
+	{
+		Float4 loX = Load4(in.x), loY = Load4(in.y), loZ = Load4(in.z);
+		Float4 hiX = loX, hiY = loY, hiZ = loZ;
+		for (i = 4; i + 4 <= count; i += 4)
+		{
+			Float4 x = Load4(in.x + i), y = Load4(in.y + i), z = Load4(in.z + i);
+			loX = Min4(loX, x); hiX = Max4(hiX, x);
+			loY = Min4(loY, y); hiY = Max4(hiY, y);
+			loZ = Min4(loZ, z); hiZ = Max4(hiZ, z);
+		}
+
+		float lanes[6][4];
+		Store4(lanes[0], loX); Store4(lanes[1], loY); Store4(lanes[2], loZ);
+		Store4(lanes[3], hiX); Store4(lanes[4], hiY); Store4(lanes[5], hiZ);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				lo[axis] = lanes[axis][lane] < lo[axis] ? lanes[axis][lane] : lo[axis];
+				hi[axis] = lanes[axis + 3][lane] > hi[axis] ? lanes[axis + 3][lane] : hi[axis];
+			}
+		}
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		float v[3] = { in.x[i], in.y[i], in.z[i] };
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			lo[axis] = v[axis] < lo[axis] ? v[axis] : lo[axis];
+			hi[axis] = v[axis] > hi[axis] ? v[axis] : hi[axis];
+		}
+	}
+
+	min.Set(lo[0], lo[1], lo[2]);
+	max.Set(hi[0], hi[1], hi[2]);
+	return true;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file	BatchMath.h
+\brief
+Vector math over structure of arrays float streams: x, y and z each in their
+own array, so one SIMD register holds the same component of four vectors.
+Uses the instruction set picked in Mtx44Kernels.h. Nothing here throws; zero
+vectors normalize to zero and empty streams have no AABB.
+*/
+/******************************************************************************/
+#ifndef BATCH_MATH_H
+#define BATCH_MATH_H
+
+#include <cstddef>
+#include "Mtx44.h"
+#include "Vector3.h"
+
+namespace BatchMath
+{
+	//Component arrays of a stream of 3D vectors
+	struct Stream3
+	{
+		float *x;
+		float *y;
+		float *z;
+	};
+
+	//Copy count vectors of 3 floats, stride bytes apart, into / out of a stream;
+	//e.g. Gather(&vertices[0].pos, sizeof(Vertex), ...)
+	void Gather(const void *src, size_t stride, unsigned count, const Stream3 &out);
+	void Scatter(const Stream3 &in, unsigned count, void *dst, size_t stride);
+
+	//out = m * (in, 1), no perspective divide; out may alias in
+	void TransformPoints(const Mtx44 &m, const Stream3 &in, const Stream3 &out, unsigned count);
+	//out = m * (in, 0); pass a normal matrix for normals; out may alias in
+	void TransformNormals(const Mtx44 &m, const Stream3 &in, const Stream3 &out, unsigned count);
+
+	//Zero length vectors come out as zero; out may alias in
+	void Normalize(const Stream3 &in, const Stream3 &out, unsigned count);
+	void Dot(const Stream3 &a, const Stream3 &b, float *out, unsigned count);
+
+	//Returns false, leaving min and max untouched, if count is 0
+	bool ComputeAABB(const Stream3 &in, unsigned count, Vector3 &min, Vector3 &max);
+}
+
+#endif //BATCH_MATH_H
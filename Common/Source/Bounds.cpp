@@ -0,0 +1,199 @@
+/******************************************************************************/
+/*!
+\file	Bounds.cpp
+\brief
+Bounding volumes and rays for spatial queries: axis aligned boxes, rays,
+capsules and view frustums
+*/
+/******************************************************************************/
+#include <cfloat>
+#include "Bounds.h"
+
+AABB::AABB() : min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX)
+{
+}
+
+AABB::AABB(const Vector3 &min, const Vector3 &max) : min(min), max(max)
+{
+}
+
+bool AABB::IsEmpty( void ) const
+{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+Vector3 AABB::Center( void ) const
+{
+	return Vector3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+}
+
+float AABB::SurfaceArea( void ) const
+{
+	if (IsEmpty())
+		return 0;
+	float x = max.x - min.x, y = max.y - min.y, z = max.z - min.z;
+	return 2 * (x * y + y * z + z * x);
+}
+
+void AABB::Expand( const Vector3& point )
+{
+	min.Set(Math::Min(min.x, point.x), Math::Min(min.y, point.y), Math::Min(min.z, point.z));
+	max.Set(Math::Max(max.x, point.x), Math::Max(max.y, point.y), Math::Max(max.z, point.z));
+}
+
+void AABB::Expand( const AABB& box )
+{
+	min.Set(Math::Min(min.x, box.min.x), Math::Min(min.y, box.min.y), Math::Min(min.z, box.min.z));
+	max.Set(Math::Max(max.x, box.max.x), Math::Max(max.y, box.max.y), Math::Max(max.z, box.max.z));
+}
+
+AABB AABB::Union( const AABB& a, const AABB& b )
+{
+	AABB box = a;
+	box.Expand(b);
+	return box;
+}
+
+bool AABB::Contains( const AABB& box ) const
+{
+	return min.x <= box.min.x && min.y <= box.min.y && min.z <= box.min.z &&
+		max.x >= box.max.x && max.y >= box.max.y && max.z >= box.max.z;
+}
+
+bool AABB::Overlaps( const AABB& box ) const
+{
+	return min.x <= box.max.x && max.x >= box.min.x &&
+		min.y <= box.max.y && max.y >= box.min.y &&
+		min.z <= box.max.z && max.z >= box.min.z;
+}
+
+bool AABB::OverlapsSphere( const Vector3& center, float radius ) const
+{
+	//Distance from the center to the nearest point of the box
+	float dx = Math::Max(Math::Max(min.x - center.x, center.x - max.x), 0.f);
+	float dy = Math::Max(Math::Max(min.y - center.y, center.y - max.y), 0.f);
+	float dz = Math::Max(Math::Max(min.z - center.z, center.z - max.z), 0.f);
+	return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Box around the transformed box, from the transformed center and the extents
+summed through the absolute matrix, so no corners are transformed
+
+\param m - affine transform, column major
+
+\return Transformed box, empty if this box is empty
+*/
+/******************************************************************************/
+AABB AABB::Transformed( const Mtx44& m ) const
+{
+	if (IsEmpty())
+		return AABB();
+
+	const float *a = m.a;
+	Vector3 c = Center();
+	Vector3 e((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+	Vector3 center(a[0] * c.x + a[4] * c.y + a[8] * c.z + a[12],
+		a[1] * c.x + a[5] * c.y + a[9] * c.z + a[13],
+		a[2] * c.x + a[6] * c.y + a[10] * c.z + a[14]);
+	Vector3 extent(fabs(a[0]) * e.x + fabs(a[4]) * e.y + fabs(a[8]) * e.z,
+		fabs(a[1]) * e.x + fabs(a[5]) * e.y + fabs(a[9]) * e.z,
+		fabs(a[2]) * e.x + fabs(a[6]) * e.y + fabs(a[10]) * e.z);
+	return AABB(center - extent, center + extent);
+}
+
+Ray::Ray() : origin(0, 0, 0), direction(0, 0, -1), maxDistance(FLT_MAX)
+{
+}
+
+Ray::Ray(const Vector3 &origin, const Vector3 &direction, float maxDistance)
+	: origin(origin), direction(direction), maxDistance(maxDistance)
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Slab test. Zero direction components divide to infinity, which the min and
+max handle, except for an origin exactly on a slab plane.
+
+\param box - box to test
+\param distance - set to the entry distance, 0 if the origin is inside
+
+\return true if the ray enters the box within maxDistance
+*/
+/******************************************************************************/
+bool Ray::Intersects( const AABB& box, float &distance ) const
+{
+	float tMin = 0, tMax = maxDistance;
+	const float *o = &origin.x, *d = &direction.x, *lo = &box.min.x, *hi = &box.max.x;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float inv = 1.0f / d[axis];
+		float t0 = (lo[axis] - o[axis]) * inv;
+		float t1 = (hi[axis] - o[axis]) * inv;
+		tMin = Math::Max(tMin, Math::Min(t0, t1));
+		tMax = Math::Min(tMax, Math::Max(t0, t1));
+	}
+	if (tMin > tMax)
+		return false;
+	distance = tMin;
+	return true;
+}
+
+Capsule::Capsule() : a(0, 0, 0), b(0, 0, 0), radius(0)
+{
+}
+
+Capsule::Capsule(const Vector3 &a, const Vector3 &b, float radius) : a(a), b(b), radius(radius)
+{
+}
+
+AABB Capsule::Bounds( void ) const
+{
+	Vector3 r(radius, radius, radius);
+	AABB box(a - r, a + r);
+	box.Expand(AABB(b - r, b + r));
+	return box;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Gribb and Hartmann plane extraction: each plane is the last row of the
+matrix plus or minus one of the other rows
+
+\param viewProjection - projection * view, column major
+*/
+/******************************************************************************/
+Frustum::Frustum(const Mtx44 &viewProjection)
+{
+	const float *a = viewProjection.a;
+	for (int i = 0; i < 4; ++i)
+	{
+		float row0 = a[i * 4], row1 = a[i * 4 + 1], row2 = a[i * 4 + 2], row3 = a[i * 4 + 3];
+		planes[PLANE_LEFT][i] = row3 + row0;
+		planes[PLANE_RIGHT][i] = row3 - row0;
+		planes[PLANE_BOTTOM][i] = row3 + row1;
+		planes[PLANE_TOP][i] = row3 - row1;
+		planes[PLANE_NEAR][i] = row3 + row2;
+		planes[PLANE_FAR][i] = row3 - row2;
+	}
+}
+
+bool Frustum::Intersects( const AABB& box ) const
+{
+	for (int i = 0; i < NUM_PLANES; ++i)
+	{
+		//The corner furthest along the plane normal
+		const float *p = planes[i];
+		float x = p[0] >= 0 ? box.max.x : box.min.x;
+		float y = p[1] >= 0 ? box.max.y : box.min.y;
+		float z = p[2] >= 0 ? box.max.z : box.min.z;
+		if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************/
+/*!
+\file	Bounds.h
+\brief
+Bounding volumes and rays for spatial queries: axis aligned boxes, rays,
+capsules and view frustums
+*/
+/******************************************************************************/
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include "Vector3.h"
+#include "Mtx44.h"
+
+/******************************************************************************/
+/*!
+		Struct AABB:
+\brief	Axis aligned bounding box. The default box is empty: min above max,
+		so expanding it by anything gives that thing's box.
+*/
+/******************************************************************************/
+struct AABB
+{
+	Vector3 min, max;
+
+	AABB();
+	AABB(const Vector3 &min, const Vector3 &max);
+
+	bool IsEmpty( void ) const;
+	Vector3 Center( void ) const;
+	float SurfaceArea( void ) const; //0 for an empty box
+
+	void Expand( const Vector3& point );
+	void Expand( const AABB& box );
+	static AABB Union( const AABB& a, const AABB& b );
+
+	bool Contains( const AABB& box ) const;
+	bool Overlaps( const AABB& box ) const;
+	bool OverlapsSphere( const Vector3& center, float radius ) const;
+
+	//Box of this box's corners transformed by m
+	AABB Transformed( const Mtx44& m ) const;
+};
+
+/******************************************************************************/
+/*!
+		Struct Ray:
+\brief	Half line from origin along direction, up to maxDistance in units
+		of direction's length
+*/
+/******************************************************************************/
+struct Ray
+{
+	Vector3 origin;
+	Vector3 direction;
+	float maxDistance;
+
+	Ray();
+	Ray(const Vector3 &origin, const Vector3 &direction, float maxDistance);
+
+	//Distance along the ray to where it enters box, false if it misses
+	bool Intersects( const AABB& box, float &distance ) const;
+};
+
+/******************************************************************************/
+/*!
+		Struct Capsule:
+\brief	Every point within radius of the segment from a to b; a sphere when
+		a and b are the same point
+*/
+/******************************************************************************/
+struct Capsule
+{
+	Vector3 a, b;
+	float radius;
+
+	Capsule();
+	Capsule(const Vector3 &a, const Vector3 &b, float radius);
+
+	AABB Bounds( void ) const;
+};
+
+/******************************************************************************/
+/*!
+		Struct Frustum:
+\brief	Six planes (a, b, c, d), a point p inside when a*p.x + b*p.y +
+		c*p.z + d >= 0 for all of them. The planes are not normalized.
+*/
+/******************************************************************************/
+struct Frustum
+{
+	enum PLANE
+	{
+		PLANE_LEFT,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		NUM_PLANES,
+	};
+
+	float planes[NUM_PLANES][4];
+
+	//Planes of the clip volume of projection * view, in world space
+	explicit Frustum(const Mtx44 &viewProjection);
+
+	//Conservative: a box crossing two planes outside a corner may pass
+	bool Intersects( const AABB& box ) const;
+};
+
+#endif //BOUNDS_H
@@ -0,0 +1,523 @@
+/******************************************************************************/
+/*!
+\file	Bvh.cpp
+\brief
+Dynamic bounding volume hierarchy over object boxes, for culling, overlap
+and ray queries that visit O(log n) nodes instead of every object
+*/
+/******************************************************************************/
+#include <cassert>
+#include <cfloat>
+#include <algorithm>
+#include "Bvh.h"
+#include "SimdFloat4.h"
+#include "SahBinning.h"
+
+const Bvh::ProxyID Bvh::NO_PROXY;
+const unsigned Bvh::NO_NODE;
+
+Bvh::Bvh() : m_root(NO_NODE), m_freeList(NO_NODE), m_proxyCount(0)
+{
+}
+
+Bvh::~Bvh()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Add a proxy next to the node that makes the tree cheapest by the surface
+area heuristic
+
+\param bounds - world box of the object
+\param userData - value the queries return for this proxy
+
+\return ID of the proxy, valid until it is removed
+*/
+/******************************************************************************/
+Bvh::ProxyID Bvh::Insert( const AABB& bounds, unsigned userData )
+{
+	unsigned leaf = AllocateNode();
+	m_nodes[leaf].bounds = bounds;
+	m_nodes[leaf].userData = userData;
+	m_nodes[leaf].height = 0;
+	InsertLeaf(leaf);
+	++m_proxyCount;
+	return leaf;
+}
+
+void Bvh::Remove( ProxyID proxy )
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].height == 0);
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--m_proxyCount;
+}
+
+void Bvh::Move( ProxyID proxy, const AABB& bounds )
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].height == 0);
+	m_nodes[proxy].bounds = bounds;
+	if (m_nodes[proxy].parent != NO_NODE)
+	{
+		RefitFrom(m_nodes[proxy].parent);
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Throw away every internal node and split the proxies again from the top
+with the binned surface area heuristic
+*/
+/******************************************************************************/
+void Bvh::Build( void )
+{
+	std::vector<unsigned> leaves;
+	leaves.reserve(m_proxyCount);
+	for (unsigned i = 0; i < m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].height == 0)
+			leaves.push_back(i);
+		else if (m_nodes[i].height > 0)
+			FreeNode(i);
+	}
+
+	m_root = leaves.empty() ? NO_NODE : BuildRange(&leaves[0], leaves.size());
+	if (m_root != NO_NODE)
+	{
+		m_nodes[m_root].parent = NO_NODE;
+	}
+}
+
+void Bvh::Clear( void )
+{
+	m_nodes.clear();
+	m_root = NO_NODE;
+	m_freeList = NO_NODE;
+	m_proxyCount = 0;
+}
+
+unsigned Bvh::GetUserData( ProxyID proxy ) const
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].height == 0);
+	return m_nodes[proxy].userData;
+}
+
+const AABB& Bvh::GetBounds( ProxyID proxy ) const
+{
+	assert(proxy < m_nodes.size() && m_nodes[proxy].height == 0);
+	return m_nodes[proxy].bounds;
+}
+
+unsigned Bvh::GetProxyCount( void ) const
+{
+	return m_proxyCount;
+}
+
+unsigned Bvh::GetHeight( void ) const
+{
+	return m_root == NO_NODE ? 0 : m_nodes[m_root].height;
+}
+
+//Expected node visits of a random query: every node's area over the root's
+float Bvh::GetCost( void ) const
+{
+	if (m_root == NO_NODE)
+		return 0;
+	float total = 0;
+	for (unsigned i = 0; i < m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].height >= 0)
+			total += m_nodes[i].bounds.SurfaceArea();
+	}
+	float rootArea = m_nodes[m_root].bounds.SurfaceArea();
+	return rootArea > 0 ? total / rootArea : 0;
+}
+
+unsigned Bvh::AllocateNode( void )
+{
+	unsigned node;
+	if (m_freeList != NO_NODE)
+	{
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else
+	{
+		node = m_nodes.size();
+		m_nodes.push_back(Node());
+	}
+	m_nodes[node].parent = NO_NODE;
+	m_nodes[node].child[0] = m_nodes[node].child[1] = NO_NODE;
+	m_nodes[node].height = 0;
+	return node;
+}
+
+void Bvh::FreeNode( unsigned node )
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Walk down from the root while one child is cheaper to pair the leaf with
+than the current node, then give the leaf and that node a new parent. The
+cost of a pairing is the area of the new parent plus the area every
+ancestor gains.
+
+\param leaf - leaf node with its bounds set
+*/
+/******************************************************************************/
+void Bvh::InsertLeaf( unsigned leaf )
+{
+	if (m_root == NO_NODE)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NO_NODE;
+		return;
+	}
+
+	const AABB bounds = m_nodes[leaf].bounds;
+	unsigned sibling = m_root;
+	while (!m_nodes[sibling].IsLeaf())
+	{
+		const Node &node = m_nodes[sibling];
+		float area = node.bounds.SurfaceArea();
+		float combinedArea = AABB::Union(node.bounds, bounds).SurfaceArea();
+
+		//Pairing here makes a parent of the combined area
+		float cost = 2 * combinedArea;
+		//Going further down grows this node by the leaf
+		float inheritance = 2 * (combinedArea - area);
+
+		float childCost[2];
+		for (int i = 0; i < 2; ++i)
+		{
+			const Node &child = m_nodes[node.child[i]];
+			float grown = AABB::Union(child.bounds, bounds).SurfaceArea();
+			childCost[i] = (child.IsLeaf() ? grown : grown - child.bounds.SurfaceArea()) + inheritance;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+		sibling = childCost[0] < childCost[1] ? node.child[0] : node.child[1];
+	}
+
+	unsigned oldParent = m_nodes[sibling].parent;
+	unsigned newParent = AllocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].child[0] = sibling;
+	m_nodes[newParent].child[1] = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == NO_NODE)
+	{
+		m_root = newParent;
+	}
+	else
+	{
+		Node &parent = m_nodes[oldParent];
+		parent.child[parent.child[0] == sibling ? 0 : 1] = newParent;
+	}
+	RefitFrom(newParent);
+}
+
+//The leaf's sibling takes the place of their parent
+void Bvh::RemoveLeaf( unsigned leaf )
+{
+	if (leaf == m_root)
+	{
+		m_root = NO_NODE;
+		return;
+	}
+
+	unsigned parent = m_nodes[leaf].parent;
+	unsigned grandParent = m_nodes[parent].parent;
+	unsigned sibling = m_nodes[parent].child[m_nodes[parent].child[0] == leaf ? 1 : 0];
+
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent == NO_NODE)
+	{
+		m_root = sibling;
+	}
+	else
+	{
+		Node &node = m_nodes[grandParent];
+		node.child[node.child[0] == parent ? 0 : 1] = sibling;
+		RefitFrom(grandParent);
+	}
+	FreeNode(parent);
+}
+
+//Stops early once a node comes out unchanged, as its ancestors then are too
+void Bvh::RefitFrom( unsigned node )
+{
+	while (node != NO_NODE)
+	{
+		Node &n = m_nodes[node];
+		const Node &left = m_nodes[n.child[0]], &right = m_nodes[n.child[1]];
+		AABB bounds = AABB::Union(left.bounds, right.bounds);
+		int height = 1 + std::max(left.height, right.height);
+
+		if (height == n.height &&
+			bounds.min.x == n.bounds.min.x && bounds.min.y == n.bounds.min.y && bounds.min.z == n.bounds.min.z &&
+			bounds.max.x == n.bounds.max.x && bounds.max.y == n.bounds.max.y && bounds.max.z == n.bounds.max.z)
+			break;
+
+		n.bounds = bounds;
+		n.height = height;
+		node = n.parent;
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Build the subtree over count leaves: bin the leaf centers along each axis,
+take the split with the lowest area times count on both sides, and recurse.
+Leaves with coincident centers are split in half instead.
+
+\param leaves - leaf nodes, reordered in place
+\param count - at least 1
+
+\return Root of the subtree
+*/
+/******************************************************************************/
+unsigned Bvh::BuildRange( unsigned *leaves, unsigned count )
+{
+	if (count == 1)
+		return leaves[0];
+
+	AABB centers;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		centers.Expand(m_nodes[leaves[i]].bounds.Center());
+	}
+
+	const std::vector<Node> &nodes = m_nodes;
+	SahSplit split = FindSahSplit(centers, count, [&](unsigned i) -> const AABB& { return nodes[leaves[i]].bounds; });
+
+	unsigned middle;
+	if (split.axis < 0)
+	{
+		middle = count / 2;
+	}
+	else
+	{
+		middle = std::partition(leaves, leaves + count, [&](unsigned leaf) {
+			return split.IsLeft(nodes[leaf].bounds);
+		}) - leaves;
+	}
+
+	unsigned left = BuildRange(leaves, middle);
+	unsigned right = BuildRange(leaves + middle, count - middle);
+	unsigned node = AllocateNode();
+	Node &n = m_nodes[node];
+	n.child[0] = left;
+	n.child[1] = right;
+	n.bounds = AABB::Union(m_nodes[left].bounds, m_nodes[right].bounds);
+	n.height = 1 + std::max(m_nodes[left].height, m_nodes[right].height);
+	m_nodes[left].parent = node;
+	m_nodes[right].parent = node;
+	return node;
+}
+
+template<typename Test, typename Visit>
+void Bvh::Traverse( const Test& test, const Visit& visit ) const
+{
+	if (m_root == NO_NODE)
+		return;
+
+	std::vector<unsigned> stack;
+	stack.reserve(64);
+	stack.push_back(m_root);
+	while (!stack.empty())
+	{
+		const Node &node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (!test(node.bounds))
+			continue;
+		if (node.IsLeaf())
+		{
+			visit(node);
+		}
+		else
+		{
+			stack.push_back(node.child[1]);
+			stack.push_back(node.child[0]);
+		}
+	}
+}
+
+template<typename Test>
+void Bvh::TraversePacket( const Test& test, std::vector<unsigned> out[4] ) const
+{
+	if (m_root == NO_NODE)
+		return;
+
+	//Each entry is a node and the lanes that reached it
+	std::vector<std::pair<unsigned, int> > stack;
+	stack.reserve(64);
+	stack.push_back(std::make_pair(m_root, 0xF));
+	while (!stack.empty())
+	{
+		const Node &node = m_nodes[stack.back().first];
+		int lanes = stack.back().second & test(node.bounds);
+		stack.pop_back();
+		if (lanes == 0)
+			continue;
+		if (node.IsLeaf())
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				if (lanes & (1 << lane))
+					out[lane].push_back(node.userData);
+			}
+		}
+		else
+		{
+			stack.push_back(std::make_pair(node.child[1], lanes));
+			stack.push_back(std::make_pair(node.child[0], lanes));
+		}
+	}
+}
+
+void Bvh::Query( const AABB& box, std::vector<unsigned> &out ) const
+{
+	Traverse([&box](const AABB &bounds) { return bounds.Overlaps(box); },
+		[&out](const Node &leaf) { out.push_back(leaf.userData); });
+}
+
+void Bvh::Query( const Vector3& center, float radius, std::vector<unsigned> &out ) const
+{
+	Traverse([&center, radius](const AABB &bounds) { return bounds.OverlapsSphere(center, radius); },
+		[&out](const Node &leaf) { out.push_back(leaf.userData); });
+}
+
+void Bvh::Query( const Frustum& frustum, std::vector<unsigned> &out ) const
+{
+	Traverse([&frustum](const AABB &bounds) { return frustum.Intersects(bounds); },
+		[&out](const Node &leaf) { out.push_back(leaf.userData); });
+}
+
+void Bvh::Query( const Ray& ray, std::vector<unsigned> &out ) const
+{
+	Traverse([&ray](const AABB &bounds) { float distance; return ray.Intersects(bounds, distance); },
+		[&out](const Node &leaf) { out.push_back(leaf.userData); });
+}
+
+//Shortens the ray to each hit, so boxes further than the nearest hit are skipped
+bool Bvh::Raycast( const Ray& ray, unsigned &userData, float &distance ) const
+{
+	Ray shortened = ray;
+	bool hit = false;
+	Traverse([&shortened](const AABB &bounds) { float entry; return shortened.Intersects(bounds, entry); },
+		[&](const Node &leaf) {
+			float entry;
+			shortened.Intersects(leaf.bounds, entry);
+			shortened.maxDistance = entry;
+			userData = leaf.userData;
+			distance = entry;
+			hit = true;
+		});
+	return hit;
+}
+
+void Bvh::QueryPacket( const AABB box[4], std::vector<unsigned> out[4] ) const
+{
+	float minX[4], minY[4], minZ[4], maxX[4], maxY[4], maxZ[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		minX[i] = box[i].min.x; minY[i] = box[i].min.y; minZ[i] = box[i].min.z;
+		maxX[i] = box[i].max.x; maxY[i] = box[i].max.y; maxZ[i] = box[i].max.z;
+	}
+	Float4 qMinX = Load4(minX), qMinY = Load4(minY), qMinZ = Load4(minZ);
+	Float4 qMaxX = Load4(maxX), qMaxY = Load4(maxY), qMaxZ = Load4(maxZ);
+
+	TraversePacket([&](const AABB &bounds) {
+		Float4 x = And4(LessEqual4(qMinX, Splat4(bounds.max.x)), LessEqual4(Splat4(bounds.min.x), qMaxX));
+		Float4 y = And4(LessEqual4(qMinY, Splat4(bounds.max.y)), LessEqual4(Splat4(bounds.min.y), qMaxY));
+		Float4 z = And4(LessEqual4(qMinZ, Splat4(bounds.max.z)), LessEqual4(Splat4(bounds.min.z), qMaxZ));
+		return MoveMask4(And4(And4(x, y), z));
+	}, out);
+}
+
+void Bvh::QueryPacket( const Vector3 center[4], const float radius[4], std::vector<unsigned> out[4] ) const
+{
+	float cx[4], cy[4], cz[4], r2[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		cx[i] = center[i].x; cy[i] = center[i].y; cz[i] = center[i].z;
+		r2[i] = radius[i] * radius[i];
+	}
+	Float4 centerX = Load4(cx), centerY = Load4(cy), centerZ = Load4(cz), radius2 = Load4(r2);
+	Float4 zero = Splat4(0);
+
+	TraversePacket([&](const AABB &bounds) {
+		Float4 dx = Max4(Max4(Sub4(Splat4(bounds.min.x), centerX), Sub4(centerX, Splat4(bounds.max.x))), zero);
+		Float4 dy = Max4(Max4(Sub4(Splat4(bounds.min.y), centerY), Sub4(centerY, Splat4(bounds.max.y))), zero);
+		Float4 dz = Max4(Max4(Sub4(Splat4(bounds.min.z), centerZ), Sub4(centerZ, Splat4(bounds.max.z))), zero);
+		Float4 distance2 = Add4(Add4(Mul4(dx, dx), Mul4(dy, dy)), Mul4(dz, dz));
+		return MoveMask4(LessEqual4(distance2, radius2));
+	}, out);
+}
+
+void Bvh::QueryPacket( const Frustum frustum[4], std::vector<unsigned> out[4] ) const
+{
+	//Coefficient k of plane p of each frustum
+	Float4 planes[Frustum::NUM_PLANES][4];
+	for (int p = 0; p < Frustum::NUM_PLANES; ++p)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			float lanes[4] = { frustum[0].planes[p][k], frustum[1].planes[p][k], frustum[2].planes[p][k], frustum[3].planes[p][k] };
+			planes[p][k] = Load4(lanes);
+		}
+	}
+	Float4 zero = Splat4(0);
+
+	TraversePacket([&](const AABB &bounds) {
+		Float4 minX = Splat4(bounds.min.x), minY = Splat4(bounds.min.y), minZ = Splat4(bounds.min.z);
+		Float4 maxX = Splat4(bounds.max.x), maxY = Splat4(bounds.max.y), maxZ = Splat4(bounds.max.z);
+		int lanes = 0xF;
+		for (int p = 0; p < Frustum::NUM_PLANES && lanes; ++p)
+		{
+			//Distance of the corner furthest along the normal, per lane
+			const Float4 *plane = planes[p];
+			Float4 distance = Add4(
+				Add4(Max4(Mul4(plane[0], minX), Mul4(plane[0], maxX)), Max4(Mul4(plane[1], minY), Mul4(plane[1], maxY))),
+				Add4(Max4(Mul4(plane[2], minZ), Mul4(plane[2], maxZ)), plane[3]));
+			lanes &= MoveMask4(LessEqual4(zero, distance));
+		}
+		return lanes;
+	}, out);
+}
+
+void Bvh::QueryPacket( const Ray ray[4], std::vector<unsigned> out[4] ) const
+{
+	float ox[4], oy[4], oz[4], ix[4], iy[4], iz[4], maxDistance[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		ox[i] = ray[i].origin.x; oy[i] = ray[i].origin.y; oz[i] = ray[i].origin.z;
+		ix[i] = 1.0f / ray[i].direction.x; iy[i] = 1.0f / ray[i].direction.y; iz[i] = 1.0f / ray[i].direction.z;
+		maxDistance[i] = ray[i].maxDistance;
+	}
+	Float4 originX = Load4(ox), originY = Load4(oy), originZ = Load4(oz);
+	Float4 invX = Load4(ix), invY = Load4(iy), invZ = Load4(iz);
+	Float4 tStart = Splat4(0), tEnd = Load4(maxDistance);
+
+	TraversePacket([&](const AABB &bounds) {
+		Float4 x0 = Mul4(Sub4(Splat4(bounds.min.x), originX), invX), x1 = Mul4(Sub4(Splat4(bounds.max.x), originX), invX);
+		Float4 y0 = Mul4(Sub4(Splat4(bounds.min.y), originY), invY), y1 = Mul4(Sub4(Splat4(bounds.max.y), originY), invY);
+		Float4 z0 = Mul4(Sub4(Splat4(bounds.min.z), originZ), invZ), z1 = Mul4(Sub4(Splat4(bounds.max.z), originZ), invZ);
+		Float4 tMin = Max4(Max4(tStart, Min4(x0, x1)), Max4(Min4(y0, y1), Min4(z0, z1)));
+		Float4 tMax = Min4(Min4(tEnd, Max4(x0, x1)), Min4(Max4(y0, y1), Max4(z0, z1)));
+		return MoveMask4(LessEqual4(tMin, tMax));
+	}, out);
+}
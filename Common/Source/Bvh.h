@@ -0,0 +1,105 @@
+/******************************************************************************/
+/*!
+\file	Bvh.h
+\brief
+Dynamic bounding volume hierarchy over object boxes, for culling, overlap
+and ray queries that visit O(log n) nodes instead of every object
+*/
+/******************************************************************************/
+#ifndef BVH_H
+#define BVH_H
+
+#include <vector>
+#include "Bounds.h"
+
+/******************************************************************************/
+/*!
+		Class Bvh:
+\brief	Binary tree of boxes with one proxy per leaf; each proxy is an
+		object's world box and a user value, such as an entity or node ID.
+
+		Build rebuilds the tree top down, splitting by the binned surface
+		area heuristic. Insert and Remove change the tree in place, picking
+		the cheapest sibling by the same heuristic, and Move only refits the
+		ancestors of the proxy, so moving objects cost O(log n) per frame.
+		Rebuild after many moves, inserts or removes to restore the quality
+		of the tree.
+
+		Queries append the user values of the proxies whose boxes pass.
+		The packet forms take four queries and test each node against all
+		four at once, one per SIMD lane, leaving a node as soon as none of
+		the four needs it.
+*/
+/******************************************************************************/
+class Bvh
+{
+public:
+	typedef unsigned ProxyID;
+	static const ProxyID NO_PROXY = 0xFFFFFFFF;
+
+	Bvh();
+	~Bvh();
+
+	ProxyID Insert( const AABB& bounds, unsigned userData );
+	void Remove( ProxyID proxy );
+	//New bounds for the proxy, refitting only its ancestors
+	void Move( ProxyID proxy, const AABB& bounds );
+	//Rebuild the tree from every proxy; proxy IDs stay valid
+	void Build( void );
+	void Clear( void );
+
+	unsigned GetUserData( ProxyID proxy ) const;
+	const AABB& GetBounds( ProxyID proxy ) const;
+	unsigned GetProxyCount( void ) const;
+	unsigned GetHeight( void ) const; //0 for a single proxy
+	float GetCost( void ) const; //Surface area heuristic cost of the tree, for tuning
+
+	//Single queries
+	void Query( const AABB& box, std::vector<unsigned> &out ) const;
+	void Query( const Vector3& center, float radius, std::vector<unsigned> &out ) const;
+	void Query( const Frustum& frustum, std::vector<unsigned> &out ) const;
+	void Query( const Ray& ray, std::vector<unsigned> &out ) const;
+	//Nearest proxy box the ray enters; false, leaving the outputs untouched, if none
+	bool Raycast( const Ray& ray, unsigned &userData, float &distance ) const;
+
+	//Packets of four queries; out[i] gets the hits of query i
+	void QueryPacket( const AABB box[4], std::vector<unsigned> out[4] ) const;
+	void QueryPacket( const Vector3 center[4], const float radius[4], std::vector<unsigned> out[4] ) const;
+	void QueryPacket( const Frustum frustum[4], std::vector<unsigned> out[4] ) const;
+	void QueryPacket( const Ray ray[4], std::vector<unsigned> out[4] ) const;
+
+private:
+	static const unsigned NO_NODE = 0xFFFFFFFF;
+
+	struct Node
+	{
+		AABB bounds;
+		unsigned parent; //Next free node while on the free list
+		unsigned child[2]; //NO_NODE for leaves
+		unsigned userData; //Leaves only
+		int height; //0 for leaves, -1 while free
+
+		bool IsLeaf() const { return child[0] == NO_NODE; }
+	};
+
+	unsigned AllocateNode( void );
+	void FreeNode( unsigned node );
+	void InsertLeaf( unsigned leaf );
+	void RemoveLeaf( unsigned leaf );
+	void RefitFrom( unsigned node ); //Recompute the bounds and heights of node and its ancestors
+	unsigned BuildRange( unsigned *leaves, unsigned count );
+
+	//Depth first walk into every node test passes, calling visit on leaves
+	template<typename Test, typename Visit>
+	void Traverse( const Test& test, const Visit& visit ) const;
+	//The same for four queries at once; test returns a lane mask
+	template<typename Test>
+	void TraversePacket( const Test& test, std::vector<unsigned> out[4] ) const;
+
+	std::vector<Node> m_nodes;
+	unsigned m_root;
+	unsigned m_freeList;
+	unsigned m_proxyCount;
+};
+
+#endif //BVH_H
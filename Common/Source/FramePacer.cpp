@@ -0,0 +1,216 @@
+/******************************************************************************/
+/*!
+\file	FramePacer.cpp
+\brief
+Frame rate limiting on the monotonic clock with a hybrid sleep, and frame
+time jitter statistics
+*/
+/******************************************************************************/
+#include <cmath>
+#include <thread>
+#include "FramePacer.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+//The spin margin starts at a Windows timer tick and is kept within these
+static const std::chrono::microseconds INITIAL_SPIN(2000);
+static const std::chrono::microseconds MIN_SPIN(200);
+static const std::chrono::microseconds MAX_SPIN(4000);
+//Weight of each new oversleep in the average; the margin is twice that
+static const double CALIBRATION_RATE = 0.1;
+//Vsync frames are held to a little under the refresh period, so a frame
+//the swap has already aligned never waits
+static const double VSYNC_SLACK = 0.9;
+
+FramePacer::Stats::Stats()
+	: frames(0), meanFrame(0), jitter(0), minFrame(0), maxFrame(0)
+	, meanLateness(0), maxLateness(0), missed(0)
+{
+}
+
+FramePacer::FramePacer()
+	: m_mode(MODE_UNCAPPED)
+	, m_period(Clock::duration::zero())
+	, m_spinMargin(INITIAL_SPIN)
+	, m_oversleep(0)
+	, m_frameSquares(0)
+	, m_waits(0)
+{
+#if defined(_WIN32)
+	//Sleep to the millisecond instead of the default 15.6 ms tick
+	timeBeginPeriod(1);
+#endif
+	Start();
+}
+
+FramePacer::~FramePacer()
+{
+#if defined(_WIN32)
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::SetFixed( double framesPerSecond )
+{
+	m_mode = MODE_FIXED;
+	m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1 / framesPerSecond));
+	m_deadline = Clock::now();
+}
+
+void FramePacer::SetVsync( double refreshRate )
+{
+	m_mode = MODE_VSYNC;
+	m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(VSYNC_SLACK / refreshRate));
+}
+
+void FramePacer::SetUncapped( void )
+{
+	m_mode = MODE_UNCAPPED;
+	m_period = Clock::duration::zero();
+}
+
+FramePacer::MODE FramePacer::GetMode( void ) const
+{
+	return m_mode;
+}
+
+void FramePacer::Start( void )
+{
+	m_frameStart = Clock::now();
+	m_deadline = m_frameStart;
+	ResetStats();
+}
+
+/******************************************************************************/
+/*!
+\brief
+End the frame. Fixed frames wait for the next slot of their schedule, and a
+frame more than a whole period late moves the schedule to now instead of
+rushing the following frames to catch up. Vsync frames wait only until a
+little under a refresh period after the last frame started.
+
+\return Seconds since the last frame started
+*/
+/******************************************************************************/
+double FramePacer::Wait( void )
+{
+	bool waited = false;
+	double lateness = 0;
+	if (m_mode != MODE_UNCAPPED)
+	{
+		Clock::time_point deadline = m_mode == MODE_FIXED ? m_deadline + m_period : m_frameStart + m_period;
+		Clock::time_point now = Clock::now();
+		if (now < deadline)
+		{
+			WaitUntil(deadline);
+			lateness = std::chrono::duration<double>(Clock::now() - deadline).count();
+			waited = true;
+		}
+		else if (now - deadline > m_period)
+		{
+			deadline = now;
+		}
+		m_deadline = deadline;
+	}
+
+	Clock::time_point now = Clock::now();
+	double frame = std::chrono::duration<double>(now - m_frameStart).count();
+	m_frameStart = now;
+	Record(frame, lateness, waited);
+	return frame;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Sleep on the OS timer until the spin margin before deadline, then spin the
+rest. Every coarse sleep updates the average of how late it woke, and the
+margin follows it, so it ends up as short as this machine's timer allows.
+
+\param deadline - returns at or just after this
+*/
+/******************************************************************************/
+void FramePacer::WaitUntil( Clock::time_point deadline )
+{
+	Clock::time_point wake = deadline - m_spinMargin;
+	if (Clock::now() < wake)
+	{
+		SleepCoarse(wake);
+
+		double oversleep = std::chrono::duration<double>(Clock::now() - wake).count();
+		m_oversleep += (oversleep - m_oversleep) * CALIBRATION_RATE;
+		m_spinMargin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(2 * m_oversleep));
+		if (m_spinMargin < MIN_SPIN)
+			m_spinMargin = MIN_SPIN;
+		else if (m_spinMargin > MAX_SPIN)
+			m_spinMargin = MAX_SPIN;
+	}
+
+	while (Clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+}
+
+//Coarse sleep, woken by the OS timer
+void FramePacer::SleepCoarse( Clock::time_point until )
+{
+#if defined(__linux__)
+	//steady_clock is CLOCK_MONOTONIC here; an absolute sleep cannot drift
+	//when it is interrupted and restarted
+	long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(until.time_since_epoch()).count();
+	timespec ts;
+	ts.tv_sec = (time_t)(ns / 1000000000);
+	ts.tv_nsec = (long)(ns % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+	{
+	}
+#else
+	std::this_thread::sleep_until(until);
+#endif
+}
+
+const FramePacer::Stats& FramePacer::GetStats( void ) const
+{
+	return m_stats;
+}
+
+void FramePacer::ResetStats( void )
+{
+	m_stats = Stats();
+	m_frameSquares = 0;
+	m_waits = 0;
+}
+
+//Running mean and variance of the frame time (Welford), in milliseconds
+void FramePacer::Record( double frame, double lateness, bool waited )
+{
+	double ms = frame * 1000;
+	Stats &stats = m_stats;
+	++stats.frames;
+	double delta = ms - stats.meanFrame;
+	stats.meanFrame += delta / stats.frames;
+	m_frameSquares += delta * (ms - stats.meanFrame);
+	stats.jitter = stats.frames > 1 ? sqrt(m_frameSquares / (stats.frames - 1)) : 0;
+	stats.minFrame = stats.frames == 1 || ms < stats.minFrame ? ms : stats.minFrame;
+	stats.maxFrame = ms > stats.maxFrame ? ms : stats.maxFrame;
+
+	if (waited)
+	{
+		double lateMs = lateness * 1000;
+		++m_waits;
+		stats.meanLateness += (lateMs - stats.meanLateness) / m_waits;
+		stats.maxLateness = lateMs > stats.maxLateness ? lateMs : stats.maxLateness;
+	}
+
+	double target = std::chrono::duration<double, std::milli>(m_period).count();
+	if (m_mode == MODE_VSYNC)
+		target /= VSYNC_SLACK;
+	if (m_mode != MODE_UNCAPPED && ms >= target * 1.5)
+		++stats.missed;
+}
@@ -0,0 +1,92 @@
+/******************************************************************************/
+/*!
+\file	FramePacer.h
+\brief
+Frame rate limiting on the monotonic clock with a hybrid sleep, and frame
+time jitter statistics
+*/
+/******************************************************************************/
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+
+/******************************************************************************/
+/*!
+		Class FramePacer:
+\brief	Ends each frame at its target time. A wait sleeps on the OS timer
+		until a margin before the deadline, then spins for the rest, so it
+		neither burns a core for the whole wait nor overshoots by a
+		scheduler tick. The margin is calibrated from how late the coarse
+		sleeps actually wake.
+
+		Fixed targets keep an absolute schedule, so frame times do not drift,
+		and skip frames they fall a whole frame behind on. Vsync targets
+		assume the swap already waits for the display and only hold back
+		frames a driver lets through early. Uncapped frames never wait.
+
+		One pacer per thread; it is not thread safe.
+*/
+/******************************************************************************/
+class FramePacer
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	enum MODE
+	{
+		MODE_FIXED,
+		MODE_VSYNC,
+		MODE_UNCAPPED,
+	};
+
+	//Since Start or ResetStats; times in milliseconds
+	struct Stats
+	{
+		unsigned frames;
+		double meanFrame;
+		double jitter; //Standard deviation of the frame time
+		double minFrame, maxFrame;
+		double meanLateness, maxLateness; //Woken past the deadline, over the waits
+		unsigned missed; //Frames half a target or more over it
+
+		Stats();
+	};
+
+	FramePacer();
+	~FramePacer();
+
+	void SetFixed( double framesPerSecond );
+	void SetVsync( double refreshRate );
+	void SetUncapped( void );
+	MODE GetMode( void ) const;
+
+	//The first frame starts now
+	void Start( void );
+	//End the frame: wait for its target and start the next; returns the
+	//seconds since the last frame started
+	double Wait( void );
+	//Hybrid sleep to deadline, for pacing loops of other kinds
+	void WaitUntil( Clock::time_point deadline );
+
+	const Stats& GetStats( void ) const;
+	void ResetStats( void );
+
+private:
+	void SleepCoarse( Clock::time_point until );
+	void Record( double frame, double lateness, bool waited );
+
+	MODE m_mode;
+	Clock::duration m_period;
+	Clock::time_point m_frameStart;
+	Clock::time_point m_deadline; //Of the last fixed frame
+
+	Clock::duration m_spinMargin;
+	double m_oversleep; //Average seconds a coarse sleep wakes late
+
+	Stats m_stats;
+	double m_frameSquares; //Sum of squared differences from the mean, for the jitter
+	unsigned m_waits;
+};
+
+#endif //FRAME_PACER_H
@@ -7,6 +7,7 @@
 Matrix Stack to replace openGL math function
 */
 /******************************************************************************/
+#include <cassert>
 #include "MatrixStack.h"
 
 /******************************************************************************/
@@ -15,10 +16,10 @@ Matrix Stack to replace openGL math function
 MS default constructor
 */
 /******************************************************************************/
-MS::MS() {
-	Mtx44 mat;
-	mat.SetToIdentity();
-	ms.push(mat);
+MS::MS() : depth(0), lastStamp(0) {
+	ms[0].matrix.SetToIdentity();
+	ms[0].rigid = true;
+	ms[0].stamp = 0;
 }
 
 /******************************************************************************/
@@ -30,6 +31,16 @@ MS destructor
 MS::~MS() {
 }
 
+/******************************************************************************/
+/*!
+\brief
+Give the top matrix a new stamp after it was modified
+*/
+/******************************************************************************/
+void MS::Changed() {
+	ms[depth].stamp = ++lastStamp;
+}
+
 /******************************************************************************/
 /*!
 \brief
@@ -40,7 +51,35 @@ Return the top matrix on the matrix stack
 */
 /******************************************************************************/
 const Mtx44& MS::Top() const {
-	return ms.top();
+	return ms[depth].matrix;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Check if the top matrix is made of rotations and translations only
+
+\return
+	true if the top matrix is rigid, its rotation block is then its own
+	inverse transpose
+*/
+/******************************************************************************/
+bool MS::IsRigid() const {
+	return ms[depth].rigid;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return a value identifying the top matrix. It changes when the top matrix is
+modified and comes back when a pop returns to an unmodified level.
+
+\return
+	Stamp of the top matrix
+*/
+/******************************************************************************/
+unsigned MS::Stamp() const {
+	return ms[depth].stamp;
 }
 
 /******************************************************************************/
@@ -50,7 +89,8 @@ Pop the top matrix on the matrix stack
 */
 /******************************************************************************/
 void MS::PopMatrix() {
-	ms.pop();
+	assert(depth > 0 && "MS::PopMatrix without a matching PushMatrix");
+	--depth;
 }
 
 /******************************************************************************/
@@ -60,7 +100,9 @@ Make a copy of the top matrix on the matrix stack and push it on top
 */
 /******************************************************************************/
 void MS::PushMatrix() {
-	ms.push(ms.top());
+	assert(depth + 1 < MAX_DEPTH && "MS::PushMatrix past MAX_DEPTH");
+	ms[depth + 1] = ms[depth];
+	++depth;
 }
 
 /******************************************************************************/
@@ -70,8 +112,7 @@ Clear the matrix stack
 */
 /******************************************************************************/
 void MS::Clear() {
-	while(ms.size() > 1)
-		ms.pop();
+	depth = 0;
 }
 
 /******************************************************************************/
@@ -81,9 +122,9 @@ Replace the top matrix with an identity matrix
 */
 /******************************************************************************/
 void MS::LoadIdentity() {
-	Mtx44 mat;
-	mat.SetToIdentity();
-	ms.top() = mat;
+	ms[depth].matrix.SetToIdentity();
+	ms[depth].rigid = true;
+	Changed();
 }
 
 /******************************************************************************/
@@ -96,7 +137,9 @@ Return the top matrix with a new matrix
 */
 /******************************************************************************/
 void MS::LoadMatrix(const Mtx44 &matrix) {
-	ms.top() = matrix;
+	ms[depth].matrix = matrix;
+	ms[depth].rigid = false;
+	Changed();
 }
 
 /******************************************************************************/
@@ -109,7 +152,9 @@ Multiply the top matrix with a new matrix
 */
 /******************************************************************************/
 void MS::MultMatrix(const Mtx44 &matrix) {
-	ms.top() = ms.top() * matrix;
+	ms[depth].matrix = ms[depth].matrix * matrix;
+	ms[depth].rigid = false;
+	Changed();
 }
 
 /******************************************************************************/
@@ -128,9 +173,68 @@ Multiply the top matrix with a rotation matrix based on the following parameters
 */
 /******************************************************************************/
 void MS::Rotate(float degrees, float axisX, float axisY, float axisZ) {
-	Mtx44 mat;
-	mat.SetToRotation(degrees, axisX, axisY, axisZ);
-	ms.top() = ms.top() * mat;
+	//About a single axis only two columns change: with (i, j) the axes
+	//following the rotation axis, column i becomes ci*c + cj*s and column j
+	//becomes cj*c - ci*s, s taking the sign of the axis
+	int i, j;
+	float sign;
+	if(axisY == 0 && axisZ == 0 && axisX != 0) {
+		i = 1; j = 2; sign = axisX > 0 ? 1.f : -1.f;
+	}
+	else if(axisX == 0 && axisZ == 0 && axisY != 0) {
+		i = 2; j = 0; sign = axisY > 0 ? 1.f : -1.f;
+	}
+	else if(axisX == 0 && axisY == 0 && axisZ != 0) {
+		i = 0; j = 1; sign = axisZ > 0 ? 1.f : -1.f;
+	}
+	else {
+		Mtx44 mat;
+		mat.SetToRotation(degrees, axisX, axisY, axisZ);
+		ms[depth].matrix = ms[depth].matrix * mat;
+		Changed();
+		return;
+	}
+
+	float c = (float)cos(degrees * Math::PI / 180);
+	float s = sign * (float)sin(degrees * Math::PI / 180);
+	float *m = ms[depth].matrix.a;
+	for(int row = 0; row < 4; row++) {
+		float ci = m[i * 4 + row];
+		float cj = m[j * 4 + row];
+		m[i * 4 + row] = ci * c + cj * s;
+		m[j * 4 + row] = cj * c - ci * s;
+	}
+	Changed();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Multiply the top matrix with the rotation matrix of a quaternion, which needs
+no trig
+
+\param	rotation
+	Unit quaternion
+*/
+/******************************************************************************/
+void MS::Rotate(const Quaternion &rotation) {
+	ms[depth].matrix = ms[depth].matrix * rotation.GetMatrix();
+	Changed();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Multiply the top matrix with a translate, rotate and scale transform
+
+\param	transform
+	Transform of a child node
+*/
+/******************************************************************************/
+void MS::MultTransform(const Transform &transform) {
+	ms[depth].matrix = ms[depth].matrix * transform.GetMatrix();
+	ms[depth].rigid = ms[depth].rigid && transform.scale.x == 1 && transform.scale.y == 1 && transform.scale.z == 1;
+	Changed();
 }
 
 /******************************************************************************/
@@ -147,9 +251,15 @@ Multiply the top matrix with a scale matrix based on the following parameters
 */
 /******************************************************************************/
 void MS::Scale(float scaleX, float scaleY, float scaleZ) {
-	Mtx44 mat;
-	mat.SetToScale(scaleX, scaleY, scaleZ);
-	ms.top() = ms.top() * mat;
+	//Scales columns 0 to 2, translation is untouched
+	float *m = ms[depth].matrix.a;
+	for(int row = 0; row < 4; row++) {
+		m[0 + row] *= scaleX;
+		m[4 + row] *= scaleY;
+		m[8 + row] *= scaleZ;
+	}
+	ms[depth].rigid = ms[depth].rigid && scaleX == 1 && scaleY == 1 && scaleZ == 1;
+	Changed();
 }
 
 /******************************************************************************/
@@ -167,9 +277,11 @@ parameters
 */
 /******************************************************************************/
 void MS::Translate(float translateX, float translateY, float translateZ) {
-	Mtx44 mat;
-	mat.SetToTranslation(translateX, translateY, translateZ);
-	ms.top() = ms.top() * mat;
+	//Only column 3 changes
+	float *m = ms[depth].matrix.a;
+	for(int row = 0; row < 4; row++)
+		m[12 + row] += m[0 + row] * translateX + m[4 + row] * translateY + m[8 + row] * translateZ;
+	Changed();
 }
 
 /******************************************************************************/
@@ -194,7 +306,9 @@ Setup frustum matrix and push to matrix stack
 void MS::Frustum(double left, double right, double bottom, double top, double near, double far) {
 	Mtx44 mat;
 	mat.SetToFrustum(left, right, bottom, top, near, far);
-	ms.top() = ms.top() * mat;
+	ms[depth].matrix = ms[depth].matrix * mat;
+	ms[depth].rigid = false;
+	Changed();
 }
 
 /******************************************************************************/
@@ -227,5 +341,88 @@ void MS::LookAt(double eyeX, double eyeY, double eyeZ,
 {
 	Mtx44 mat;
 	mat.SetToLookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ);
-	ms.top() = ms.top() * mat;
+	ms[depth].matrix = ms[depth].matrix * mat;
+	Changed();
+}
+
+/******************************************************************************/
+/*!
+\brief
+MVPCache default constructor, the first Update always computes
+*/
+/******************************************************************************/
+MVPCache::MVPCache() : projectionStamp(0), viewStamp(0), modelStamp(0), rigid(false), valid(false), normalValid(false) {
+}
+
+/******************************************************************************/
+/*!
+\brief
+Recompute the cached matrices if any of the stacks changed
+
+\param projectionStack
+	Projection matrix stack
+\param viewStack
+	View matrix stack
+\param modelStack
+	Model matrix stack
+*/
+/******************************************************************************/
+void MVPCache::Update(const MS &projectionStack, const MS &viewStack, const MS &modelStack) {
+	if(valid && projectionStamp == projectionStack.Stamp() && viewStamp == viewStack.Stamp() && modelStamp == modelStack.Stamp())
+		return;
+
+	projectionStamp = projectionStack.Stamp();
+	viewStamp = viewStack.Stamp();
+	modelStamp = modelStack.Stamp();
+	modelView = viewStack.Top() * modelStack.Top();
+	MVP = projectionStack.Top() * modelView;
+	rigid = viewStack.IsRigid() && modelStack.IsRigid();
+	valid = true;
+	normalValid = false;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return the cached view * model matrix
+
+\return
+	Model-view matrix as of the last Update
+*/
+/******************************************************************************/
+const Mtx44& MVPCache::GetModelView() const {
+	return modelView;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return the cached projection * view * model matrix
+
+\return
+	MVP matrix as of the last Update
+*/
+/******************************************************************************/
+const Mtx44& MVPCache::GetMVP() const {
+	return MVP;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return the inverse transpose of the model-view matrix, computed on first use
+after each change
+
+\exception DivideByZero
+	thrown if the model-view matrix is singular
+\return
+	Normal matrix as of the last Update
+*/
+/******************************************************************************/
+const Mtx44& MVPCache::GetNormalMatrix() {
+	if(!normalValid) {
+		normalMatrix = modelView.GetNormalMatrix(rigid);
+		normalValid = true;
+	}
+	return normalMatrix;
 }
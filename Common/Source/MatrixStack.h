@@ -10,21 +10,42 @@ Matrix Stack to replace openGL math function
 #ifndef MATRIXSTACK_H
 #define MATRIXSTACK_H
 
-#include <stack>
 #include "Mtx44.h"
+#include "Transform.h"
 
 /******************************************************************************/
 /*!
 		Class MS:
-\brief	Matrix Stack class
+\brief	Matrix Stack class. Each level also records whether its matrix is
+		rigid (built only from rotations, translations and look-ats), so
+		renderers can skip inverting it for the normal matrix.
+		Levels live in a fixed array, so pushing never allocates, and every
+		level carries a stamp that changes whenever its matrix does, so
+		renderers can cache products of Top() until it changes.
 */
 /******************************************************************************/
 class MS {
-	std::stack<Mtx44> ms;
+public:
+	static const unsigned MAX_DEPTH = 32;
+
+private:
+	struct Level {
+		Mtx44 matrix;
+		bool rigid;
+		unsigned stamp;
+	};
+	Level ms[MAX_DEPTH];
+	unsigned depth;
+	unsigned lastStamp;
+
+	void Changed();
+
 public:
 	MS();
 	~MS();
 	const Mtx44& Top() const;
+	bool IsRigid() const;
+	unsigned Stamp() const;
 	void PopMatrix();
 	void PushMatrix();
 	void Clear();
@@ -32,6 +53,8 @@ public:
 	void LoadMatrix(const Mtx44 &matrix);
 	void MultMatrix(const Mtx44 &matrix);
 	void Rotate(float degrees, float axisX, float axisY, float axisZ);
+	void Rotate(const Quaternion &rotation);
+	void MultTransform(const Transform &transform);
 	void Scale(float scaleX, float scaleY, float scaleZ);
 	void Translate(float translateX, float translateY, float translateZ);
 	void Frustum(double left, double right, double	bottom, double top, double near, double far);
@@ -40,4 +63,28 @@ public:
 				double upX, double upY, double upZ);
 };
 
+/******************************************************************************/
+/*!
+		Class MVPCache:
+\brief	Model-view, MVP and normal matrix of three matrix stacks, only
+		recomputed when the top of one of the stacks changed since the last
+		Update
+*/
+/******************************************************************************/
+class MVPCache {
+	Mtx44 modelView;
+	Mtx44 MVP;
+	Mtx44 normalMatrix;
+	unsigned projectionStamp, viewStamp, modelStamp;
+	bool rigid;
+	bool valid;
+	bool normalValid;
+public:
+	MVPCache();
+	void Update(const MS &projectionStack, const MS &viewStack, const MS &modelStack);
+	const Mtx44& GetModelView() const;
+	const Mtx44& GetMVP() const;
+	const Mtx44& GetNormalMatrix();
+};
+
 #endif
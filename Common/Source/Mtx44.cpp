@@ -8,36 +8,8 @@ Matrix 4 by 4 use for affine transformation
 */
 /******************************************************************************/
 #include "Mtx44.h"
-/******************************************************************************/
-/*!
-\brief
-Default Constructor. Default values are zero
-
-\param a00 to a33 - Initial values for the matrix in (row, column) format
-
-\exception None
-\return None
-*/
-/******************************************************************************/
-Mtx44::Mtx44(float a00, float a10, float a20, float a30, float a01, float a11, float a21, float a31, float a02, float a12, float a22, float a32, float a03, float a13, float a23, float a33) {
-	a[0] = a00;
-	a[1] = a10;
-	a[2] = a20;
-	a[3] = a30;
-	a[4] = a01;
-	a[5] = a11;
-	a[6] = a21;
-	a[7] = a31;
-	a[8] = a02;
-	a[9] = a12;
-	a[10] = a22;
-	a[11] = a32;
-	a[12] = a03;
-	a[13] = a13;
-	a[14] = a23;
-	a[15] = a33;
-}
-
+#include "Mtx44Kernels.h"
+#include <cstring>
 /******************************************************************************/
 /*!
 \brief
@@ -50,19 +22,7 @@ Constructor with array of 16 floats. Default values are zero
 */
 /******************************************************************************/
 Mtx44::Mtx44(const float m[16]) {
-	for(int i = 0; i < 16; i++)
-		a[i] = m[i];
-}
-
-/******************************************************************************/
-/*!
-\brief
-Copy constructor
-*/
-/******************************************************************************/
-Mtx44::Mtx44(const Mtx44 &rhs) {
-	for(int i = 0; i < 16; i++)
-		a[i] = rhs.a[i];
+	memcpy(a, m, sizeof(a));
 }
 
 /******************************************************************************/
@@ -76,18 +36,6 @@ void Mtx44::SetToIdentity(void) {
 	a[0] = a[5] = a[10] = a[15] = 1;
 }
 
-/******************************************************************************/
-/*!
-\brief
-Helper function swap
-*/
-/******************************************************************************/
-void swap(float &v1, float &v2) {
-	float temp = v1;
-	v1 = v2;
-	v2 = temp;
-}
-
 /******************************************************************************/
 /*!
 \brief
@@ -95,9 +43,7 @@ Set this matrix to its Transpose
 */
 /******************************************************************************/
 void Mtx44::Transpose(void) {
-	for(int i = 0; i < 4; i++)
-		for(int j = i + 1; j < 4; j++)
-			swap(a[i * 4 + j], a[j * 4 + i]);
+	Mtx44Kernels::Transpose(a, a);
 }
 
 /******************************************************************************/
@@ -121,8 +67,8 @@ A new matrix
 */
 /******************************************************************************/
 Mtx44 Mtx44::GetTranspose() const {
-	Mtx44 ret(*this);
-	ret.Transpose();
+	Mtx44 ret;
+	Mtx44Kernels::Transpose(a, ret.a);
 	return ret;
 }
 
@@ -136,64 +82,90 @@ Return a new matrix that is an inverse
 \return A new matrix
 */
 /******************************************************************************/
-Mtx44 Mtx44::GetInverse() const throw( DivideByZero ) {
-	float a0 = a[ 0]*a[ 5] - a[ 1]*a[ 4];
-    float a1 = a[ 0]*a[ 6] - a[ 2]*a[ 4];
-    float a2 = a[ 0]*a[ 7] - a[ 3]*a[ 4];
-    float a3 = a[ 1]*a[ 6] - a[ 2]*a[ 5];
-    float a4 = a[ 1]*a[ 7] - a[ 3]*a[ 5];
-    float a5 = a[ 2]*a[ 7] - a[ 3]*a[ 6];
-    float b0 = a[ 8]*a[13] - a[ 9]*a[12];
-    float b1 = a[ 8]*a[14] - a[10]*a[12];
-    float b2 = a[ 8]*a[15] - a[11]*a[12];
-    float b3 = a[ 9]*a[14] - a[10]*a[13];
-    float b4 = a[ 9]*a[15] - a[11]*a[13];
-    float b5 = a[10]*a[15] - a[11]*a[14];
-
-    float det = a0*b5 - a1*b4 + a2*b3 + a3*b2 - a4*b1 + a5*b0;
-	if(abs(det) < Math::EPSILON)
+Mtx44 Mtx44::GetInverse() const {
+	Mtx44 inverse;
+	if(!Mtx44Kernels::Inverse(a, inverse.a))
 		throw DivideByZero();
-    Mtx44 inverse;
-	if (Math::FAbs(det) > Math::EPSILON)
-    {
-        inverse.a[ 0] = + a[ 5]*b5 - a[ 6]*b4 + a[ 7]*b3;
-        inverse.a[ 4] = - a[ 4]*b5 + a[ 6]*b2 - a[ 7]*b1;
-        inverse.a[ 8] = + a[ 4]*b4 - a[ 5]*b2 + a[ 7]*b0;
-        inverse.a[12] = - a[ 4]*b3 + a[ 5]*b1 - a[ 6]*b0;
-        inverse.a[ 1] = - a[ 1]*b5 + a[ 2]*b4 - a[ 3]*b3;
-        inverse.a[ 5] = + a[ 0]*b5 - a[ 2]*b2 + a[ 3]*b1;
-        inverse.a[ 9] = - a[ 0]*b4 + a[ 1]*b2 - a[ 3]*b0;
-        inverse.a[13] = + a[ 0]*b3 - a[ 1]*b1 + a[ 2]*b0;
-        inverse.a[ 2] = + a[13]*a5 - a[14]*a4 + a[15]*a3;
-        inverse.a[ 6] = - a[12]*a5 + a[14]*a2 - a[15]*a1;
-        inverse.a[10] = + a[12]*a4 - a[13]*a2 + a[15]*a0;
-        inverse.a[14] = - a[12]*a3 + a[13]*a1 - a[14]*a0;
-        inverse.a[ 3] = - a[ 9]*a5 + a[10]*a4 - a[11]*a3;
-        inverse.a[ 7] = + a[ 8]*a5 - a[10]*a2 + a[11]*a1;
-        inverse.a[11] = - a[ 8]*a4 + a[ 9]*a2 - a[11]*a0;
-        inverse.a[15] = + a[ 8]*a3 - a[ 9]*a1 + a[10]*a0;
-
-        float invDet = ((float)1)/det;
-        inverse.a[ 0] *= invDet;
-        inverse.a[ 1] *= invDet;
-        inverse.a[ 2] *= invDet;
-        inverse.a[ 3] *= invDet;
-        inverse.a[ 4] *= invDet;
-        inverse.a[ 5] *= invDet;
-        inverse.a[ 6] *= invDet;
-        inverse.a[ 7] *= invDet;
-        inverse.a[ 8] *= invDet;
-        inverse.a[ 9] *= invDet;
-        inverse.a[10] *= invDet;
-        inverse.a[11] *= invDet;
-        inverse.a[12] *= invDet;
-        inverse.a[13] *= invDet;
-        inverse.a[14] *= invDet;
-        inverse.a[15] *= invDet;
-    }
 	return inverse;
 }
 
+/******************************************************************************/
+/*!
+\brief
+Compute the inverse without the exception check
+
+\param inverse
+	Receives the inverse, untouched if the matrix is singular
+\exception None
+\return true if the matrix has an inverse
+*/
+/******************************************************************************/
+bool Mtx44::TryGetInverse(Mtx44 &inverse) const noexcept {
+	return Mtx44Kernels::Inverse(a, inverse.a);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Check if the bottom row is (0, 0, 0, 1), i.e. the matrix is a linear
+transform followed by a translation with no projection
+
+\return true if the matrix is affine
+*/
+/******************************************************************************/
+bool Mtx44::IsAffine() const {
+	return a[3] == 0 && a[7] == 0 && a[11] == 0 && a[15] == 1;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return the matrix that transforms normals, the inverse transpose of this
+matrix. Translation never affects normals, so for an affine matrix only the
+upper 3x3 is inverted; a rigid matrix (rotation and translation only) is its
+own inverse transpose and the rotation block is returned as is.
+
+\param rigid
+	true if the caller knows the matrix is rotation and translation only
+\exception DivideByZero
+	thrown if the determinant of the matrix is zero
+\return A new matrix with no translation
+*/
+/******************************************************************************/
+Mtx44 Mtx44::GetNormalMatrix(bool rigid) const {
+	if(!IsAffine())
+		return GetInverse().GetTranspose();
+
+	Mtx44 ret;
+	ret.a[15] = 1;
+	if(rigid) {
+		for(int i = 0; i < 3; i++)
+			for(int j = 0; j < 3; j++)
+				ret.a[i * 4 + j] = a[i * 4 + j];
+		return ret;
+	}
+
+	//Cofactors of the upper 3x3; the inverse transpose is the cofactor matrix over the determinant
+	float c00 = a[5] * a[10] - a[9] * a[6];
+	float c01 = a[8] * a[6] - a[4] * a[10];
+	float c02 = a[4] * a[9] - a[8] * a[5];
+	float det = a[0] * c00 + a[1] * c01 + a[2] * c02;
+	if(Math::FAbs(det) < Math::EPSILON)
+		throw DivideByZero();
+	float invDet = 1.0f / det;
+
+	ret.a[0] = c00 * invDet;
+	ret.a[1] = c01 * invDet;
+	ret.a[2] = c02 * invDet;
+	ret.a[4] = (a[9] * a[2] - a[1] * a[10]) * invDet;
+	ret.a[5] = (a[0] * a[10] - a[8] * a[2]) * invDet;
+	ret.a[6] = (a[8] * a[1] - a[0] * a[9]) * invDet;
+	ret.a[8] = (a[1] * a[6] - a[5] * a[2]) * invDet;
+	ret.a[9] = (a[4] * a[2] - a[0] * a[6]) * invDet;
+	ret.a[10] = (a[0] * a[5] - a[4] * a[1]) * invDet;
+	return ret;
+}
+
 /******************************************************************************/
 /*!
 \brief
@@ -207,9 +179,7 @@ operator* overload for matrix-matrix multiplication
 /******************************************************************************/
 Mtx44 Mtx44::operator*(const Mtx44& rhs) const {
 	Mtx44 ret;
-	for(int i = 0; i < 4; i++)
-		for(int j = 0; j < 4; j++)
-			ret.a[i * 4 + j] = a[0 * 4 + j] * rhs.a[i * 4 + 0] + a[1 * 4 + j] * rhs.a[i * 4 + 1] + a[2 * 4 + j] * rhs.a[i * 4 + 2] + a[3 * 4 + j] * rhs.a[i * 4 + 3];
+	Mtx44Kernels::Multiply(a, rhs.a, ret.a);
 	return ret;
 }
 
@@ -245,23 +215,6 @@ Mtx44 Mtx44::operator+(const Mtx44& rhs) const {
 		);
 }
 
-/******************************************************************************/
-/*!
-\brief
-operator= overload for assignment
-
-\param rhs
-	Matrix to assign to
-\return 
-	Reference to this matrix
-*/
-/******************************************************************************/
-Mtx44& Mtx44::operator=(const Mtx44& rhs) {
-	for(int i = 0; i < 16; i++)
-		a[i] = rhs.a[i];
-	return *this;
-}
-
 /******************************************************************************/
 /*!
 \brief
@@ -292,9 +245,8 @@ operator* overload for matrix-vector3 multiplication
 */
 /******************************************************************************/
 Vector3 Mtx44::operator*(const Vector3& rhs) const {
-	float b[4];
-	for(int i = 0; i < 4; i++)
-		b[i] = a[0 * 4 + i] * rhs.x + a[1 * 4 + i] * rhs.y + a[2 * 4 + i] * rhs.z + a[3 * 4 + i] * 0;
+	float b[4] = { rhs.x, rhs.y, rhs.z, 0 };
+	Mtx44Kernels::Transform(a, b, b);
 	Vector3 ret(b[0], b[1], b[2]);
 	return ret;
 }
@@ -316,7 +268,7 @@ Set Matrix to a rotation matrix about arbitrary axis
 	Thrown if rotation axis is a zero vector
 */
 /******************************************************************************/
-void Mtx44::SetToRotation(float degrees, float axisX, float axisY, float axisZ) throw( DivideByZero ) {
+void Mtx44::SetToRotation(float degrees, float axisX, float axisY, float axisZ) {
 	double mag = sqrt(axisX * axisX + axisY * axisY + axisZ * axisZ);
 	if(Math::FAbs((float)mag) < Math::EPSILON)
 		throw DivideByZero();
@@ -437,7 +389,8 @@ void Mtx44::SetToLookAt(double eyeX, double eyeY, double eyeZ,
 	f.Normalize();
 	Vector3 up((float)upX, (float)upY, (float)upZ);
 	up.Normalize();
-	Vector3 s = f.Cross(up);
+	//Normalized so the view matrix stays rigid when up is not perpendicular to f
+	Vector3 s = f.Cross(up).Normalize();
 	Vector3 u = s.Cross(f);
 
 	Mtx44 mat(s.x, u.x, -f.x, 0,
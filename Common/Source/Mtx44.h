@@ -13,31 +13,34 @@ Matrix 4 by 4 use for affine transformation
 #include "MyMath.h"
 #include "Vector3.h"
 
-#pragma warning( disable: 4290 ) //for throw(DivideByZero)
-
 /******************************************************************************/
 /*!
 		Class Mtx44:
-\brief	A 4 by 4 matrix
+\brief	A 4 by 4 matrix, column major and 16 byte aligned so each column
+		fits one SIMD register (see Mtx44Kernels.h). Trivially copyable and
+		constexpr constructible from its 16 values.
 */
 /******************************************************************************/
 class Mtx44
 {
 public:
-	Mtx44(float a00 = 0, float a10 = 0, float a20 = 0, float a30 = 0, float a01 = 0, float a11 = 0, float a21 = 0, float a31 = 0, float a02 = 0, float a12 = 0, float a22 = 0, float a32 = 0, float a03 = 0, float a13 = 0, float a23 = 0, float a33 = 0);
+	//Default values are zero, (row, column) names in column major order
+	constexpr Mtx44(float a00 = 0, float a10 = 0, float a20 = 0, float a30 = 0, float a01 = 0, float a11 = 0, float a21 = 0, float a31 = 0, float a02 = 0, float a12 = 0, float a22 = 0, float a32 = 0, float a03 = 0, float a13 = 0, float a23 = 0, float a33 = 0)
+		: a{ a00, a10, a20, a30, a01, a11, a21, a31, a02, a12, a22, a32, a03, a13, a23, a33 } {}
 	Mtx44(const float m[16]);
-	Mtx44(const Mtx44 &rhs);
 	void SetToIdentity(void);
 	void Transpose(void);
 	void SetToZero(void);
 	Mtx44 GetTranspose() const;
-	Mtx44 GetInverse() const throw( DivideByZero );
+	Mtx44 GetInverse() const;
+	bool TryGetInverse(Mtx44 &inverse) const noexcept; //false, inverse untouched, if singular
+	bool IsAffine() const;
+	Mtx44 GetNormalMatrix(bool rigid = false) const;
 	Mtx44 operator*(const Mtx44& rhs) const;
 	Mtx44 operator+(const Mtx44& rhs) const;
-	Mtx44& operator=(const Mtx44& rhs);
 	Mtx44 operator*(float scalar) const;
 	Vector3 operator*(const Vector3& rhs) const;
-	void SetToRotation(float degrees, float axisX, float axisY, float axisZ) throw( DivideByZero );
+	void SetToRotation(float degrees, float axisX, float axisY, float axisZ);
 	void SetToScale(float sx, float sy, float sz);
 	void SetToTranslation(float tx, float ty, float tz);
 	void SetToFrustum(double left, double right, double	bottom, double top, double near, double far);
@@ -47,7 +50,7 @@ public:
 	void SetToPerspective(double fovy, double aspect, double zNear, double zFar);
 	void SetToOrtho(double left, double right, double bottom, double top, double nearVal, double farVal);
 
-	float a[16];
+	alignas(16) float a[16];
 };
 
 #endif //MTX_44_H
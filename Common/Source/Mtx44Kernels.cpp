@@ -0,0 +1,343 @@
+/******************************************************************************/
+/*!
+\file	Mtx44Kernels.cpp
+\brief
+Scalar and SIMD 4 by 4 matrix kernels
+*/
+/******************************************************************************/
+#include "Mtx44Kernels.h"
+#include "MyMath.h"
+
+#if defined(MTX44_SSE)
+#include <immintrin.h>
+#elif defined(MTX44_NEON)
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************/
+/*!
+\brief
+Scalar matrix-matrix multiplication, the original Mtx44::operator* loop
+*/
+/******************************************************************************/
+void Mtx44Kernels::MultiplyScalar(const float *lhs, const float *rhs, float *out)
+{
+	float ret[16];
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			ret[i * 4 + j] = lhs[0 * 4 + j] * rhs[i * 4 + 0] + lhs[1 * 4 + j] * rhs[i * 4 + 1] + lhs[2 * 4 + j] * rhs[i * 4 + 2] + lhs[3 * 4 + j] * rhs[i * 4 + 3];
+	for (int i = 0; i < 16; i++)
+		out[i] = ret[i];
+}
+
+void Mtx44Kernels::TransformScalar(const float *m, const float *v, float *out)
+{
+	float ret[4];
+	for (int i = 0; i < 4; i++)
+		ret[i] = m[0 * 4 + i] * v[0] + m[1 * 4 + i] * v[1] + m[2 * 4 + i] * v[2] + m[3 * 4 + i] * v[3];
+	for (int i = 0; i < 4; i++)
+		out[i] = ret[i];
+}
+
+void Mtx44Kernels::TransposeScalar(const float *m, float *out)
+{
+	float ret[16];
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			ret[i * 4 + j] = m[j * 4 + i];
+	for (int i = 0; i < 16; i++)
+		out[i] = ret[i];
+}
+
+/******************************************************************************/
+/*!
+\brief
+Scalar inverse by cofactors, the original Mtx44::GetInverse
+*/
+/******************************************************************************/
+bool Mtx44Kernels::InverseScalar(const float *a, float *out)
+{
+	float a0 = a[ 0]*a[ 5] - a[ 1]*a[ 4];
+	float a1 = a[ 0]*a[ 6] - a[ 2]*a[ 4];
+	float a2 = a[ 0]*a[ 7] - a[ 3]*a[ 4];
+	float a3 = a[ 1]*a[ 6] - a[ 2]*a[ 5];
+	float a4 = a[ 1]*a[ 7] - a[ 3]*a[ 5];
+	float a5 = a[ 2]*a[ 7] - a[ 3]*a[ 6];
+	float b0 = a[ 8]*a[13] - a[ 9]*a[12];
+	float b1 = a[ 8]*a[14] - a[10]*a[12];
+	float b2 = a[ 8]*a[15] - a[11]*a[12];
+	float b3 = a[ 9]*a[14] - a[10]*a[13];
+	float b4 = a[ 9]*a[15] - a[11]*a[13];
+	float b5 = a[10]*a[15] - a[11]*a[14];
+
+	float det = a0*b5 - a1*b4 + a2*b3 + a3*b2 - a4*b1 + a5*b0;
+	if (Math::FAbs(det) < Math::EPSILON)
+		return false;
+
+	float inverse[16];
+	inverse[ 0] = + a[ 5]*b5 - a[ 6]*b4 + a[ 7]*b3;
+	inverse[ 4] = - a[ 4]*b5 + a[ 6]*b2 - a[ 7]*b1;
+	inverse[ 8] = + a[ 4]*b4 - a[ 5]*b2 + a[ 7]*b0;
+	inverse[12] = - a[ 4]*b3 + a[ 5]*b1 - a[ 6]*b0;
+	inverse[ 1] = - a[ 1]*b5 + a[ 2]*b4 - a[ 3]*b3;
+	inverse[ 5] = + a[ 0]*b5 - a[ 2]*b2 + a[ 3]*b1;
+	inverse[ 9] = - a[ 0]*b4 + a[ 1]*b2 - a[ 3]*b0;
+	inverse[13] = + a[ 0]*b3 - a[ 1]*b1 + a[ 2]*b0;
+	inverse[ 2] = + a[13]*a5 - a[14]*a4 + a[15]*a3;
+	inverse[ 6] = - a[12]*a5 + a[14]*a2 - a[15]*a1;
+	inverse[10] = + a[12]*a4 - a[13]*a2 + a[15]*a0;
+	inverse[14] = - a[12]*a3 + a[13]*a1 - a[14]*a0;
+	inverse[ 3] = - a[ 9]*a5 + a[10]*a4 - a[11]*a3;
+	inverse[ 7] = + a[ 8]*a5 - a[10]*a2 + a[11]*a1;
+	inverse[11] = - a[ 8]*a4 + a[ 9]*a2 - a[11]*a0;
+	inverse[15] = + a[ 8]*a3 - a[ 9]*a1 + a[10]*a0;
+
+	float invDet = ((float)1)/det;
+	for (int i = 0; i < 16; i++)
+		out[i] = inverse[i] * invDet;
+	return true;
+}
+
+#if defined(MTX44_SSE)
+
+#define MTX44_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MTX44_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, MTX44_SHUFFLE_MASK(x, y, z, w))
+#define MTX44_SHUFFLE(v1, v2, x, y, z, w) _mm_shuffle_ps(v1, v2, MTX44_SHUFFLE_MASK(x, y, z, w))
+
+//column = c0 * v.x + c1 * v.y + c2 * v.z + c3 * v.w
+static inline __m128 Combine(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v)
+{
+	__m128 ret = _mm_mul_ps(c0, MTX44_SWIZZLE(v, 0, 0, 0, 0));
+	ret = _mm_add_ps(ret, _mm_mul_ps(c1, MTX44_SWIZZLE(v, 1, 1, 1, 1)));
+	ret = _mm_add_ps(ret, _mm_mul_ps(c2, MTX44_SWIZZLE(v, 2, 2, 2, 2)));
+	ret = _mm_add_ps(ret, _mm_mul_ps(c3, MTX44_SWIZZLE(v, 3, 3, 3, 3)));
+	return ret;
+}
+
+void Mtx44Kernels::Multiply(const float *lhs, const float *rhs, float *out)
+{
+#if defined(MTX44_AVX)
+	//Each 256 bit register holds two result columns; the in-lane shuffles
+	//pick the matching rhs element for each half
+	__m256 c0 = _mm256_broadcast_ps((const __m128*)(lhs + 0));
+	__m256 c1 = _mm256_broadcast_ps((const __m128*)(lhs + 4));
+	__m256 c2 = _mm256_broadcast_ps((const __m128*)(lhs + 8));
+	__m256 c3 = _mm256_broadcast_ps((const __m128*)(lhs + 12));
+	__m256 r01 = _mm256_loadu_ps(rhs);
+	__m256 r23 = _mm256_loadu_ps(rhs + 8);
+
+	__m256 o01 = _mm256_mul_ps(c0, _mm256_shuffle_ps(r01, r01, 0x00));
+	o01 = _mm256_add_ps(o01, _mm256_mul_ps(c1, _mm256_shuffle_ps(r01, r01, 0x55)));
+	o01 = _mm256_add_ps(o01, _mm256_mul_ps(c2, _mm256_shuffle_ps(r01, r01, 0xAA)));
+	o01 = _mm256_add_ps(o01, _mm256_mul_ps(c3, _mm256_shuffle_ps(r01, r01, 0xFF)));
+	__m256 o23 = _mm256_mul_ps(c0, _mm256_shuffle_ps(r23, r23, 0x00));
+	o23 = _mm256_add_ps(o23, _mm256_mul_ps(c1, _mm256_shuffle_ps(r23, r23, 0x55)));
+	o23 = _mm256_add_ps(o23, _mm256_mul_ps(c2, _mm256_shuffle_ps(r23, r23, 0xAA)));
+	o23 = _mm256_add_ps(o23, _mm256_mul_ps(c3, _mm256_shuffle_ps(r23, r23, 0xFF)));
+
+	_mm256_storeu_ps(out, o01);
+	_mm256_storeu_ps(out + 8, o23);
+#else
+	__m128 c0 = _mm_loadu_ps(lhs + 0);
+	__m128 c1 = _mm_loadu_ps(lhs + 4);
+	__m128 c2 = _mm_loadu_ps(lhs + 8);
+	__m128 c3 = _mm_loadu_ps(lhs + 12);
+	__m128 o0 = Combine(c0, c1, c2, c3, _mm_loadu_ps(rhs + 0));
+	__m128 o1 = Combine(c0, c1, c2, c3, _mm_loadu_ps(rhs + 4));
+	__m128 o2 = Combine(c0, c1, c2, c3, _mm_loadu_ps(rhs + 8));
+	__m128 o3 = Combine(c0, c1, c2, c3, _mm_loadu_ps(rhs + 12));
+	_mm_storeu_ps(out + 0, o0);
+	_mm_storeu_ps(out + 4, o1);
+	_mm_storeu_ps(out + 8, o2);
+	_mm_storeu_ps(out + 12, o3);
+#endif
+}
+
+void Mtx44Kernels::Transform(const float *m, const float *v, float *out)
+{
+	__m128 ret = Combine(_mm_loadu_ps(m + 0), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12), _mm_loadu_ps(v));
+	_mm_storeu_ps(out, ret);
+}
+
+void Mtx44Kernels::Transpose(const float *m, float *out)
+{
+	__m128 c0 = _mm_loadu_ps(m + 0);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	_mm_storeu_ps(out + 0, c0);
+	_mm_storeu_ps(out + 4, c1);
+	_mm_storeu_ps(out + 8, c2);
+	_mm_storeu_ps(out + 12, c3);
+}
+
+//2x2 matrices packed as (m00, m01, m10, m11)
+//A * B
+static inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, MTX44_SWIZZLE(b, 0, 3, 0, 3)),
+		_mm_mul_ps(MTX44_SWIZZLE(a, 1, 0, 3, 2), MTX44_SWIZZLE(b, 2, 1, 2, 1)));
+}
+//adjugate(A) * B
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(MTX44_SWIZZLE(a, 3, 3, 0, 0), b),
+		_mm_mul_ps(MTX44_SWIZZLE(a, 1, 1, 2, 2), MTX44_SWIZZLE(b, 2, 3, 0, 1)));
+}
+//A * adjugate(B)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, MTX44_SWIZZLE(b, 3, 0, 3, 0)),
+		_mm_mul_ps(MTX44_SWIZZLE(a, 1, 0, 3, 2), MTX44_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+/******************************************************************************/
+/*!
+\brief
+SSE inverse by 2x2 blocks. With M = | A B |, the inverse is built from the
+                                    | C D |
+adjugates of the blocks and |M| = |A||D| + |B||C| - tr((A#B)(D#C)).
+The same steps invert either storage order, as inverse and transpose commute.
+*/
+/******************************************************************************/
+bool Mtx44Kernels::Inverse(const float *m, float *out)
+{
+	__m128 c0 = _mm_loadu_ps(m + 0);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+
+	__m128 A = _mm_movelh_ps(c0, c1);
+	__m128 B = _mm_movehl_ps(c1, c0);
+	__m128 C = _mm_movelh_ps(c2, c3);
+	__m128 D = _mm_movehl_ps(c3, c2);
+
+	//(|A|, |B|, |C|, |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(MTX44_SHUFFLE(c0, c2, 0, 2, 0, 2), MTX44_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+		_mm_mul_ps(MTX44_SHUFFLE(c0, c2, 1, 3, 1, 3), MTX44_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+	__m128 detA = MTX44_SWIZZLE(detSub, 0, 0, 0, 0);
+	__m128 detB = MTX44_SWIZZLE(detSub, 1, 1, 1, 1);
+	__m128 detC = MTX44_SWIZZLE(detSub, 2, 2, 2, 2);
+	__m128 detD = MTX44_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	__m128 D_C = Mat2AdjMul(D, C);
+	__m128 A_B = Mat2AdjMul(A, B);
+	__m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+	__m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+	__m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+	__m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+	//tr((A#B)(D#C)), summed across lanes without SSE3
+	__m128 tr = _mm_mul_ps(A_B, MTX44_SWIZZLE(D_C, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+	tr = _mm_add_ps(tr, MTX44_SWIZZLE(tr, 1, 1, 1, 1));
+	tr = MTX44_SWIZZLE(tr, 0, 0, 0, 0);
+
+	__m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+	if (Math::FAbs(_mm_cvtss_f32(detM)) < Math::EPSILON)
+		return false;
+
+	__m128 rDetM = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+	X_ = _mm_mul_ps(X_, rDetM);
+	Y_ = _mm_mul_ps(Y_, rDetM);
+	Z_ = _mm_mul_ps(Z_, rDetM);
+	W_ = _mm_mul_ps(W_, rDetM);
+
+	//Adjugate shuffle and block reassembly in one step
+	_mm_storeu_ps(out + 0, MTX44_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+	_mm_storeu_ps(out + 4, MTX44_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+	_mm_storeu_ps(out + 8, MTX44_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+	_mm_storeu_ps(out + 12, MTX44_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+	return true;
+}
+
+const char* Mtx44Kernels::InstructionSet()
+{
+#if defined(MTX44_AVX)
+	return "AVX";
+#else
+	return "SSE2";
+#endif
+}
+
+#elif defined(MTX44_NEON)
+
+void Mtx44Kernels::Multiply(const float *lhs, const float *rhs, float *out)
+{
+	float32x4_t c0 = vld1q_f32(lhs + 0);
+	float32x4_t c1 = vld1q_f32(lhs + 4);
+	float32x4_t c2 = vld1q_f32(lhs + 8);
+	float32x4_t c3 = vld1q_f32(lhs + 12);
+	float32x4_t o[4];
+	for (int i = 0; i < 4; i++)
+	{
+		float32x4_t r = vld1q_f32(rhs + i * 4);
+		o[i] = vmulq_n_f32(c0, vgetq_lane_f32(r, 0));
+		o[i] = vmlaq_n_f32(o[i], c1, vgetq_lane_f32(r, 1));
+		o[i] = vmlaq_n_f32(o[i], c2, vgetq_lane_f32(r, 2));
+		o[i] = vmlaq_n_f32(o[i], c3, vgetq_lane_f32(r, 3));
+	}
+	for (int i = 0; i < 4; i++)
+		vst1q_f32(out + i * 4, o[i]);
+}
+
+void Mtx44Kernels::Transform(const float *m, const float *v, float *out)
+{
+	float32x4_t r = vld1q_f32(v);
+	float32x4_t ret = vmulq_n_f32(vld1q_f32(m + 0), vgetq_lane_f32(r, 0));
+	ret = vmlaq_n_f32(ret, vld1q_f32(m + 4), vgetq_lane_f32(r, 1));
+	ret = vmlaq_n_f32(ret, vld1q_f32(m + 8), vgetq_lane_f32(r, 2));
+	ret = vmlaq_n_f32(ret, vld1q_f32(m + 12), vgetq_lane_f32(r, 3));
+	vst1q_f32(out, ret);
+}
+
+void Mtx44Kernels::Transpose(const float *m, float *out)
+{
+	//De-interleaving load: val[i] gathers every fourth float starting at i
+	float32x4x4_t rows = vld4q_f32(m);
+	vst1q_f32(out + 0, rows.val[0]);
+	vst1q_f32(out + 4, rows.val[1]);
+	vst1q_f32(out + 8, rows.val[2]);
+	vst1q_f32(out + 12, rows.val[3]);
+}
+
+bool Mtx44Kernels::Inverse(const float *m, float *out)
+{
+	return InverseScalar(m, out);
+}
+
+const char* Mtx44Kernels::InstructionSet()
+{
+	return "NEON";
+}
+
+#else
+
+void Mtx44Kernels::Multiply(const float *lhs, const float *rhs, float *out)
+{
+	MultiplyScalar(lhs, rhs, out);
+}
+
+void Mtx44Kernels::Transform(const float *m, const float *v, float *out)
+{
+	TransformScalar(m, v, out);
+}
+
+void Mtx44Kernels::Transpose(const float *m, float *out)
+{
+	TransposeScalar(m, out);
+}
+
+bool Mtx44Kernels::Inverse(const float *m, float *out)
+{
+	return InverseScalar(m, out);
+}
+
+const char* Mtx44Kernels::InstructionSet()
+{
+	return "Scalar";
+}
+
+#endif
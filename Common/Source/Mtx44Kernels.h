@@ -0,0 +1,48 @@
+/******************************************************************************/
+/*!
+\file	Mtx44Kernels.h
+\brief
+4 by 4 matrix kernels on column major float[16], in a scalar version and a
+SIMD version chosen at compile time: AVX when the compiler targets it
+(/arch:AVX, -mavx), else SSE2 on x86/x64, else NEON on ARM, else scalar.
+Define MTX44_NO_SIMD to force the scalar code.
+
+Kernels use unaligned loads, so they are correct for any float pointer and
+as fast as aligned loads on aligned data such as Mtx44::a.
+*/
+/******************************************************************************/
+#ifndef MTX_44_KERNELS_H
+#define MTX_44_KERNELS_H
+
+#if !defined(MTX44_NO_SIMD) && defined(__AVX__)
+#define MTX44_AVX
+#define MTX44_SSE
+#elif !defined(MTX44_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MTX44_SSE
+#elif !defined(MTX44_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM) || defined(_M_ARM64))
+#define MTX44_NEON
+#endif
+
+namespace Mtx44Kernels
+{
+	//out = lhs * rhs; out may alias either input
+	void MultiplyScalar(const float *lhs, const float *rhs, float *out);
+	void Multiply(const float *lhs, const float *rhs, float *out);
+
+	//out = m * v for a 4 component column vector; out may alias v
+	void TransformScalar(const float *m, const float *v, float *out);
+	void Transform(const float *m, const float *v, float *out);
+
+	//out may alias m
+	void TransposeScalar(const float *m, float *out);
+	void Transpose(const float *m, float *out);
+
+	//Returns false, leaving out untouched, if the determinant is within EPSILON of zero
+	bool InverseScalar(const float *m, float *out);
+	bool Inverse(const float *m, float *out);
+
+	//Name of the instruction set the non-scalar kernels were built for
+	const char* InstructionSet();
+}
+
+#endif //MTX_44_KERNELS_H
@@ -0,0 +1,271 @@
+/******************************************************************************/
+/*!
+\file	Quaternion.cpp
+\brief
+Unit quaternion for rotations that compose and interpolate without gimbal lock
+*/
+/******************************************************************************/
+#include <cmath>
+#include "Quaternion.h"
+
+/******************************************************************************/
+/*!
+\brief	Quaternion constructor, identity by default
+
+\param	w
+	real part
+\param	x
+	i component
+\param	y
+	j component
+\param	z
+	k component
+*/
+/******************************************************************************/
+Quaternion::Quaternion(float w, float x, float y, float z) : w(w), x(x), y(y), z(z)
+{
+}
+
+/******************************************************************************/
+/*!
+\brief	Set this quaternion to no rotation
+*/
+/******************************************************************************/
+void Quaternion::SetToIdentity( void )
+{
+	w = 1;
+	x = y = z = 0;
+}
+
+/******************************************************************************/
+/*!
+\brief	Set this quaternion to a rotation about an axis
+
+\param	degrees
+	Angle of rotation, in degrees
+\param	axisX
+	X-component of the rotation axis
+\param	axisY
+	Y-component of the rotation axis
+\param	axisZ
+	Z-component of the rotation axis
+\exception DivideByZero
+	thrown if the axis is a zero vector
+*/
+/******************************************************************************/
+void Quaternion::SetToRotation( float degrees, float axisX, float axisY, float axisZ )
+{
+	float mag = sqrt(axisX * axisX + axisY * axisY + axisZ * axisZ);
+	if(mag < Math::EPSILON)
+		throw DivideByZero();
+	float halfAngle = Math::DegreeToRadian(degrees) * 0.5f;
+	float s = sin(halfAngle) / mag;
+	w = cos(halfAngle);
+	x = axisX * s;
+	y = axisY * s;
+	z = axisZ * s;
+}
+
+/******************************************************************************/
+/*!
+\brief	Compose two rotations, rhs is applied first
+
+\param	rhs
+	Rotation applied before this one
+\return
+	The combined rotation
+*/
+/******************************************************************************/
+Quaternion Quaternion::operator*( const Quaternion& rhs ) const
+{
+	return Quaternion(
+		w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z,
+		w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+		w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+		w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w);
+}
+
+Quaternion& Quaternion::operator*=( const Quaternion& rhs )
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+/******************************************************************************/
+/*!
+\brief	Rotate a vector by this unit quaternion
+
+\param	rhs
+	Vector to rotate
+\return
+	Rotated vector
+*/
+/******************************************************************************/
+Vector3 Quaternion::operator*( const Vector3& rhs ) const
+{
+	//v' = v + 2w(q x v) + 2q x (q x v), with q the vector part
+	float tx = 2 * (y * rhs.z - z * rhs.y);
+	float ty = 2 * (z * rhs.x - x * rhs.z);
+	float tz = 2 * (x * rhs.y - y * rhs.x);
+	return Vector3(
+		rhs.x + w * tx + (y * tz - z * ty),
+		rhs.y + w * ty + (z * tx - x * tz),
+		rhs.z + w * tz + (x * ty - y * tx));
+}
+
+float Quaternion::Dot( const Quaternion& rhs ) const
+{
+	return w * rhs.w + x * rhs.x + y * rhs.y + z * rhs.z;
+}
+
+float Quaternion::LengthSquared( void ) const
+{
+	return Dot(*this);
+}
+
+Quaternion Quaternion::Conjugate( void ) const
+{
+	return Quaternion(w, -x, -y, -z);
+}
+
+/******************************************************************************/
+/*!
+\brief	Return a copy of this quaternion with unit length
+
+\exception DivideByZero
+	thrown if normalizing a zero quaternion
+\return
+	Normalized copy
+*/
+/******************************************************************************/
+Quaternion Quaternion::Normalized( void ) const
+{
+	Quaternion ret(*this);
+	return ret.Normalize();
+}
+
+/******************************************************************************/
+/*!
+\brief	Normalize this quaternion and return a reference to it
+
+\exception DivideByZero
+	thrown if normalizing a zero quaternion
+\return
+	Reference to this quaternion
+*/
+/******************************************************************************/
+Quaternion& Quaternion::Normalize( void )
+{
+	float d = sqrt(LengthSquared());
+	if(d <= Math::EPSILON)
+		throw DivideByZero();
+	float invD = 1.0f / d;
+	w *= invD;
+	x *= invD;
+	y *= invD;
+	z *= invD;
+	return *this;
+}
+
+/******************************************************************************/
+/*!
+\brief	Return the rotation matrix of this unit quaternion, no trig involved
+
+\return
+	A new matrix
+*/
+/******************************************************************************/
+Mtx44 Quaternion::GetMatrix( void ) const
+{
+	float xx = x * x, yy = y * y, zz = z * z;
+	float xy = x * y, xz = x * z, yz = y * z;
+	float wx = w * x, wy = w * y, wz = w * z;
+	return Mtx44(1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+		2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+		2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+		0, 0, 0, 1);
+}
+
+/******************************************************************************/
+/*!
+\brief	Spherical linear interpolation along the shorter arc
+
+\param	from
+	Rotation at t = 0
+\param	to
+	Rotation at t = 1
+\param	t
+	Interpolation factor
+\return
+	Interpolated unit quaternion
+*/
+/******************************************************************************/
+Quaternion Quaternion::Slerp( const Quaternion& from, const Quaternion& to, float t )
+{
+	float cosAngle = from.Dot(to);
+	float sign = 1;
+	if(cosAngle < 0) {
+		cosAngle = -cosAngle;
+		sign = -1;
+	}
+
+	//Nearly parallel, sin(angle) is too small to divide by
+	if(cosAngle > 0.9995f)
+		return Nlerp(from, to, t);
+
+	float angle = acos(cosAngle);
+	float invSin = 1.0f / sin(angle);
+	float a = sin((1 - t) * angle) * invSin;
+	float b = sign * sin(t * angle) * invSin;
+	return Quaternion(
+		a * from.w + b * to.w,
+		a * from.x + b * to.x,
+		a * from.y + b * to.y,
+		a * from.z + b * to.z);
+}
+
+/******************************************************************************/
+/*!
+\brief	Normalized linear interpolation along the shorter arc
+
+\param	from
+	Rotation at t = 0
+\param	to
+	Rotation at t = 1
+\param	t
+	Interpolation factor
+\return
+	Interpolated unit quaternion, from if the blend cancels out
+*/
+/******************************************************************************/
+Quaternion Quaternion::Nlerp( const Quaternion& from, const Quaternion& to, float t )
+{
+	float b = from.Dot(to) < 0 ? -t : t;
+	float a = 1 - t;
+	Quaternion ret(
+		a * from.w + b * to.w,
+		a * from.x + b * to.x,
+		a * from.y + b * to.y,
+		a * from.z + b * to.z);
+	float lengthSquared = ret.LengthSquared();
+	if(lengthSquared <= Math::EPSILON)
+		return from;
+	float invLength = 1.0f / sqrt(lengthSquared);
+	ret.w *= invLength;
+	ret.x *= invLength;
+	ret.y *= invLength;
+	ret.z *= invLength;
+	return ret;
+}
+
+void Quaternion::Slerp( const Quaternion *from, const Quaternion *to, float t, Quaternion *out, unsigned count )
+{
+	for(unsigned i = 0; i < count; ++i)
+		out[i] = Slerp(from[i], to[i], t);
+}
+
+void Quaternion::Nlerp( const Quaternion *from, const Quaternion *to, float t, Quaternion *out, unsigned count )
+{
+	for(unsigned i = 0; i < count; ++i)
+		out[i] = Nlerp(from[i], to[i], t);
+}
@@ -0,0 +1,57 @@
+/******************************************************************************/
+/*!
+\file	Quaternion.h
+\brief
+Unit quaternion for rotations that compose and interpolate without gimbal lock
+*/
+/******************************************************************************/
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+#include "MyMath.h"
+#include "Vector3.h"
+#include "Mtx44.h"
+
+/******************************************************************************/
+/*!
+		Class Quaternion:
+\brief	Rotation stored as w + xi + yj + zk. q1 * q2 rotates by q2 first,
+		then q1, the same order as Mtx44 products.
+*/
+/******************************************************************************/
+struct Quaternion
+{
+	float w, x, y, z;
+
+	Quaternion(float w = 1, float x = 0, float y = 0, float z = 0);
+
+	void SetToIdentity( void );
+	//Same convention as Mtx44::SetToRotation
+	//Throw a divide by zero exception if the axis is a zero vector
+	void SetToRotation( float degrees, float axisX, float axisY, float axisZ );
+
+	Quaternion operator*( const Quaternion& rhs ) const; //Composition
+	Quaternion& operator*=( const Quaternion& rhs );
+	Vector3 operator*( const Vector3& rhs ) const; //Rotate a vector
+
+	float Dot( const Quaternion& rhs ) const;
+	float LengthSquared( void ) const;
+	Quaternion Conjugate( void ) const; //Inverse of a unit quaternion
+
+	//Throw a divide by zero exception if normalizing a zero quaternion
+	Quaternion Normalized( void ) const;
+	Quaternion& Normalize( void );
+
+	Mtx44 GetMatrix( void ) const; //Rotation matrix of a unit quaternion
+
+	//Interpolate along the shorter arc. Slerp keeps a constant angular speed,
+	//Nlerp is cheaper and is close enough for blending nearby poses.
+	static Quaternion Slerp( const Quaternion& from, const Quaternion& to, float t );
+	static Quaternion Nlerp( const Quaternion& from, const Quaternion& to, float t );
+
+	//Blend count rotations, e.g. every bone of two poses, by the same t
+	static void Slerp( const Quaternion *from, const Quaternion *to, float t, Quaternion *out, unsigned count );
+	static void Nlerp( const Quaternion *from, const Quaternion *to, float t, Quaternion *out, unsigned count );
+};
+
+#endif //QUATERNION_H
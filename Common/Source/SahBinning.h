@@ -0,0 +1,120 @@
+/******************************************************************************/
+/*!
+\file	SahBinning.h
+\brief
+Binned surface area heuristic split search, shared by the tree builders
+*/
+/******************************************************************************/
+#ifndef SAH_BINNING_H
+#define SAH_BINNING_H
+
+#include <cfloat>
+#include <algorithm>
+#include "Bounds.h"
+
+//Splits are chosen among this many bins per axis
+const unsigned SAH_BINS = 16;
+
+inline float CenterOf(const AABB &bounds, int axis)
+{
+	return ((&bounds.min.x)[axis] + (&bounds.max.x)[axis]) * 0.5f;
+}
+
+/******************************************************************************/
+/*!
+		Struct SahSplit:
+\brief	Where FindSahSplit cuts a range: the boxes whose centers fall in a
+		bin below bin go left. axis is -1 when no split separates them,
+		such as when every center is in one place.
+*/
+/******************************************************************************/
+struct SahSplit
+{
+	int axis;
+	unsigned bin;
+	float lo, scale; //Bin of a center is (center - lo) * scale
+
+	SahSplit() : axis(-1), bin(0), lo(0), scale(0) {}
+
+	unsigned BinOf( const AABB& bounds ) const
+	{
+		return std::min((unsigned)((CenterOf(bounds, axis) - lo) * scale), SAH_BINS - 1);
+	}
+	bool IsLeft( const AABB& bounds ) const
+	{
+		return BinOf(bounds) < bin;
+	}
+};
+
+/******************************************************************************/
+/*!
+\brief
+Bin the box centers along each axis and take the split with the lowest
+area times count on both sides
+
+\param centers - box of the centers of the count boxes
+\param count - number of boxes
+\param boxAt - boxAt(i) gives box i, for i below count
+
+\return The best split, or one with axis -1
+*/
+/******************************************************************************/
+template<typename BoxAt>
+SahSplit FindSahSplit( const AABB& centers, unsigned count, const BoxAt& boxAt )
+{
+	SahSplit best;
+	float bestCost = FLT_MAX;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		SahSplit split;
+		split.axis = axis;
+		split.lo = (&centers.min.x)[axis];
+		float hi = (&centers.max.x)[axis];
+		if (hi <= split.lo)
+			continue;
+		split.scale = SAH_BINS / (hi - split.lo);
+
+		AABB binBounds[SAH_BINS];
+		unsigned binCount[SAH_BINS] = {};
+		for (unsigned i = 0; i < count; ++i)
+		{
+			const AABB &bounds = boxAt(i);
+			unsigned bin = split.BinOf(bounds);
+			binBounds[bin].Expand(bounds);
+			++binCount[bin];
+		}
+
+		//Area and count of everything right of each split, swept from the right
+		float rightArea[SAH_BINS];
+		unsigned rightCount[SAH_BINS];
+		AABB right;
+		unsigned rightTotal = 0;
+		for (unsigned bin = SAH_BINS - 1; bin > 0; --bin)
+		{
+			right.Expand(binBounds[bin]);
+			rightTotal += binCount[bin];
+			rightArea[bin] = right.SurfaceArea();
+			rightCount[bin] = rightTotal;
+		}
+
+		AABB left;
+		unsigned leftTotal = 0;
+		for (unsigned bin = 1; bin < SAH_BINS; ++bin)
+		{
+			left.Expand(binBounds[bin - 1]);
+			leftTotal += binCount[bin - 1];
+			if (leftTotal == 0 || rightCount[bin] == 0)
+				continue;
+			float cost = left.SurfaceArea() * leftTotal + rightArea[bin] * rightCount[bin];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				best = split;
+				best.bin = bin;
+			}
+		}
+	}
+	return best;
+}
+
+#endif //SAH_BINNING_H
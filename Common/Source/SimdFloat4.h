@@ -0,0 +1,82 @@
+/******************************************************************************/
+/*!
+\file	SimdFloat4.h
+\brief
+Four float lanes on the SIMD instruction set Mtx44Kernels.h picked, with a
+scalar struct of the same operations when there is none
+*/
+/******************************************************************************/
+#ifndef SIMD_FLOAT4_H
+#define SIMD_FLOAT4_H
+
+#include "Mtx44Kernels.h"
+
+#if defined(MTX44_SSE)
+#include <immintrin.h>
+#elif defined(MTX44_NEON)
+#include <arm_neon.h>
+#endif
+
+//Comparisons give a mask with the sign bit of each passing lane set;
+//MoveMask4 packs those into 4 bits. SIMD_FLOAT4_NATIVE is defined when the
+//lanes are real vector registers, for code that only pays off then.
+#if defined(MTX44_SSE)
+#define SIMD_FLOAT4_NATIVE
+typedef __m128 Float4;
+inline Float4 Load4(const float *p) { return _mm_loadu_ps(p); }
+inline void Store4(float *p, Float4 a) { _mm_storeu_ps(p, a); }
+inline Float4 Splat4(float f) { return _mm_set1_ps(f); }
+inline Float4 Add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 Min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 Max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 Less4(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 LessEqual4(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+inline Float4 And4(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline int MoveMask4(Float4 mask) { return _mm_movemask_ps(mask); }
+#elif defined(MTX44_NEON)
+#define SIMD_FLOAT4_NATIVE
+typedef float32x4_t Float4;
+inline Float4 Load4(const float *p) { return vld1q_f32(p); }
+inline void Store4(float *p, Float4 a) { vst1q_f32(p, a); }
+inline Float4 Splat4(float f) { return vdupq_n_f32(f); }
+inline Float4 Add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 Min4(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 Max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 Less4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4 LessEqual4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline Float4 And4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline int MoveMask4(Float4 mask)
+{
+	uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+	return vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) << 1 | vgetq_lane_u32(bits, 2) << 2 | vgetq_lane_u32(bits, 3) << 3;
+}
+#else
+struct Float4
+{
+	float v[4];
+};
+inline Float4 Load4(const float *p) { Float4 r = { { p[0], p[1], p[2], p[3] } }; return r; }
+inline void Store4(float *p, Float4 a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+inline Float4 Splat4(float f) { Float4 r = { { f, f, f, f } }; return r; }
+#define SIMD_FLOAT4_LANEWISE(name, expression) \
+	inline Float4 name(Float4 a, Float4 b) { Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = expression; return r; }
+SIMD_FLOAT4_LANEWISE(Add4, a.v[i] + b.v[i])
+SIMD_FLOAT4_LANEWISE(Sub4, a.v[i] - b.v[i])
+SIMD_FLOAT4_LANEWISE(Mul4, a.v[i] * b.v[i])
+SIMD_FLOAT4_LANEWISE(Min4, a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+SIMD_FLOAT4_LANEWISE(Max4, a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+SIMD_FLOAT4_LANEWISE(Less4, a.v[i] < b.v[i] ? -1.f : 0.f)
+SIMD_FLOAT4_LANEWISE(LessEqual4, a.v[i] <= b.v[i] ? -1.f : 0.f)
+SIMD_FLOAT4_LANEWISE(And4, a.v[i] < 0 && b.v[i] < 0 ? -1.f : 0.f)
+#undef SIMD_FLOAT4_LANEWISE
+inline int MoveMask4(Float4 mask)
+{
+	return (mask.v[0] < 0) | (mask.v[1] < 0) << 1 | (mask.v[2] < 0) << 2 | (mask.v[3] < 0) << 3;
+}
+#endif
+
+#endif //SIMD_FLOAT4_H
@@ -0,0 +1,114 @@
+/******************************************************************************/
+/*!
+\file	Skeleton.cpp
+\brief
+Joint hierarchy with a bind pose, turning poses into the joint matrix
+palette a skinned mesh is drawn with
+*/
+/******************************************************************************/
+#include <cassert>
+#include "Skeleton.h"
+
+const unsigned Skeleton::MAX_JOINTS;
+const unsigned Skeleton::NO_JOINT;
+
+Skeleton::Skeleton()
+{
+}
+
+Skeleton::~Skeleton()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Add a joint after its parent, working out its bind world matrix and the
+inverse of it once here
+
+\param name - for FindJoint
+\param parent - index of an earlier joint, or NO_JOINT
+\param bindLocal - bind pose relative to the parent
+
+\return Index of the joint
+*/
+/******************************************************************************/
+unsigned Skeleton::AddJoint( const std::string& name, unsigned parent, const Transform& bindLocal )
+{
+	assert(m_names.size() < MAX_JOINTS);
+	assert(parent == NO_JOINT || parent < m_names.size());
+
+	Mtx44 world = bindLocal.GetMatrix();
+	if (parent != NO_JOINT)
+		world = m_bindWorld[parent] * world;
+
+	m_names.push_back(name);
+	m_parents.push_back(parent);
+	m_bindPose.push_back(bindLocal);
+	m_bindWorld.push_back(world);
+	m_inverseBind.push_back(world.GetInverse());
+	return m_names.size() - 1;
+}
+
+void Skeleton::Clear( void )
+{
+	m_names.clear();
+	m_parents.clear();
+	m_bindPose.clear();
+	m_bindWorld.clear();
+	m_inverseBind.clear();
+}
+
+unsigned Skeleton::GetJointCount( void ) const
+{
+	return m_names.size();
+}
+
+unsigned Skeleton::FindJoint( const std::string& name ) const
+{
+	for (unsigned i = 0; i < m_names.size(); ++i)
+	{
+		if (m_names[i] == name)
+			return i;
+	}
+	return NO_JOINT;
+}
+
+unsigned Skeleton::GetParent( unsigned joint ) const
+{
+	return m_parents[joint];
+}
+
+const Pose& Skeleton::GetBindPose( void ) const
+{
+	return m_bindPose;
+}
+
+const Mtx44& Skeleton::GetBindWorld( unsigned joint ) const
+{
+	return m_bindWorld[joint];
+}
+
+/******************************************************************************/
+/*!
+\brief
+World matrices of the posed joints, parents first, each multiplied by its
+inverse bind matrix
+
+\param pose - local transform of every joint
+\param palette - GetJointCount() matrices, model space to model space
+*/
+/******************************************************************************/
+void Skeleton::ComputePalette( const Pose& pose, Mtx44 *palette ) const
+{
+	assert(pose.size() == m_names.size());
+
+	Mtx44 world[MAX_JOINTS];
+	for (unsigned i = 0; i < m_names.size(); ++i)
+	{
+		world[i] = pose[i].GetMatrix();
+		if (m_parents[i] != NO_JOINT)
+			world[i] = world[m_parents[i]] * world[i];
+		palette[i] = world[i] * m_inverseBind[i];
+	}
+}
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*!
+\file	Skeleton.h
+\brief
+Joint hierarchy with a bind pose, turning poses into the joint matrix
+palette a skinned mesh is drawn with
+*/
+/******************************************************************************/
+#ifndef SKELETON_H
+#define SKELETON_H
+
+#include <string>
+#include <vector>
+#include "Transform.h"
+
+//Local transform of every joint of a skeleton, by joint index
+typedef std::vector<Transform> Pose;
+
+/******************************************************************************/
+/*!
+		Class Skeleton:
+\brief	Joints in parent first order, each with its bind pose relative to
+		its parent. The bind pose is the one the skinned mesh was modelled
+		in, so a joint's palette matrix takes a vertex from bind pose model
+		space to where the joint has moved it: the joint's posed world
+		matrix times the inverse of its bind world matrix.
+*/
+/******************************************************************************/
+class Skeleton
+{
+public:
+	//The size of the palette uniform block in the shader
+	static const unsigned MAX_JOINTS = 32;
+	static const unsigned NO_JOINT = 0xFFFFFFFF;
+
+	Skeleton();
+	~Skeleton();
+
+	//parent must already be added, or NO_JOINT for a root
+	unsigned AddJoint( const std::string& name, unsigned parent, const Transform& bindLocal );
+	void Clear( void );
+
+	unsigned GetJointCount( void ) const;
+	unsigned FindJoint( const std::string& name ) const; //NO_JOINT if none
+	unsigned GetParent( unsigned joint ) const;
+	const Pose& GetBindPose( void ) const;
+	const Mtx44& GetBindWorld( unsigned joint ) const; //Joint to model space in the bind pose
+
+	//palette[i] for each joint i, from a pose of GetJointCount() joints
+	void ComputePalette( const Pose& pose, Mtx44 *palette ) const;
+
+private:
+	std::vector<std::string> m_names;
+	std::vector<unsigned> m_parents;
+	Pose m_bindPose;
+	std::vector<Mtx44> m_bindWorld;
+	std::vector<Mtx44> m_inverseBind;
+};
+
+#endif //SKELETON_H
@@ -0,0 +1,123 @@
+/******************************************************************************/
+/*!
+\file	Transform.cpp
+\brief
+Translation, rotation and scale of a node in a transform hierarchy
+*/
+/******************************************************************************/
+#include "Transform.h"
+
+/******************************************************************************/
+/*!
+\brief	Transform default constructor, the identity
+*/
+/******************************************************************************/
+Transform::Transform() : translation(0, 0, 0), rotation(), scale(1, 1, 1)
+{
+}
+
+/******************************************************************************/
+/*!
+\brief	Transform constructor
+
+\param	translation
+	Offset applied last
+\param	rotation
+	Unit quaternion applied after scale
+\param	scale
+	Scale along each axis, applied first
+*/
+/******************************************************************************/
+Transform::Transform(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale)
+	: translation(translation), rotation(rotation), scale(scale)
+{
+}
+
+void Transform::SetToIdentity( void )
+{
+	translation.SetZero();
+	rotation.SetToIdentity();
+	scale.Set(1, 1, 1);
+}
+
+/******************************************************************************/
+/*!
+\brief	Compose a parent with a child transform
+
+\param	rhs
+	Child transform, expressed in this transform's space
+\return
+	The child's transform in this transform's parent space
+*/
+/******************************************************************************/
+Transform Transform::operator*( const Transform& rhs ) const
+{
+	Vector3 scaled(scale.x * rhs.translation.x, scale.y * rhs.translation.y, scale.z * rhs.translation.z);
+	return Transform(translation + rotation * scaled,
+		rotation * rhs.rotation,
+		Vector3(scale.x * rhs.scale.x, scale.y * rhs.scale.y, scale.z * rhs.scale.z));
+}
+
+/******************************************************************************/
+/*!
+\brief	Transform a point
+
+\param	rhs
+	Point to transform
+\return
+	Transformed point
+*/
+/******************************************************************************/
+Vector3 Transform::operator*( const Vector3& rhs ) const
+{
+	return translation + rotation * Vector3(scale.x * rhs.x, scale.y * rhs.y, scale.z * rhs.z);
+}
+
+/******************************************************************************/
+/*!
+\brief	Return the equivalent matrix, translate * rotate * scale
+
+\return
+	A new matrix
+*/
+/******************************************************************************/
+Mtx44 Transform::GetMatrix( void ) const
+{
+	Mtx44 ret = rotation.GetMatrix();
+	for(int i = 0; i < 4; i++) {
+		ret.a[0 + i] *= scale.x;
+		ret.a[4 + i] *= scale.y;
+		ret.a[8 + i] *= scale.z;
+	}
+	ret.a[12] = translation.x;
+	ret.a[13] = translation.y;
+	ret.a[14] = translation.z;
+	return ret;
+}
+
+/******************************************************************************/
+/*!
+\brief	Blend two transforms
+
+\param	from
+	Transform at t = 0
+\param	to
+	Transform at t = 1
+\param	t
+	Interpolation factor
+\return
+	Interpolated transform
+*/
+/******************************************************************************/
+Transform Transform::Lerp( const Transform& from, const Transform& to, float t )
+{
+	return Transform(from.translation + (to.translation - from.translation) * t,
+		Quaternion::Nlerp(from.rotation, to.rotation, t),
+		from.scale + (to.scale - from.scale) * t);
+}
+
+void Transform::Lerp( const Transform *from, const Transform *to, float t, Transform *out, unsigned count )
+{
+	for(unsigned i = 0; i < count; ++i)
+		out[i] = Lerp(from[i], to[i], t);
+}
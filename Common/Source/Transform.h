@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file	Transform.h
+\brief
+Translation, rotation and scale of a node in a transform hierarchy
+*/
+/******************************************************************************/
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Mtx44.h"
+
+/******************************************************************************/
+/*!
+		Class Transform:
+\brief	Scale, then rotate, then translate; the same as
+		MS::Translate, MS::Rotate, MS::Scale called in that order.
+		parent * child composes like the matrix stack. A non-uniform parent
+		scale on a rotated child would need shear, which this type cannot hold;
+		the scales are multiplied per axis instead, as animation systems do.
+*/
+/******************************************************************************/
+struct Transform
+{
+	Vector3 translation;
+	Quaternion rotation;
+	Vector3 scale;
+
+	Transform();
+	Transform(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale = Vector3(1, 1, 1));
+
+	void SetToIdentity( void );
+
+	Transform operator*( const Transform& rhs ) const; //Composition, rhs is the child
+	Vector3 operator*( const Vector3& rhs ) const; //Transform a point
+
+	Mtx44 GetMatrix( void ) const;
+
+	//Lerp translation and scale, Nlerp rotation
+	static Transform Lerp( const Transform& from, const Transform& to, float t );
+	static void Lerp( const Transform *from, const Transform *to, float t, Transform *out, unsigned count );
+};
+
+#endif //TRANSFORM_H
@@ -0,0 +1,555 @@
+/******************************************************************************/
+/*!
+\file	TriangleBvh.cpp
+\brief
+Static bounding volume hierarchy over the triangles of one mesh, for ray
+picking and capsule sweeps against the real geometry
+*/
+/******************************************************************************/
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include "TriangleBvh.h"
+#include "SimdFloat4.h"
+#include "SahBinning.h"
+
+const unsigned TriangleBvh::NO_TRIANGLE;
+
+//Deeper ranges are split at the median, so the tree is at most 32 levels
+//deeper still and traversal fits a fixed stack
+static const unsigned MAX_DEPTH = 48;
+static const unsigned STACK_SIZE = MAX_DEPTH + 32;
+//Four triangles, one packet, per leaf
+static const unsigned LEAF_SIZE = 4;
+//A capsule this close to a triangle is touching it
+static const float CONTACT_SKIN = 0.01f;
+//Conservative advancement steps before a sweep settles for where it got to
+static const unsigned MAX_SWEEP_STEPS = 32;
+
+static const AABB EMPTY_BOUNDS;
+
+//Ericson, Real-Time Collision Detection 5.1.5: the triangle's nearest point
+//to p, found by which Voronoi region of the triangle p lies in
+static Vector3 ClosestPointOnTriangle(const Vector3 &p, const Vector3 &a, const Vector3 &b, const Vector3 &c)
+{
+	Vector3 ab = b - a, ac = c - a, ap = p - a;
+	float d1 = ab.Dot(ap), d2 = ac.Dot(ap);
+	if (d1 <= 0 && d2 <= 0)
+		return a;
+
+	Vector3 bp = p - b;
+	float d3 = ab.Dot(bp), d4 = ac.Dot(bp);
+	if (d3 >= 0 && d4 <= d3)
+		return b;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0 && d1 >= 0 && d3 <= 0)
+		return a + ab * (d1 / (d1 - d3));
+
+	Vector3 cp = p - c;
+	float d5 = ab.Dot(cp), d6 = ac.Dot(cp);
+	if (d6 >= 0 && d5 <= d6)
+		return c;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0)
+		return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	float denom = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//Ericson 5.1.9: nearest points of segments p1-q1 and p2-q2
+static void ClosestPointsOnSegments(const Vector3 &p1, const Vector3 &q1, const Vector3 &p2, const Vector3 &q2,
+	Vector3 &c1, Vector3 &c2)
+{
+	static const float TINY = Math::EPSILON * Math::EPSILON;
+	Vector3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+	float a = d1.Dot(d1), e = d2.Dot(d2), f = d2.Dot(r);
+	float s = 0, t = 0;
+	if (a <= TINY && e <= TINY)
+	{
+	}
+	else if (a <= TINY)
+	{
+		t = Math::Clamp(f / e, 0.f, 1.f);
+	}
+	else
+	{
+		float c = d1.Dot(r);
+		if (e <= TINY)
+		{
+			s = Math::Clamp(-c / a, 0.f, 1.f);
+		}
+		else
+		{
+			float b = d1.Dot(d2);
+			float denom = a * e - b * b;
+			s = denom > 0 ? Math::Clamp((b * f - c * e) / denom, 0.f, 1.f) : 0;
+			t = (b * s + f) / e;
+			if (t < 0)
+			{
+				t = 0;
+				s = Math::Clamp(-c / a, 0.f, 1.f);
+			}
+			else if (t > 1)
+			{
+				t = 1;
+				s = Math::Clamp((b - c) / a, 0.f, 1.f);
+			}
+		}
+	}
+	c1 = p1 + d1 * s;
+	c2 = p2 + d2 * t;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Squared distance between segment p-q and triangle a-b-c. Unless the segment
+crosses the triangle, the nearest points pair an end of the segment with the
+triangle or the segment with an edge, so those five cases cover it.
+
+\param onSegment - set to the segment's nearest point
+\param onTriangle - set to the triangle's nearest point
+
+\return Squared distance, 0 if they intersect
+*/
+/******************************************************************************/
+static float SegmentTriangleDistanceSquared(const Vector3 &p, const Vector3 &q,
+	const Vector3 &a, const Vector3 &b, const Vector3 &c, Vector3 &onSegment, Vector3 &onTriangle)
+{
+	//Moller-Trumbore with the segment as a ray of length 1
+	Vector3 d = q - p, e1 = b - a, e2 = c - a;
+	Vector3 pvec = d.Cross(e2);
+	float det = e1.Dot(pvec);
+	if (det != 0)
+	{
+		float inv = 1.0f / det;
+		Vector3 tvec = p - a;
+		float u = tvec.Dot(pvec) * inv;
+		Vector3 qvec = tvec.Cross(e1);
+		float v = d.Dot(qvec) * inv;
+		float t = e2.Dot(qvec) * inv;
+		if (u >= 0 && v >= 0 && u + v <= 1 && t >= 0 && t <= 1)
+		{
+			onSegment = onTriangle = p + d * t;
+			return 0;
+		}
+	}
+
+	float best = FLT_MAX;
+	Vector3 s, tri;
+	const Vector3 *ends[2] = { &p, &q };
+	for (int i = 0; i < 2; ++i)
+	{
+		tri = ClosestPointOnTriangle(*ends[i], a, b, c);
+		float distance = (*ends[i] - tri).LengthSquared();
+		if (distance < best)
+		{
+			best = distance;
+			onSegment = *ends[i];
+			onTriangle = tri;
+		}
+	}
+	const Vector3 *edges[3][2] = { { &a, &b }, { &b, &c }, { &c, &a } };
+	for (int i = 0; i < 3; ++i)
+	{
+		ClosestPointsOnSegments(p, q, *edges[i][0], *edges[i][1], s, tri);
+		float distance = (s - tri).LengthSquared();
+		if (distance < best)
+		{
+			best = distance;
+			onSegment = s;
+			onTriangle = tri;
+		}
+	}
+	return best;
+}
+
+TriangleBvh::TriangleBvh()
+{
+}
+
+TriangleBvh::~TriangleBvh()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Build the tree over a triangle list; triangles whose corners are out of
+range are dropped
+
+\param positions - vertex positions
+\param vertexCount - number of positions
+\param indices - three per triangle
+\param indexCount - multiple of 3
+*/
+/******************************************************************************/
+void TriangleBvh::Build( const Vector3 *positions, unsigned vertexCount, const unsigned *indices, unsigned indexCount )
+{
+	assert(indexCount % 3 == 0);
+	Clear();
+
+	std::vector<AABB> boxes;
+	m_corners.reserve(indexCount);
+	boxes.reserve(indexCount / 3);
+	for (unsigned i = 0; i + 2 < indexCount; i += 3)
+	{
+		if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+			continue;
+		AABB box;
+		for (unsigned j = 0; j < 3; ++j)
+		{
+			m_corners.push_back(positions[indices[i + j]]);
+			box.Expand(positions[indices[i + j]]);
+		}
+		boxes.push_back(box);
+	}
+	if (boxes.empty())
+		return;
+
+	std::vector<unsigned> triangles(boxes.size());
+	for (unsigned i = 0; i < triangles.size(); ++i)
+	{
+		triangles[i] = i;
+	}
+	//A full binary tree with leaves of one to four triangles
+	m_nodes.reserve(2 * (triangles.size() + LEAF_SIZE - 1) / LEAF_SIZE);
+	BuildRange(&triangles[0], triangles.size(), &boxes[0], 0);
+}
+
+void TriangleBvh::Clear( void )
+{
+	m_nodes.clear();
+	m_packets.clear();
+	m_corners.clear();
+}
+
+unsigned TriangleBvh::GetTriangleCount( void ) const
+{
+	return m_corners.size() / 3;
+}
+
+void TriangleBvh::GetTriangle( unsigned triangle, Vector3 &a, Vector3 &b, Vector3 &c ) const
+{
+	assert(triangle < GetTriangleCount());
+	a = m_corners[triangle * 3];
+	b = m_corners[triangle * 3 + 1];
+	c = m_corners[triangle * 3 + 2];
+}
+
+const AABB& TriangleBvh::GetBounds( void ) const
+{
+	return m_nodes.empty() ? EMPTY_BOUNDS : m_nodes[0].bounds;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Split the range by the binned surface area heuristic and recurse, writing
+the node before its subtrees so the left child always follows it
+
+\param triangles - triangle indices, reordered in place
+\param count - at least 1
+\param boxes - box of each triangle
+\param depth - of the node, 0 at the root
+
+\return Index of the node
+*/
+/******************************************************************************/
+unsigned TriangleBvh::BuildRange( unsigned *triangles, unsigned count, const AABB *boxes, unsigned depth )
+{
+	unsigned node = m_nodes.size();
+	m_nodes.push_back(Node());
+	AABB bounds, centers;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		bounds.Expand(boxes[triangles[i]]);
+		centers.Expand(boxes[triangles[i]].Center());
+	}
+	m_nodes[node].bounds = bounds;
+
+	if (count <= LEAF_SIZE)
+	{
+		Packet packet = {};
+		for (unsigned lane = 0; lane < LEAF_SIZE; ++lane)
+		{
+			packet.triangle[lane] = NO_TRIANGLE;
+			if (lane >= count)
+				continue;
+			const Vector3 *corner = &m_corners[triangles[lane] * 3];
+			Vector3 e1 = corner[1] - corner[0], e2 = corner[2] - corner[0];
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				packet.corner[axis][lane] = (&corner[0].x)[axis];
+				packet.edge1[axis][lane] = (&e1.x)[axis];
+				packet.edge2[axis][lane] = (&e2.x)[axis];
+			}
+			packet.triangle[lane] = triangles[lane];
+		}
+		m_nodes[node].right = 0;
+		m_nodes[node].packet = m_packets.size();
+		m_packets.push_back(packet);
+		return node;
+	}
+
+	SahSplit split;
+	if (depth < MAX_DEPTH)
+		split = FindSahSplit(centers, count, [&](unsigned i) -> const AABB& { return boxes[triangles[i]]; });
+
+	unsigned middle;
+	if (split.axis < 0)
+	{
+		//Too deep, or every center in one place: halve along the widest axis
+		Vector3 extent = centers.max - centers.min;
+		int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+		middle = count / 2;
+		std::nth_element(triangles, triangles + middle, triangles + count, [&](unsigned a, unsigned b) {
+			return CenterOf(boxes[a], axis) < CenterOf(boxes[b], axis);
+		});
+	}
+	else
+	{
+		middle = std::partition(triangles, triangles + count, [&](unsigned triangle) {
+			return split.IsLeft(boxes[triangle]);
+		}) - triangles;
+	}
+
+	BuildRange(triangles, middle, boxes, depth + 1);
+	unsigned right = BuildRange(triangles + middle, count - middle, boxes, depth + 1);
+	m_nodes[node].right = right;
+	m_nodes[node].packet = NO_TRIANGLE;
+	return node;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Nearest first walk, testing each leaf's four triangles in one pass. The
+Moller-Trumbore terms are compared multiplied by the determinant instead
+of divided by it, so the lanes need no division and parallel or padding
+lanes, with a zero determinant, fail every test.
+
+\param ray - the ray; direction need not be unit length
+\param hit - set to the nearest hit
+
+\return true if a triangle is hit within ray.maxDistance
+*/
+/******************************************************************************/
+bool TriangleBvh::Raycast( const Ray& ray, RayHit &hit ) const
+{
+	float entry;
+	if (m_nodes.empty() || !ray.Intersects(m_nodes[0].bounds, entry))
+		return false;
+
+	const Float4 zero = Splat4(0);
+	const Float4 ox = Splat4(ray.origin.x), oy = Splat4(ray.origin.y), oz = Splat4(ray.origin.z);
+	const Float4 dx = Splat4(ray.direction.x), dy = Splat4(ray.direction.y), dz = Splat4(ray.direction.z);
+
+	Ray shortened = ray;
+	bool found = false;
+
+	//Each entry is a node and where the ray enters it
+	std::pair<unsigned, float> stack[STACK_SIZE];
+	unsigned top = 0;
+	stack[top++] = std::make_pair(0u, entry);
+	while (top > 0)
+	{
+		--top;
+		if (stack[top].second > shortened.maxDistance)
+			continue;
+		const Node &node = m_nodes[stack[top].first];
+
+		if (node.packet == NO_TRIANGLE)
+		{
+			unsigned first = stack[top].first + 1, second = node.right;
+			float firstEntry, secondEntry;
+			bool hitFirst = shortened.Intersects(m_nodes[first].bounds, firstEntry);
+			bool hitSecond = shortened.Intersects(m_nodes[second].bounds, secondEntry);
+			if (hitFirst && hitSecond && secondEntry < firstEntry)
+			{
+				std::swap(first, second);
+				std::swap(firstEntry, secondEntry);
+			}
+			//The nearer child is pushed last, so it is visited first
+			if (hitSecond)
+				stack[top++] = std::make_pair(second, secondEntry);
+			if (hitFirst)
+				stack[top++] = std::make_pair(first, firstEntry);
+			continue;
+		}
+
+		const Packet &packet = m_packets[node.packet];
+		Float4 e1x = Load4(packet.edge1[0]), e1y = Load4(packet.edge1[1]), e1z = Load4(packet.edge1[2]);
+		Float4 e2x = Load4(packet.edge2[0]), e2y = Load4(packet.edge2[1]), e2z = Load4(packet.edge2[2]);
+
+		//p = d x e2, det = e1 . p
+		Float4 px = Sub4(Mul4(dy, e2z), Mul4(dz, e2y));
+		Float4 py = Sub4(Mul4(dz, e2x), Mul4(dx, e2z));
+		Float4 pz = Sub4(Mul4(dx, e2y), Mul4(dy, e2x));
+		Float4 det = Add4(Add4(Mul4(e1x, px), Mul4(e1y, py)), Mul4(e1z, pz));
+
+		//t = o - corner, q = t x e1
+		Float4 tx = Sub4(ox, Load4(packet.corner[0]));
+		Float4 ty = Sub4(oy, Load4(packet.corner[1]));
+		Float4 tz = Sub4(oz, Load4(packet.corner[2]));
+		Float4 qx = Sub4(Mul4(ty, e1z), Mul4(tz, e1y));
+		Float4 qy = Sub4(Mul4(tz, e1x), Mul4(tx, e1z));
+		Float4 qz = Sub4(Mul4(tx, e1y), Mul4(ty, e1x));
+
+		//u, v and distance, each times det
+		Float4 u = Add4(Add4(Mul4(tx, px), Mul4(ty, py)), Mul4(tz, pz));
+		Float4 v = Add4(Add4(Mul4(dx, qx), Mul4(dy, qy)), Mul4(dz, qz));
+		Float4 t = Add4(Add4(Mul4(e2x, qx), Mul4(e2y, qy)), Mul4(e2z, qz));
+
+		//Times det again, so each test is against a positive det squared
+		Float4 det2 = Mul4(det, det);
+		Float4 uDet = Mul4(u, det), vDet = Mul4(v, det), tDet = Mul4(t, det);
+		Float4 mask = Less4(zero, det2);
+		mask = And4(mask, LessEqual4(zero, uDet));
+		mask = And4(mask, LessEqual4(zero, vDet));
+		mask = And4(mask, LessEqual4(Add4(uDet, vDet), det2));
+		mask = And4(mask, LessEqual4(zero, tDet));
+		mask = And4(mask, LessEqual4(tDet, Mul4(Splat4(shortened.maxDistance), det2)));
+		int lanes = MoveMask4(mask);
+		if (lanes == 0)
+			continue;
+
+		float dets[4], us[4], vs[4], ts[4];
+		Store4(dets, det);
+		Store4(us, u);
+		Store4(vs, v);
+		Store4(ts, t);
+		for (unsigned lane = 0; lane < LEAF_SIZE; ++lane)
+		{
+			if (!(lanes & (1 << lane)))
+				continue;
+			float inv = 1.0f / dets[lane];
+			float distance = ts[lane] * inv;
+			if (distance > shortened.maxDistance)
+				continue;
+			shortened.maxDistance = distance;
+			hit.distance = distance;
+			hit.triangle = packet.triangle[lane];
+			hit.u = us[lane] * inv;
+			hit.v = vs[lane] * inv;
+			found = true;
+		}
+	}
+	return found;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Conservative advancement. The distance from a triangle to a capsule moving
+in a straight line is a convex function of the fraction moved, so it stays
+above its tangent: a triangle closing in at speed -normal . displacement
+cannot be reached sooner than its gap over that speed, and one that is not
+closing in now never will be. Each step goes to the soonest of those, which
+converges from short of contact in a few steps even when grazing.
+
+\param capsule - the capsule at the start
+\param displacement - its movement
+\param hit - set to the first contact
+
+\return true if the capsule touches a triangle before the end of the move
+*/
+/******************************************************************************/
+bool TriangleBvh::SweepCapsule( const Capsule& capsule, const Vector3& displacement, SweepHit &hit ) const
+{
+	AABB swept = capsule.Bounds();
+	swept.Expand(Capsule(capsule.a + displacement, capsule.b + displacement, capsule.radius).Bounds());
+	Vector3 skin(CONTACT_SKIN, CONTACT_SKIN, CONTACT_SKIN);
+	swept.min -= skin;
+	swept.max += skin;
+
+	std::vector<unsigned> candidates;
+	Query(swept, candidates);
+
+	float fraction = 0;
+	for (unsigned step = 0; step < MAX_SWEEP_STEPS; ++step)
+	{
+		Vector3 offset = displacement * fraction;
+		Vector3 a = capsule.a + offset, b = capsule.b + offset;
+
+		float advance = FLT_MAX, nearest = FLT_MAX;
+		for (unsigned i = 0; i < candidates.size(); ++i)
+		{
+			const Vector3 *corner = &m_corners[candidates[i] * 3];
+			Vector3 onSegment, onTriangle;
+			float distance = sqrt(SegmentTriangleDistanceSquared(a, b, corner[0], corner[1], corner[2], onSegment, onTriangle));
+
+			Vector3 normal;
+			if (distance > Math::EPSILON)
+			{
+				normal = (onSegment - onTriangle) * (1.0f / distance);
+			}
+			else
+			{
+				//Crossing the triangle; push back against the movement
+				normal = (corner[1] - corner[0]).Cross(corner[2] - corner[0]).NormalizedOrZero();
+				if (normal.Dot(displacement) > 0)
+					normal = -normal;
+			}
+			float closing = -normal.Dot(displacement);
+			if (closing <= 0)
+				continue;
+
+			advance = Math::Min(advance, (distance - capsule.radius) / closing);
+			if (distance < nearest)
+			{
+				nearest = distance;
+				hit.point = onTriangle;
+				hit.normal = normal;
+				hit.triangle = candidates[i];
+			}
+		}
+		if (nearest == FLT_MAX)
+			return false;
+		if (nearest <= capsule.radius + CONTACT_SKIN)
+			break;
+
+		fraction += advance;
+		if (fraction >= 1)
+			return false;
+	}
+	//Out of steps, the capsule is still short of contact where it got to
+	hit.fraction = fraction;
+	return true;
+}
+
+void TriangleBvh::Query( const AABB& box, std::vector<unsigned> &out ) const
+{
+	if (m_nodes.empty())
+		return;
+
+	unsigned stack[STACK_SIZE];
+	unsigned top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		unsigned index = stack[--top];
+		const Node &node = m_nodes[index];
+		if (!node.bounds.Overlaps(box))
+			continue;
+		if (node.packet == NO_TRIANGLE)
+		{
+			stack[top++] = node.right;
+			stack[top++] = index + 1;
+			continue;
+		}
+		const Packet &packet = m_packets[node.packet];
+		for (unsigned lane = 0; lane < LEAF_SIZE && packet.triangle[lane] != NO_TRIANGLE; ++lane)
+		{
+			out.push_back(packet.triangle[lane]);
+		}
+	}
+}
@@ -0,0 +1,118 @@
+/******************************************************************************/
+/*!
+\file	TriangleBvh.h
+\brief
+Static bounding volume hierarchy over the triangles of one mesh, for ray
+picking and capsule sweeps against the real geometry
+*/
+/******************************************************************************/
+#ifndef TRIANGLE_BVH_H
+#define TRIANGLE_BVH_H
+
+#include <vector>
+#include "Bounds.h"
+
+/******************************************************************************/
+/*!
+		Struct RayHit:
+\brief	Nearest triangle along a ray; distance is in units of the ray's
+		direction, and u, v are the barycentric weights of the second and
+		third corners
+*/
+/******************************************************************************/
+struct RayHit
+{
+	float distance;
+	unsigned triangle;
+	float u, v;
+};
+
+/******************************************************************************/
+/*!
+		Struct SweepHit:
+\brief	First contact of a moving capsule. fraction is how far along the
+		displacement the capsule can go, point the contact on the mesh and
+		normal the unit direction from it back towards the capsule.
+*/
+/******************************************************************************/
+struct SweepHit
+{
+	float fraction;
+	Vector3 point;
+	Vector3 normal;
+	unsigned triangle;
+};
+
+/******************************************************************************/
+/*!
+		Class TriangleBvh:
+\brief	Binary tree of triangle boxes built once, top down by the binned
+		surface area heuristic, into one array in depth first order: a
+		node's left child follows it and only the right child is stored.
+
+		Each leaf holds up to four triangles as one packet, corners and
+		edges laid out by lane, so Raycast tests the four with one SIMD
+		Moller-Trumbore pass. Children are visited nearest first and any
+		box behind the nearest hit so far is skipped.
+
+		SweepCapsule gathers the triangles under the swept box and moves
+		the capsule by conservative advancement: at each step it goes as
+		far as the distance to the nearest triangle allows, which cannot
+		tunnel and stops within a few steps of contact.
+
+		Everything is in the space of the positions given to Build. The
+		tree keeps no reference to them; rebuild when they change.
+*/
+/******************************************************************************/
+class TriangleBvh
+{
+public:
+	static const unsigned NO_TRIANGLE = 0xFFFFFFFF;
+
+	TriangleBvh();
+	~TriangleBvh();
+
+	//indices are a triangle list; triangle i is indices[3i] to indices[3i + 2]
+	void Build( const Vector3 *positions, unsigned vertexCount, const unsigned *indices, unsigned indexCount );
+	void Clear( void );
+
+	unsigned GetTriangleCount( void ) const;
+	void GetTriangle( unsigned triangle, Vector3 &a, Vector3 &b, Vector3 &c ) const;
+	const AABB& GetBounds( void ) const; //Empty with no triangles
+
+	//Nearest triangle within ray.maxDistance, either side facing; false,
+	//leaving hit untouched, if none
+	bool Raycast( const Ray& ray, RayHit &hit ) const;
+	//First triangle the capsule touches moving by displacement. Triangles
+	//it already touches but is moving away from are passed through, so a
+	//capsule resting on a surface can leave it.
+	bool SweepCapsule( const Capsule& capsule, const Vector3& displacement, SweepHit &hit ) const;
+	//Triangles of the leaves whose boxes overlap box, a superset of those
+	//that overlap it themselves
+	void Query( const AABB& box, std::vector<unsigned> &out ) const;
+
+private:
+	struct Node
+	{
+		AABB bounds;
+		unsigned right; //Internal nodes; the left child is the next node
+		unsigned packet; //Leaves; NO_TRIANGLE for internal nodes
+	};
+
+	//Up to four triangles; unused lanes have zero edges, which never hit
+	struct Packet
+	{
+		float corner[3][4]; //x, y, z by lane
+		float edge1[3][4];
+		float edge2[3][4];
+		unsigned triangle[4];
+	};
+
+	unsigned BuildRange( unsigned *triangles, unsigned count, const AABB *boxes, unsigned depth );
+
+	std::vector<Node> m_nodes;
+	std::vector<Packet> m_packets;
+	std::vector<Vector3> m_corners; //Three per triangle, in the order given
+};
+
+#endif //TRIANGLE_BVH_H
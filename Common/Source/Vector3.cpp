@@ -15,43 +15,6 @@ bool Vector3::IsEqual(float a, float b) const
 	return a - b <= Math::EPSILON && b - a <= Math::EPSILON;
 }
 
-/******************************************************************************/
-/*!
-\brief	Vector3 default constructor
-
-\param	a
-	x value
-\param	b
-	y value
-\param	c
-	z value
-*/
-/******************************************************************************/
-Vector3::Vector3(float a, float b, float c) : x(a), y(b), z(c)
-{
-}
-
-/******************************************************************************/
-/*!
-\brief	Vector3 copy constructor
-
-\param	rhs
-	Vector to copy from
-*/
-/******************************************************************************/
-Vector3::Vector3(const Vector3 &rhs) : x(rhs.x), y(rhs.y), z(rhs.z)
-{
-}
-
-/******************************************************************************/
-/*!
-\brief	Vector3 destructor
-*/
-/******************************************************************************/
-Vector3::~Vector3()
-{
-}
-
 /******************************************************************************/
 /*!
 \brief	Set the elements of this vector
@@ -243,24 +206,6 @@ bool Vector3::operator!= ( const Vector3& rhs ) const
 	return !IsEqual(x, rhs.x) || !IsEqual(y, rhs.y) || !IsEqual(z, rhs.z);
 }
 
-/******************************************************************************/
-/*!
-\brief	Assignment operation (assign a vector to this vector)
-
-\param	rhs
-	Vector to assign
-\return 
-	A reference to this vector
-*/
-/******************************************************************************/
-Vector3& Vector3::operator=(const Vector3& rhs)
-{
-	x = rhs.x;
-	y = rhs.y;
-	z = rhs.z;
-	return *this;
-}
-
 /******************************************************************************/
 /*!
 \brief
@@ -334,7 +279,7 @@ Return a copy of this vector, normalized
 	Resulting normalized vector
 */
 /******************************************************************************/
-Vector3 Vector3::Normalized( void ) const throw( DivideByZero )
+Vector3 Vector3::Normalized( void ) const
 {
 	float d = Length();
 	if(d <= Math::EPSILON && -d <= Math::EPSILON)
@@ -355,7 +300,7 @@ Normalize this vector and return a reference to it
 	Reference to this vector
 */
 /******************************************************************************/
-Vector3& Vector3::Normalize( void ) throw( DivideByZero )
+Vector3& Vector3::Normalize( void )
 {
 	float d = Length();
 	if(d <= Math::EPSILON && -d <= Math::EPSILON)
@@ -366,6 +311,26 @@ Vector3& Vector3::Normalize( void ) throw( DivideByZero )
 	return *this;
 }
 
+/******************************************************************************/
+/*!
+\brief
+Return a copy of this vector, normalized, without the exception check
+
+\exception None
+\return 
+	Normalized copy, or a zero vector if this vector's length is within
+	Math::EPSILON of zero
+*/
+/******************************************************************************/
+Vector3 Vector3::NormalizedOrZero( void ) const noexcept
+{
+	float d = Length();
+	if(d <= Math::EPSILON)
+		return Vector3(0, 0, 0);
+	float invD = 1.0f / d;
+	return Vector3(x * invD, y * invD, z * invD);
+}
+
 std::ostream& operator<< (std::ostream& os, Vector3& rhs)
 {
 	os << "[ " << rhs.x << ", " << rhs.y << ", " << rhs.z << " ]";
@@ -14,12 +14,11 @@ Struct to define a 3D vector
 #include "MyMath.h"
 #include <iostream>
 
-#pragma warning( disable: 4290 ) //for throw(DivideByZero)
-
 /******************************************************************************/
 /*!
 		Class Vector3:
-\brief	Defines a 3D vector and its methods
+\brief	Defines a 3D vector and its methods. Trivially copyable so arrays of
+		vectors, and of Vertex, copy with memcpy.
 */
 /******************************************************************************/
 struct Vector3
@@ -27,9 +26,7 @@ struct Vector3
 	float x, y, z;
 	bool IsEqual(float a, float b) const;
 
-	Vector3(float a = 0.0, float b = 0.0, float c = 0.0);
-	Vector3(const Vector3 &rhs);
-	~Vector3();
+	constexpr Vector3(float a = 0.0, float b = 0.0, float c = 0.0) : x(a), y(b), z(c) {}
 	
 	void Set( float a = 0, float b = 0, float c = 0 ); //Set all data
 	void SetZero( void ); //Set all data to zero
@@ -49,8 +46,6 @@ struct Vector3
 	bool operator==( const Vector3& rhs ) const; //Equality check
 	bool operator!= ( const Vector3& rhs ) const; //Inequality check
 
-	Vector3& operator=(const Vector3& rhs); //Assignment operator
-
 	float Length( void ) const; //Get magnitude
 	float LengthSquared (void ) const; //Get square of magnitude
 	
@@ -59,11 +54,14 @@ struct Vector3
 	
 	//Return a copy of this vector, normalized
 	//Throw a divide by zero exception if normalizing a zero vector
-	Vector3 Normalized( void ) const throw( DivideByZero );
+	Vector3 Normalized( void ) const;
 	
 	//Normalize this vector and return a reference to it
 	//Throw a divide by zero exception if normalizing a zero vector
-	Vector3& Normalize( void ) throw( DivideByZero );
+	Vector3& Normalize( void );
+
+	//Return a copy of this vector, normalized, or a zero vector if it is one
+	Vector3 NormalizedOrZero( void ) const noexcept;
 	
 	friend std::ostream& operator<<( std::ostream& os, Vector3& rhs); //print to ostream
 
@@ -1,56 +0,0 @@
-#include "timer.h"
-
-StopWatch::StopWatch()
-{    
-    QueryPerformanceFrequency( &frequency ) ;
-
-    #define TARGET_RESOLUTION 1         // 1-millisecond target resolution
-    TIMECAPS tc;
-    
-
-    if (timeGetDevCaps(&tc, sizeof(TIMECAPS)) != TIMERR_NOERROR) 
-    {
-        // Error; application can't continue.
-    }
-
-    wTimerRes = min(max(tc.wPeriodMin, TARGET_RESOLUTION), tc.wPeriodMax);
-    timeBeginPeriod(wTimerRes); 
-}
-
-StopWatch::~StopWatch()
-{
-    timeEndPeriod(wTimerRes);
-}
-
-double StopWatch::LIToSecs( LARGE_INTEGER & L) {
-     return ((double)L.QuadPart /(double)frequency.QuadPart) ;
- }
- 
-void StopWatch::startTimer( )
-{
-    QueryPerformanceCounter(&prevTime) ;
-}
- 
-double StopWatch::getElapsedTime() 
-{
-    LARGE_INTEGER time;
-    QueryPerformanceCounter(&currTime) ;
-    time.QuadPart = currTime.QuadPart - prevTime.QuadPart;
-    prevTime = currTime;
-    return LIToSecs( time) ;
-}
-
-void StopWatch::waitUntil(long long time)
-{
-    LARGE_INTEGER nowTime;
-    LONGLONG timeElapsed;
-    while (true)
-    {
-        QueryPerformanceCounter(&nowTime);
-        timeElapsed = ((nowTime.QuadPart - prevTime.QuadPart) * 1000 / frequency.QuadPart);
-        if (timeElapsed > time)
-            return;
-        else if (time - timeElapsed > 1)
-            Sleep(1);
-    }
-}
\ No newline at end of file
@@ -9,13 +9,18 @@
 //Include the standard C++ headers
 #include <stdio.h>
 #include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <atomic>
 
 #include "Scene1.h"
+#include "FileSystem.h"
 
 
 GLFWwindow* m_window;
 const unsigned char FPS = 60; // FPS of this game
-const unsigned int frameTime = 1000 / FPS; // time for each frame
+const double SIMULATION_STEP = 1.0 / 60; // seconds per scene update, whatever the frame rate
+const unsigned MAX_CATCH_UP_STEPS = 5; // steps run back to back before the simulation gives up the time it is behind by
 
 //Define an error callback
 static void error_callback(int error, const char* description)
@@ -36,6 +41,16 @@ bool Application::IsKeyPressed(unsigned short key)
     return ((GetAsyncKeyState(key) & 0x8001) != 0);
 }
 
+void Application::GetCursorPos(double &x, double &y)
+{
+	glfwGetCursorPos(m_window, &x, &y);
+}
+
+void Application::GetWindowSize(int &width, int &height)
+{
+	glfwGetWindowSize(m_window, &width, &height);
+}
+
 Application::Application()
 {
 }
@@ -82,6 +97,15 @@ void Application::Init()
 	//This function makes the context of the specified window current on the calling thread. 
 	glfwMakeContextCurrent(m_window);
 
+	//Swap on the display's refresh and pace to it; without a refresh rate
+	//to go by, hold a fixed FPS instead
+	glfwSwapInterval(1);
+	const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+	if (mode != NULL && mode->refreshRate > 0)
+		m_pacer.SetVsync(mode->refreshRate);
+	else
+		m_pacer.SetFixed(FPS);
+
 	//Sets the key callback
 	//glfwSetKeyCallback(m_window, key_callback);
 
@@ -95,32 +119,98 @@ void Application::Init()
 		fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
 		//return -1;
 	}
+
+	//Read assets from the pack when there is one; loose files are the fallback
+	if (FileSystem::Exists("Assets.pack"))
+	{
+		FileSystem::Mount("Assets.pack");
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Simulation thread: update the scene at a fixed step on its own clock until
+told to stop, catching up when a step runs late
+
+\param scene - initialised scene; Render runs alongside on the GL thread
+\param running - cleared by the GL thread to stop
+*/
+/******************************************************************************/
+static void Simulate(Scene *scene, const std::atomic<bool> *running)
+{
+	typedef std::chrono::steady_clock Clock;
+	const Clock::duration step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(SIMULATION_STEP));
+
+	FramePacer pacer;
+	Clock::time_point next = Clock::now() + step;
+	while (*running)
+	{
+		pacer.WaitUntil(next);
+		for (unsigned i = 0; i < MAX_CATCH_UP_STEPS && Clock::now() >= next; ++i)
+		{
+			scene->Update(SIMULATION_STEP);
+			next += step;
+		}
+		if (Clock::now() >= next)
+		{
+			//Too far behind to catch up; slow down instead of spiralling
+			next = Clock::now() + step;
+		}
+	}
 }
 
 void Application::Run()
 {
 	//Main Loop
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 	Scene *scene = new Scene1();
 	scene->Init();
+	std::chrono::steady_clock::time_point initTime = std::chrono::steady_clock::now();
+	bool firstFrame = true;
+
+	//Updates run on their own thread at a fixed step, so simulation and
+	//rendering overlap and the frame rate is free of the update rate
+	std::atomic<bool> simulating(true);
+	std::thread simulation(Simulate, scene, &simulating);
 
-	m_timer.startTimer();    // Start timer to calculate how long it takes to render this frame
+	m_pacer.Start();
 	while (!glfwWindowShouldClose(m_window) && !IsKeyPressed(VK_ESCAPE))
 	{
-		scene->Update(m_timer.getElapsedTime());
 		scene->Render();
 		//Swap buffers
 		glfwSwapBuffers(m_window);
+		if (firstFrame)
+		{
+			//Time to first frame, split into scene init and the first render
+			glFinish();
+			std::chrono::steady_clock::time_point presentTime = std::chrono::steady_clock::now();
+			printf("Scene init: %.1f ms, first frame: %.1f ms\n",
+				std::chrono::duration<double, std::milli>(initTime - startTime).count(),
+				std::chrono::duration<double, std::milli>(presentTime - startTime).count());
+			firstFrame = false;
+		}
 		//Get and organize events, like keyboard and mouse input, window resizing, etc...
 		glfwPollEvents();
-        m_timer.waitUntil(frameTime);       // Frame rate limiter. Limits each frame to a specified time in ms.   
+		m_pacer.Wait(); // Frame rate limiter, holding each frame to the pacer's target
 
 	} //Check if the ESC key had been pressed or if the window had been closed
+	simulating = false;
+	simulation.join();
+
+	const FramePacer::Stats &stats = m_pacer.GetStats();
+	printf("Frames: %u, mean %.2f ms, jitter %.2f ms, min %.2f ms, max %.2f ms, late %.2f ms (max %.2f ms), missed %u\n",
+		stats.frames, stats.meanFrame, stats.jitter, stats.minFrame, stats.maxFrame,
+		stats.meanLateness, stats.maxLateness, stats.missed);
 	scene->Exit();
 	delete scene;
 }
 
 void Application::Exit()
 {
+	//Release the mounted packs
+	FileSystem::UnmountAll();
+
 	//Close OpenGL window and terminate GLFW
 	glfwDestroyWindow(m_window);
 	//Finalize and clean up GLFW
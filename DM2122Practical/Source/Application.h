@@ -2,7 +2,8 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
-#include "timer.h"
+#include <windows.h> //VK_ key codes for IsKeyPressed
+#include "FramePacer.h"
 
 class Application
 {
@@ -13,10 +14,12 @@ public:
 	void Run();
 	void Exit();
 	static bool IsKeyPressed(unsigned short key);
+	static void GetCursorPos(double &x, double &y); //Pixels from the top left of the window
+	static void GetWindowSize(int &width, int &height);
 private:
 
 	//Declare a window object
-	StopWatch m_timer;
+	FramePacer m_pacer;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "AssetStreamer.h"
+#include <chrono>
+#include <iostream>
+
+#include "CookedMesh.h"
+
+AssetStreamer::AssetStreamer()
+	: m_quit(false)
+	, m_outstanding(0)
+	, m_budgetBytes(4 * 1024 * 1024)
+	, m_budgetMs(2.0)
+{
+}
+
+AssetStreamer::~AssetStreamer()
+{
+	Exit();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Start the worker threads
+
+\param numWorkers - number of threads, 0 to use one per spare hardware thread
+*/
+/******************************************************************************/
+void AssetStreamer::Init(unsigned numWorkers)
+{
+	if (numWorkers == 0)
+	{
+		unsigned hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_quit = false;
+	for (unsigned i = 0; i < numWorkers; ++i)
+	{
+		m_workers.push_back(std::thread(&AssetStreamer::WorkerLoop, this));
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Stop the workers and drop every request that has not been uploaded.
+Meshes handed out keep whatever was uploaded so far.
+*/
+/******************************************************************************/
+void AssetStreamer::Exit()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_quit = true;
+	}
+	m_requestCondition.notify_all();
+	for (unsigned i = 0; i < m_workers.size(); ++i)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+
+	while (!m_requests.empty())
+	{
+		delete m_requests.front();
+		m_requests.pop_front();
+	}
+	while (!m_completed.empty())
+	{
+		delete m_completed.front();
+		m_completed.pop_front();
+	}
+	m_outstanding = 0;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Limit the uploads done by each Update. At least one asset is uploaded per
+frame so an asset larger than the budget still gets through.
+
+\param bytesPerFrame - vertex, index and pixel bytes per frame
+\param msPerFrame - time spent uploading per frame
+*/
+/******************************************************************************/
+void AssetStreamer::SetUploadBudget(unsigned bytesPerFrame, double msPerFrame)
+{
+	m_budgetBytes = bytesPerFrame;
+	m_budgetMs = msPerFrame;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Queue a mesh file. The returned mesh is a placeholder cube until the file has
+been loaded and uploaded.
+
+\param meshName - name of mesh
+\param file_path - OBJ file, or a cooked mesh if the path ends with .mesh
+
+\return Mesh to render straight away; owned by the caller
+*/
+/******************************************************************************/
+Mesh* AssetStreamer::RequestMesh(const std::string &meshName, const std::string &file_path)
+{
+	Request *request = new Request();
+	request->type = Request::REQUEST_MESH;
+	request->file_path = file_path;
+	request->mesh = MeshBuilder::GenerateCube(meshName, Color(1, 0, 1));
+	request->textureID = 0;
+	request->success = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requests.push_back(request);
+	}
+	m_requestCondition.notify_one();
+	++m_outstanding;
+
+	return request->mesh;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Queue a TGA file. The returned texture holds a single grey texel until the
+file has been loaded and uploaded.
+
+\param file_path - TGA file
+
+\return Texture to bind straight away; owned by the caller
+*/
+/******************************************************************************/
+unsigned AssetStreamer::RequestTGA(const std::string &file_path)
+{
+	static const GLubyte placeholder[3] = { 128, 128, 128 };
+
+	Request *request = new Request();
+	request->type = Request::REQUEST_TEXTURE;
+	request->file_path = file_path;
+	request->mesh = NULL;
+	request->success = false;
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, placeholder);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	request->textureID = texture;
+
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requests.push_back(request);
+	}
+	m_requestCondition.notify_one();
+	++m_outstanding;
+
+	return texture;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Queue the six faces of a cube map. The returned texture is a single grey
+texel on every face until all six have been loaded and uploaded together.
+
+\param file_paths - TGA files in LoadTGACubemap order
+
+\return Cube map to bind straight away; owned by the caller
+*/
+/******************************************************************************/
+unsigned AssetStreamer::RequestTGACubemap(const char *file_paths[6])
+{
+	static const GLubyte placeholder[3] = { 128, 128, 128 };
+
+	Request *request = new Request();
+	request->type = Request::REQUEST_CUBEMAP;
+	request->file_path = file_paths[0];
+	for (unsigned face = 0; face < 6; ++face)
+	{
+		request->face_paths[face] = file_paths[face];
+	}
+	request->mesh = NULL;
+	request->success = false;
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned face = 0; face < 6; ++face)
+	{
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, placeholder);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	request->textureID = texture;
+
+	{
+		std::lock_guard<std::mutex> lock(m_requestMutex);
+		m_requests.push_back(request);
+	}
+	m_requestCondition.notify_one();
+	++m_outstanding;
+
+	return texture;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Upload loaded assets until this frame's byte or time budget runs out
+*/
+/******************************************************************************/
+void AssetStreamer::Update()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t uploadedBytes = 0;
+
+	while (m_outstanding > 0)
+	{
+		Request *request;
+		{
+			std::lock_guard<std::mutex> lock(m_completedMutex);
+			if (m_completed.empty())
+				break;
+			request = m_completed.front();
+			m_completed.pop_front();
+		}
+
+		if (!request->success)
+		{
+			std::cout << "Impossible to stream " << request->file_path << "\n";
+		}
+		else if (request->type == Request::REQUEST_MESH)
+		{
+			MeshBuilder::Upload(request->mesh, request->meshData);
+			uploadedBytes += request->meshData.vertices.size() * sizeof(Vertex) + request->meshData.indices.size() * sizeof(unsigned);
+		}
+		else if (request->type == Request::REQUEST_TEXTURE)
+		{
+			UploadTGAPixels(request->textureID, request->pixels);
+			uploadedBytes += request->pixels.data.size();
+		}
+		else
+		{
+			//All six at once, so the cube map is never half placeholder
+			UploadTGACubemapPixels(request->textureID, request->faces);
+			for (unsigned face = 0; face < 6; ++face)
+			{
+				uploadedBytes += request->faces[face].data.size();
+			}
+		}
+		delete request;
+		--m_outstanding;
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (uploadedBytes >= m_budgetBytes || elapsedMs >= m_budgetMs)
+			break;
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Check if every request has been uploaded
+
+\return true if nothing is queued, loading or waiting for upload
+*/
+/******************************************************************************/
+bool AssetStreamer::IsIdle() const
+{
+	return m_outstanding == 0;
+}
+
+void AssetStreamer::WorkerLoop()
+{
+	while (true)
+	{
+		Request *request;
+		{
+			std::unique_lock<std::mutex> lock(m_requestMutex);
+			while (!m_quit && m_requests.empty())
+				m_requestCondition.wait(lock);
+			if (m_quit)
+				return;
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		Load(request);
+
+		std::lock_guard<std::mutex> lock(m_completedMutex);
+		m_completed.push_back(request);
+	}
+}
+
+//Read and decode on a worker thread; no GL calls allowed here
+void AssetStreamer::Load(Request *request)
+{
+	const std::string &path = request->file_path;
+	if (request->type == Request::REQUEST_MESH)
+	{
+		bool cooked = path.size() > 5 && path.compare(path.size() - 5, 5, ".mesh") == 0;
+		request->success = cooked ? LoadCookedMesh(path.c_str(), request->meshData)
+			: MeshBuilder::BuildOBJ(path, request->meshData);
+	}
+	else if (request->type == Request::REQUEST_TEXTURE)
+	{
+		request->success = ReadTGAPixels(path.c_str(), request->pixels);
+	}
+	else
+	{
+		//Cube map faces are addressed top row first
+		request->success = true;
+		for (unsigned face = 0; face < 6 && request->success; ++face)
+		{
+			request->file_path = request->face_paths[face];
+			request->success = ReadTGAPixels(request->file_path.c_str(), request->faces[face], true);
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef ASSET_STREAMER_H
+#define ASSET_STREAMER_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <GL\glew.h>
+
+#include "Mesh.h"
+#include "MeshBuilder.h"
+#include "LoadTGA.h"
+
+/******************************************************************************/
+/*!
+		Class AssetStreamer:
+\brief	Loads meshes and textures in the background. Worker threads read and
+		decode files into CPU buffers; the GL thread uploads finished assets
+		in Update, within a per frame byte and time budget. Requested meshes
+		and textures are usable at once and show a placeholder until then.
+*/
+/******************************************************************************/
+class AssetStreamer
+{
+public:
+	AssetStreamer();
+	~AssetStreamer();
+
+	void Init(unsigned numWorkers = 0); // 0 uses one worker per spare hardware thread
+	void Exit();						// Call before deleting any requested mesh
+
+	void SetUploadBudget(unsigned bytesPerFrame, double msPerFrame);
+
+	Mesh* RequestMesh(const std::string &meshName, const std::string &file_path); // .obj, or cooked .mesh
+	unsigned RequestTGA(const std::string &file_path);
+	unsigned RequestTGACubemap(const char *file_paths[6]); // Faces in LoadTGACubemap order
+
+	void Update();						// GL thread, once per frame
+	bool IsIdle() const;
+
+private:
+	struct Request
+	{
+		enum TYPE
+		{
+			REQUEST_MESH,
+			REQUEST_TEXTURE,
+			REQUEST_CUBEMAP,
+		};
+
+		TYPE type;
+		std::string file_path;			// the face that failed, for a cube map
+		std::string face_paths[6];
+		Mesh *mesh;
+		unsigned textureID;
+		bool success;
+
+		MeshData meshData;
+		TGAPixels pixels;
+		TGAPixels faces[6];
+	};
+
+	void WorkerLoop();
+	static void Load(Request *request);
+
+	std::vector<std::thread> m_workers;
+	std::deque<Request*> m_requests;	// waiting for a worker
+	std::deque<Request*> m_completed;	// waiting for the GL thread
+	std::mutex m_requestMutex;
+	std::mutex m_completedMutex;
+	std::condition_variable m_requestCondition;
+	bool m_quit;
+
+	unsigned m_outstanding;				// requested but not uploaded, GL thread only
+	unsigned m_budgetBytes;
+	double m_budgetMs;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "BakedMeshes.h"
+
+//Vertex{ position, color, normal, texCoord }
+static constexpr Vertex AXES_VERTICES[] = {
+	{ Position(-1000, 0, 0), Color(1, 0, 0), Vector3(), TexCoord() },
+	{ Position(1000, 0, 0), Color(1, 0, 0), Vector3(), TexCoord() },
+	{ Position(0, -1000, 0), Color(0, 1, 0), Vector3(), TexCoord() },
+	{ Position(0, 1000, 0), Color(0, 1, 0), Vector3(), TexCoord() },
+	{ Position(0, 0, -1000), Color(0, 0, 1), Vector3(), TexCoord() },
+	{ Position(0, 0, 1000), Color(0, 0, 1), Vector3(), TexCoord() },
+};
+static constexpr unsigned AXES_INDICES[] = { 0, 1, 2, 3, 4, 5 };
+
+static constexpr Vertex QUAD_VERTICES[] = {
+	{ Position(-0.5f, -0.5f, 0), Color(), Vector3(-1, -1, 1), TexCoord(0, 0) },
+	{ Position(0.5f, -0.5f, 0), Color(), Vector3(1, -1, 1), TexCoord(1, 0) },
+	{ Position(0.5f, 0.5f, 0), Color(), Vector3(1, 1, 1), TexCoord(1, 1) },
+	{ Position(-0.5f, 0.5f, 0), Color(), Vector3(-1, 1, 1), TexCoord(0, 1) },
+};
+static constexpr unsigned QUAD_INDICES[] = { 3, 0, 2, 1, 2, 0 };
+
+static constexpr Vertex CUBE_VERTICES[] = {
+	{ Position(-0.5f, -0.5f, -0.5f), Color(), Vector3(-1, -1, -1), TexCoord() },
+	{ Position(0.5f, -0.5f, -0.5f), Color(), Vector3(1, -1, -1), TexCoord() },
+	{ Position(0.5f, 0.5f, -0.5f), Color(), Vector3(1, 1, -1), TexCoord() },
+	{ Position(-0.5f, 0.5f, -0.5f), Color(), Vector3(-1, 1, -1), TexCoord() },
+	{ Position(-0.5f, -0.5f, 0.5f), Color(), Vector3(-1, -1, 1), TexCoord() },
+	{ Position(0.5f, -0.5f, 0.5f), Color(), Vector3(1, 1, 1), TexCoord() },
+	{ Position(0.5f, 0.5f, 0.5f), Color(), Vector3(1, 1, 1), TexCoord() },
+	{ Position(-0.5f, 0.5f, 0.5f), Color(), Vector3(-1, 1, 1), TexCoord() },
+};
+static constexpr unsigned CUBE_INDICES[] = {
+	7, 4, 6,	5, 6, 4,	//+Z
+	6, 5, 2,	1, 2, 5,	//+X
+	3, 7, 2,	6, 2, 7,	//+Y
+	2, 1, 3,	0, 3, 1,	//-Z
+	3, 0, 7,	4, 7, 0,	//-X
+	4, 0, 5,	1, 5, 0,	//-Y
+};
+
+static constexpr Vertex SKYBOX_VERTICES[] = {
+	{ Position(-1, -1, -1), Color(), Vector3(), TexCoord() },
+	{ Position(1, -1, -1), Color(), Vector3(), TexCoord() },
+	{ Position(1, 1, -1), Color(), Vector3(), TexCoord() },
+	{ Position(-1, 1, -1), Color(), Vector3(), TexCoord() },
+	{ Position(-1, -1, 1), Color(), Vector3(), TexCoord() },
+	{ Position(1, -1, 1), Color(), Vector3(), TexCoord() },
+	{ Position(1, 1, 1), Color(), Vector3(), TexCoord() },
+	{ Position(-1, 1, 1), Color(), Vector3(), TexCoord() },
+};
+//Same faces as the cube with every triangle reversed
+static constexpr unsigned SKYBOX_INDICES[] = {
+	6, 4, 7,	4, 6, 5,	//+Z
+	2, 5, 6,	5, 2, 1,	//+X
+	2, 7, 3,	7, 2, 6,	//+Y
+	3, 1, 2,	1, 3, 0,	//-Z
+	7, 0, 3,	0, 7, 4,	//-X
+	5, 0, 4,	0, 5, 1,	//-Y
+};
+
+//The glyph sheet, filled by WriteTextQuads while compiling
+struct TextSheet
+{
+	Vertex vertices[BakedMeshes::TEXT_ROWS * BakedMeshes::TEXT_COLUMNS * 4];
+	unsigned indices[BakedMeshes::TEXT_ROWS * BakedMeshes::TEXT_COLUMNS * 6];
+
+	constexpr TextSheet() : vertices(), indices()
+	{
+		WriteTextQuads(vertices, indices, BakedMeshes::TEXT_ROWS, BakedMeshes::TEXT_COLUMNS);
+	}
+};
+static constexpr TextSheet TEXT_SHEET;
+
+static_assert(TEXT_SHEET.indices[6] == 4, "Second glyph should start at vertex 4");
+static_assert(TEXT_SHEET.vertices[4].texCoord.u == 1.f / BakedMeshes::TEXT_COLUMNS, "Second glyph should be one column right");
+
+#define BAKED_MESH(vertices, indices, mode) { vertices, sizeof(vertices) / sizeof(Vertex), indices, sizeof(indices) / sizeof(unsigned), mode }
+
+const BakedMesh BakedMeshes::AXES = BAKED_MESH(AXES_VERTICES, AXES_INDICES, Mesh::DRAW_LINES);
+const BakedMesh BakedMeshes::QUAD = BAKED_MESH(QUAD_VERTICES, QUAD_INDICES, Mesh::DRAW_TRIANGLES);
+const BakedMesh BakedMeshes::CUBE = BAKED_MESH(CUBE_VERTICES, CUBE_INDICES, Mesh::DRAW_TRIANGLES);
+const BakedMesh BakedMeshes::SKYBOX = BAKED_MESH(SKYBOX_VERTICES, SKYBOX_INDICES, Mesh::DRAW_TRIANGLES);
+const BakedMesh BakedMeshes::TEXT = BAKED_MESH(TEXT_SHEET.vertices, TEXT_SHEET.indices, Mesh::DRAW_TRIANGLES);
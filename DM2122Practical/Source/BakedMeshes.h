@@ -0,0 +1,75 @@
+#ifndef BAKED_MESHES_H
+#define BAKED_MESHES_H
+
+#include "Mesh.h"
+
+/******************************************************************************/
+/*!
+		Struct BakedMesh:
+\brief	Vertex and index arrays computed at compile time. They live in read
+		only data, so making a mesh of one is a single upload with no
+		building or allocation.
+*/
+/******************************************************************************/
+struct BakedMesh
+{
+	const Vertex *vertices;
+	unsigned vertexCount;
+	const unsigned *indices;
+	unsigned indexCount;
+	Mesh::DRAW_MODE mode;
+};
+
+/******************************************************************************/
+/*!
+\brief
+Write the quads of a numRow x numCol glyph sheet, top left glyph first, 4
+vertices and 6 indices per glyph. constexpr so the 16 x 16 sheet is baked;
+other sizes call it at runtime.
+
+\param vertices - receives numRow * numCol * 4 vertices
+\param indices - receives numRow * numCol * 6 indices
+\param numRow - glyph rows of the font texture
+\param numCol - glyph columns of the font texture
+*/
+/******************************************************************************/
+constexpr void WriteTextQuads(Vertex *vertices, unsigned *indices, unsigned numRow, unsigned numCol)
+{
+	float width = 1.f / numCol;
+	float height = 1.f / numRow;
+	unsigned offset = 0;
+	for (unsigned i = 0; i < numRow; ++i)
+	{
+		for (unsigned j = 0; j < numCol; ++j)
+		{
+			float u1 = j * width;
+			float v1 = 1.f - height - i * height;
+			*vertices++ = Vertex{ Position(-0.5f, -0.5f, 0), Color(), Vector3(), TexCoord(u1, v1) };
+			*vertices++ = Vertex{ Position(0.5f, -0.5f, 0), Color(), Vector3(), TexCoord(u1 + width, v1) };
+			*vertices++ = Vertex{ Position(0.5f, 0.5f, 0), Color(), Vector3(), TexCoord(u1 + width, v1 + height) };
+			*vertices++ = Vertex{ Position(-0.5f, 0.5f, 0), Color(), Vector3(), TexCoord(u1, v1 + height) };
+
+			*indices++ = offset + 0;
+			*indices++ = offset + 1;
+			*indices++ = offset + 2;
+			*indices++ = offset + 0;
+			*indices++ = offset + 2;
+			*indices++ = offset + 3;
+			offset += 4;
+		}
+	}
+}
+
+namespace BakedMeshes
+{
+	const unsigned TEXT_ROWS = 16;
+	const unsigned TEXT_COLUMNS = 16;
+
+	extern const BakedMesh AXES; //Red x, green y and blue z lines, 2000 long
+	extern const BakedMesh QUAD; //White, 1 x 1 in the xy plane, facing +z
+	extern const BakedMesh CUBE; //White, 1 x 1 x 1
+	extern const BakedMesh SKYBOX; //Positions only, -1 to 1, facing inwards
+	extern const BakedMesh TEXT; //TEXT_ROWS x TEXT_COLUMNS glyph quads
+}
+
+#endif
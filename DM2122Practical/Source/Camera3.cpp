@@ -1,8 +1,9 @@
 #include "Camera3.h"
 #include "Application.h"
 #include "Mtx44.h"
+#include "CollisionWorld.h"
 
-Camera3::Camera3()
+Camera3::Camera3() : collision(NULL), collisionRadius(0)
 {
 }
 
@@ -28,98 +29,22 @@ void Camera3::Update(double dt)
 
 	static const float CAMERA_SPEED = 90.f;
 	//Movement
+	Vector3 movement;
 	if (Application::IsKeyPressed('A'))
 	{
-		if (target.x < 110)
-		{
-			if (target.x > -110)
-			{
-				if (target.y < 80)
-				{
-					if (target.y > 0)
-					{
-						if (target.z < 300)
-						{
-
-							if (target.z > -240)
-							{
-								position = position - right;
-								target = position + view;
-							}
-						}
-					}
-				}
-			}
-		}
+		movement -= right;
 	}
 	if (Application::IsKeyPressed('D'))
 	{
-		if (target.x < 110)
-		{
-			if (target.x > -110)
-			{
-				if (target.y < 80)
-				{
-					if (target.y > 0)
-					{
-						if (target.z < 300)
-						{
-							if (target.z > -240)
-							{
-								position = position + right;
-								target = position + view;
-							}
-						}
-					}
-				}
-			}
-		}
+		movement += right;
 	}
 	if (Application::IsKeyPressed('W'))
 	{
-		if (target.x < 110)
-		{
-			if (target.x > -110)
-			{
-				if (target.y < 80)
-				{
-					if (target.y > 0)
-					{
-						if (target.z < 300)
-						{
-							if (target.z > -240)
-							{
-								position = position + view.Normalized();
-								target = position + view;
-							}
-						}
-					}
-				}
-			}
-		}
+		movement += view;
 	}
 	if (Application::IsKeyPressed('S'))
 	{
-		if (target.x < 100)
-		{
-			if (target.x > -110)
-			{
-				if (target.y < 80)
-				{
-					if (target.y > 0)
-					{
-						if (target.z < 300)
-						{
-							if (target.z > -240)
-							{
-								position = position - view.Normalized();
-								target = position + view;
-							}
-						}
-					}
-				}
-			}
-		}
+		movement -= view;
 	}
 
 	//Camera Movement
@@ -171,6 +96,8 @@ void Camera3::Update(double dt)
         view = rotation * view;
         target = position + view;
     }
+	Move(movement);
+
 	if(Application::IsKeyPressed('R'))
 	{
 		Reset();
@@ -182,4 +109,21 @@ void Camera3::Reset()
 	position = defaultPosition;
 	target = defaultTarget;
 	up = defaultUp;
-}
\ No newline at end of file
+}
+
+void Camera3::SetCollision(const CollisionWorld *world, float radius)
+{
+	collision = world;
+	collisionRadius = radius;
+}
+
+//Slide along whatever is in the way instead of passing through it
+void Camera3::Move(const Vector3 &displacement)
+{
+	if (displacement.IsZero())
+		return;
+
+	Vector3 moved = collision ? collision->Slide(Capsule(position, position, collisionRadius), displacement) : displacement;
+	position += moved;
+	target += moved;
+}
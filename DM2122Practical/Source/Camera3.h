@@ -3,6 +3,8 @@
 
 #include "Camera.h"
 
+class CollisionWorld;
+
 class Camera3 : public Camera
 {
 public:
@@ -22,6 +24,15 @@ public:
 	virtual void Init(const Vector3& pos, const Vector3& target, const Vector3& up);
 	virtual void Update(double dt);
 	virtual void Reset();
+
+	//Collide with world as a sphere of radius; NULL to move freely
+	void SetCollision(const CollisionWorld *world, float radius);
+
+private:
+	void Move(const Vector3 &displacement);
+
+	const CollisionWorld *collision;
+	float collisionRadius;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include <cassert>
+#include "Character.h"
+
+//Walk weight change per second, so a switch takes a quarter second
+static const float BLEND_RATE = 4.0f;
+
+static const unsigned NUM_STACK = 18;
+static const unsigned NUM_SLICE = 36;
+
+//Colors of the parts
+static const Color SKIN(1.0f, 0.85f, 0.7f);
+static const Color SUIT(0.2f, 0.3f, 0.8f);
+static const Color HAT(0.8f, 0.1f, 0.1f);
+static const Color STAR(1.0f, 0.85f, 0.1f);
+static const Color WHITE(1, 1, 1);
+static const Color BLACK(0, 0, 0);
+static const Color BOOT(0.35f, 0.2f, 0.1f);
+
+Character::Character() : mesh(NULL), time(0), walkWeight(0)
+{
+}
+
+Character::~Character()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Set up the skeleton and clips, and merge the body parts into data in the
+bind pose: standing on the origin, facing +z
+*/
+/******************************************************************************/
+void Character::Build(SkinnedMeshData &data)
+{
+	BuildSkeleton();
+	BuildClips();
+	BuildParts(data);
+
+	//Joints no clip animates keep their bind pose
+	idlePose = walkPose = pose = skeleton.GetBindPose();
+	time = 0;
+	walkWeight = 0;
+}
+
+void Character::Upload(const SkinnedMeshData &data)
+{
+	if (mesh == NULL)
+		mesh = new SkinnedMesh("character");
+	mesh->Upload(data);
+}
+
+void Character::Exit()
+{
+	delete mesh;
+	mesh = NULL;
+	skeleton.Clear();
+}
+
+void Character::BuildSkeleton()
+{
+	struct JointDef { const char *name; JOINT parent; float x, y, z; };
+	static const JointDef JOINTS[NUM_JOINTS] = {
+		{ "root", NUM_JOINTS, 0, 0, 0 },
+		{ "body", JOINT_ROOT, 0, 7, 0 },
+		{ "head", JOINT_BODY, 0, 3.2f, 0 },
+		{ "hat", JOINT_HEAD, 0, 1.4f, 0 },
+
+		{ "leftShoulder", JOINT_BODY, 2.6f, 1.2f, 0 },
+		{ "leftArm", JOINT_LEFTSHOULDER, 0, -0.6f, 0 },
+		{ "leftArm2", JOINT_LEFTARM, 0, -2, 0 },
+		{ "leftHand", JOINT_LEFTARM2, 0, -2, 0 },
+
+		{ "rightShoulder", JOINT_BODY, -2.6f, 1.2f, 0 },
+		{ "rightArm", JOINT_RIGHTSHOULDER, 0, -0.6f, 0 },
+		{ "rightArm2", JOINT_RIGHTARM, 0, -2, 0 },
+		{ "rightHand", JOINT_RIGHTARM2, 0, -2, 0 },
+
+		{ "leftLeg", JOINT_ROOT, 1.1f, 4.6f, 0 },
+		{ "leftLeg2", JOINT_LEFTLEG, 0, -2, 0 },
+		{ "leftFoot", JOINT_LEFTLEG2, 0, -2, 0 },
+
+		{ "rightLeg", JOINT_ROOT, -1.1f, 4.6f, 0 },
+		{ "rightLeg2", JOINT_RIGHTLEG, 0, -2, 0 },
+		{ "rightFoot", JOINT_RIGHTLEG2, 0, -2, 0 },
+	};
+
+	skeleton.Clear();
+	for (unsigned i = 0; i < NUM_JOINTS; ++i)
+	{
+		const JointDef &def = JOINTS[i];
+		unsigned parent = def.parent == NUM_JOINTS ? Skeleton::NO_JOINT : (unsigned)def.parent;
+		unsigned joint = skeleton.AddJoint(def.name, parent, Transform(Vector3(def.x, def.y, def.z), Quaternion()));
+		assert(joint == i);
+		(void)joint;
+	}
+}
+
+//A joint's bind pose turned about an axis and raised
+Transform Character::Keyed(JOINT joint, float degrees, float axisX, float axisY, float axisZ, float raise) const
+{
+	Transform local = skeleton.GetBindPose()[joint];
+	local.rotation.SetToRotation(degrees, axisX, axisY, axisZ);
+	local.translation.y += raise;
+	return local;
+}
+
+void Character::BuildClips()
+{
+	//Breathing, with the head and arms swaying a little
+	idle = AnimationClip(2.0f, true);
+	idle.AddKey(JOINT_BODY, 0, Keyed(JOINT_BODY, 0, 0, 1, 0));
+	idle.AddKey(JOINT_BODY, 1, Keyed(JOINT_BODY, 0, 0, 1, 0, 0.15f));
+	idle.AddKey(JOINT_BODY, 2, Keyed(JOINT_BODY, 0, 0, 1, 0));
+	idle.AddKey(JOINT_HEAD, 0, Keyed(JOINT_HEAD, -4, 0, 0, 1));
+	idle.AddKey(JOINT_HEAD, 1, Keyed(JOINT_HEAD, 4, 0, 0, 1));
+	idle.AddKey(JOINT_HEAD, 2, Keyed(JOINT_HEAD, -4, 0, 0, 1));
+	idle.AddKey(JOINT_LEFTARM, 0, Keyed(JOINT_LEFTARM, 5, 0, 0, 1));
+	idle.AddKey(JOINT_LEFTARM, 1, Keyed(JOINT_LEFTARM, 10, 0, 0, 1));
+	idle.AddKey(JOINT_LEFTARM, 2, Keyed(JOINT_LEFTARM, 5, 0, 0, 1));
+	idle.AddKey(JOINT_RIGHTARM, 0, Keyed(JOINT_RIGHTARM, -5, 0, 0, 1));
+	idle.AddKey(JOINT_RIGHTARM, 1, Keyed(JOINT_RIGHTARM, -10, 0, 0, 1));
+	idle.AddKey(JOINT_RIGHTARM, 2, Keyed(JOINT_RIGHTARM, -5, 0, 0, 1));
+
+	//One stride each second: legs and arms swing in opposition, the knee
+	//of the leg swinging forward bends and the body bobs twice
+	walk = AnimationClip(1.0f, true);
+	for (unsigned i = 0; i <= 4; ++i)
+	{
+		float t = i * 0.25f;
+		float swing = i == 0 || i == 4 ? 1.0f : i == 2 ? -1.0f : 0.0f;
+		walk.AddKey(JOINT_BODY, t, Keyed(JOINT_BODY, 0, 0, 1, 0, i & 1 ? 0.3f : 0));
+		walk.AddKey(JOINT_LEFTLEG, t, Keyed(JOINT_LEFTLEG, -30 * swing, 1, 0, 0));
+		walk.AddKey(JOINT_RIGHTLEG, t, Keyed(JOINT_RIGHTLEG, 30 * swing, 1, 0, 0));
+		walk.AddKey(JOINT_LEFTLEG2, t, Keyed(JOINT_LEFTLEG2, i == 3 ? 40.0f : 0, 1, 0, 0));
+		walk.AddKey(JOINT_RIGHTLEG2, t, Keyed(JOINT_RIGHTLEG2, i == 1 ? 40.0f : 0, 1, 0, 0));
+		walk.AddKey(JOINT_LEFTARM, t, Keyed(JOINT_LEFTARM, 25 * swing, 1, 0, 0));
+		walk.AddKey(JOINT_RIGHTARM, t, Keyed(JOINT_RIGHTARM, -25 * swing, 1, 0, 0));
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Merge every body part into data, placed relative to its joint in the bind
+pose; the same parts the character was once drawn with one call each
+*/
+/******************************************************************************/
+void Character::BuildParts(SkinnedMeshData &data) const
+{
+	data.vertices.clear();
+	data.indices.clear();
+
+	auto add = [&](JOINT joint, const MeshData &part, const Vector3 &offset, const Vector3 &scale) {
+		Transform local(offset, Quaternion(), scale);
+		data.AddPart(part, skeleton.GetBindWorld(joint) * local.GetMatrix(), joint);
+	};
+	auto sphere = [&](JOINT joint, Color color, float radius, const Vector3 &offset, const Vector3 &scale) {
+		MeshData part;
+		MeshBuilder::BuildSphere(part, color, NUM_STACK, NUM_SLICE, radius);
+		add(joint, part, offset, scale);
+	};
+	auto cylinder = [&](JOINT joint, Color color, float radius, float height) {
+		MeshData part;
+		MeshBuilder::BuildCylinder(part, color, 1, NUM_SLICE, radius, height);
+		add(joint, part, Vector3(0, -height / 2, 0), Vector3(1, 1, 1));
+	};
+	auto star = [&](JOINT joint, const Vector3 &offset, float length) {
+		MeshData part;
+		MeshBuilder::BuildStar(part, STAR, length);
+		add(joint, part, offset, Vector3(1, 1, 1));
+	};
+	const Vector3 one(1, 1, 1);
+
+	//Hat
+	{
+		MeshData part;
+		MeshBuilder::BuildHat(part, HAT, NUM_STACK, NUM_SLICE, 2.1f);
+		add(JOINT_HAT, part, Vector3(), one);
+	}
+	{
+		MeshData part;
+		MeshBuilder::BuildHatSide(part, HAT, NUM_STACK, NUM_SLICE, 2.4f);
+		add(JOINT_HAT, part, Vector3(0, -0.2f, 0), Vector3(1, 0.15f, 1));
+	}
+	star(JOINT_HAT, Vector3(0, 0.6f, 2.0f), 1.2f);
+
+	//Head
+	sphere(JOINT_HEAD, SKIN, 2, Vector3(), one);
+	sphere(JOINT_HEAD, WHITE, 0.45f, Vector3(0.7f, 0.3f, 1.7f), one);
+	sphere(JOINT_HEAD, BLACK, 0.2f, Vector3(0.7f, 0.3f, 2.1f), one);
+	sphere(JOINT_HEAD, WHITE, 0.45f, Vector3(-0.7f, 0.3f, 1.7f), one);
+	sphere(JOINT_HEAD, BLACK, 0.2f, Vector3(-0.7f, 0.3f, 2.1f), one);
+	{
+		MeshData part;
+		MeshBuilder::BuildMouth(part, WHITE, NUM_STACK, NUM_SLICE, 1.9f);
+		add(JOINT_HEAD, part, Vector3(0, -0.1f, 0.15f), one);
+	}
+	{
+		MeshData part;
+		MeshBuilder::BuildMouth2(part, HAT, NUM_STACK, NUM_SLICE, 0.5f);
+		add(JOINT_HEAD, part, Vector3(0, -0.8f, 1.6f), Vector3(1, 0.5f, 0.5f));
+	}
+
+	//Body
+	{
+		MeshData part;
+		MeshBuilder::BuildBody(part, SUIT, NUM_STACK, NUM_SLICE, 2.5f);
+		add(JOINT_BODY, part, Vector3(), Vector3(1, 1.2f, 0.9f));
+	}
+	sphere(JOINT_BODY, WHITE, 1.6f, Vector3(0, -0.4f, 1.1f), Vector3(1, 1, 0.6f));
+	star(JOINT_BODY, Vector3(0, 0, 2.1f), 1.5f);
+
+	//Arms
+	sphere(JOINT_LEFTSHOULDER, SUIT, 0.8f, Vector3(), one);
+	cylinder(JOINT_LEFTARM, SUIT, 0.5f, 2);
+	cylinder(JOINT_LEFTARM2, SKIN, 0.45f, 2);
+	sphere(JOINT_LEFTHAND, WHITE, 0.6f, Vector3(), one);
+
+	sphere(JOINT_RIGHTSHOULDER, SUIT, 0.8f, Vector3(), one);
+	cylinder(JOINT_RIGHTARM, SUIT, 0.5f, 2);
+	cylinder(JOINT_RIGHTARM2, SKIN, 0.45f, 2);
+	sphere(JOINT_RIGHTHAND, WHITE, 0.6f, Vector3(), one);
+
+	//Legs
+	cylinder(JOINT_LEFTLEG, SUIT, 0.6f, 2);
+	cylinder(JOINT_LEFTLEG2, SUIT, 0.55f, 2);
+	{
+		MeshData part;
+		MeshBuilder::BuildFoot(part, BOOT, NUM_STACK, NUM_SLICE, 1);
+		add(JOINT_LEFTFOOT, part, Vector3(0, 0, 0.4f), Vector3(0.9f, 0.6f, 1.4f));
+	}
+
+	cylinder(JOINT_RIGHTLEG, SUIT, 0.6f, 2);
+	cylinder(JOINT_RIGHTLEG2, SUIT, 0.55f, 2);
+	{
+		MeshData part;
+		MeshBuilder::BuildFoot(part, BOOT, NUM_STACK, NUM_SLICE, 1);
+		add(JOINT_RIGHTFOOT, part, Vector3(0, 0, 0.4f), Vector3(0.9f, 0.6f, 1.4f));
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Sample both clips and blend them by the walk weight into the pose
+
+\param dt - seconds since the last update
+\param walking - blend towards the walk clip, or back to idle
+*/
+/******************************************************************************/
+void Character::Update(float dt, bool walking)
+{
+	if (skeleton.GetJointCount() == 0)
+		return;
+
+	time += dt;
+	if (walking)
+		walkWeight = walkWeight + BLEND_RATE * dt > 1 ? 1 : walkWeight + BLEND_RATE * dt;
+	else
+		walkWeight = walkWeight - BLEND_RATE * dt < 0 ? 0 : walkWeight - BLEND_RATE * dt;
+
+	idle.Sample(time, idlePose);
+	if (walkWeight > 0)
+	{
+		walk.Sample(time, walkPose);
+		BlendPoses(idlePose, walkPose, walkWeight, pose);
+	}
+	else
+	{
+		pose = idlePose;
+	}
+}
+
+unsigned Character::GetJointCount() const
+{
+	return skeleton.GetJointCount();
+}
+
+const Pose& Character::GetPose() const
+{
+	return pose;
+}
+
+//The palette for the mesh's draw; pose may be any of GetJointCount() joints
+void Character::ComputePalette(const Pose &pose, Mtx44 *palette) const
+{
+	skeleton.ComputePalette(pose, palette);
+}
+
+SkinnedMesh* Character::GetMesh() const
+{
+	return mesh;
+}
@@ -0,0 +1,82 @@
+#ifndef CHARACTER_H
+#define CHARACTER_H
+
+#include "Animation.h"
+#include "SkinnedMesh.h"
+
+/******************************************************************************/
+/*!
+		Class Character:
+\brief	The hatted character as one skinned mesh: its body parts are merged
+		in the bind pose, each bound to a joint of an 18 joint skeleton.
+		Every update samples an idle and a walk clip and blends them into
+		the pose. Turning a pose into the joint palette is separate, so the
+		renderer can blend the poses of two updates first; drawing it is
+		then one call with the palette in the shader's uniform block.
+*/
+/******************************************************************************/
+class Character
+{
+public:
+	Character();
+	~Character();
+
+	//Skeleton, clips and merged parts; no GL calls, safe on worker threads
+	void Build(SkinnedMeshData &data);
+	//Create the mesh from the built data on the GL thread
+	void Upload(const SkinnedMeshData &data);
+	void Exit();
+
+	//Ease towards the walk clip while walking, back to idle otherwise
+	void Update(float dt, bool walking);
+
+	unsigned GetJointCount() const;
+	const Pose& GetPose() const; //As of the last update
+	void ComputePalette(const Pose &pose, Mtx44 *palette) const;
+	SkinnedMesh* GetMesh() const;
+
+private:
+	enum JOINT
+	{
+		JOINT_ROOT,
+		JOINT_BODY,
+		JOINT_HEAD,
+		JOINT_HAT,
+
+		JOINT_LEFTSHOULDER,
+		JOINT_LEFTARM,
+		JOINT_LEFTARM2,
+		JOINT_LEFTHAND,
+
+		JOINT_RIGHTSHOULDER,
+		JOINT_RIGHTARM,
+		JOINT_RIGHTARM2,
+		JOINT_RIGHTHAND,
+
+		JOINT_LEFTLEG,
+		JOINT_LEFTLEG2,
+		JOINT_LEFTFOOT,
+
+		JOINT_RIGHTLEG,
+		JOINT_RIGHTLEG2,
+		JOINT_RIGHTFOOT,
+
+		NUM_JOINTS,
+	};
+
+	void BuildSkeleton();
+	void BuildClips();
+	void BuildParts(SkinnedMeshData &data) const;
+	Transform Keyed(JOINT joint, float degrees, float axisX, float axisY, float axisZ, float raise = 0) const;
+
+	Skeleton skeleton;
+	AnimationClip idle;
+	AnimationClip walk;
+	Pose idlePose, walkPose, pose;
+	SkinnedMesh *mesh;
+
+	float time;
+	float walkWeight; //0 idle, 1 walking
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <cfloat>
+#include "CollisionWorld.h"
+
+//Slide keeps moving along what it hits this many times
+static const unsigned MAX_SLIDES = 3;
+
+CollisionWorld::CollisionWorld()
+{
+}
+
+CollisionWorld::~CollisionWorld()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Bake a mesh into world space and add it as a collider. Strips and fans are
+unrolled into a triangle list first.
+
+\param data - CPU copy of the mesh, as built by MeshBuilder or loaded
+\param world - the mesh's world matrix
+\param userData - returned with hits on this collider, such as a node
+
+\return false, adding nothing, if the mesh has no triangles
+*/
+/******************************************************************************/
+bool CollisionWorld::Add(const MeshData &data, const Mtx44 &world, unsigned userData)
+{
+	std::vector<unsigned> triangles;
+	if (!MeshBuilder::TriangleIndices(data, triangles))
+		return false;
+
+	const float *m = world.a;
+	std::vector<Vector3> positions(data.vertices.size());
+	for (unsigned i = 0; i < positions.size(); ++i)
+	{
+		const Position &p = data.vertices[i].pos;
+		positions[i].Set(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+			m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+			m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+	}
+
+	m_colliders.push_back(Collider());
+	Collider &collider = m_colliders.back();
+	collider.triangles.Build(&positions[0], positions.size(), &triangles[0], triangles.size());
+	collider.userData = userData;
+	if (collider.triangles.GetTriangleCount() == 0)
+	{
+		m_colliders.pop_back();
+		return false;
+	}
+	m_bvh.Insert(collider.triangles.GetBounds(), m_colliders.size() - 1);
+	return true;
+}
+
+void CollisionWorld::Build()
+{
+	m_bvh.Build();
+}
+
+void CollisionWorld::Clear()
+{
+	m_bvh.Clear();
+	m_colliders.clear();
+}
+
+bool CollisionWorld::Raycast(const Ray &ray, CollisionHit &hit) const
+{
+	std::vector<unsigned> candidates;
+	m_bvh.Query(ray, candidates);
+
+	Ray shortened = ray;
+	bool found = false;
+	for (unsigned i = 0; i < candidates.size(); ++i)
+	{
+		const Collider &collider = m_colliders[candidates[i]];
+		RayHit triangleHit;
+		if (!collider.triangles.Raycast(shortened, triangleHit))
+			continue;
+
+		Vector3 a, b, c;
+		collider.triangles.GetTriangle(triangleHit.triangle, a, b, c);
+		shortened.maxDistance = triangleHit.distance;
+		hit.userData = collider.userData;
+		hit.distance = triangleHit.distance;
+		hit.point = ray.origin + ray.direction * triangleHit.distance;
+		//Facing back along the ray
+		hit.normal = (b - a).Cross(c - a).NormalizedOrZero();
+		if (hit.normal.Dot(ray.direction) > 0)
+			hit.normal = -hit.normal;
+		found = true;
+	}
+	return found;
+}
+
+bool CollisionWorld::Sweep(const Capsule &capsule, const Vector3 &displacement, CollisionHit &hit) const
+{
+	AABB swept = capsule.Bounds();
+	swept.Expand(Capsule(capsule.a + displacement, capsule.b + displacement, capsule.radius).Bounds());
+	std::vector<unsigned> candidates;
+	m_bvh.Query(swept, candidates);
+
+	bool found = false;
+	hit.distance = FLT_MAX;
+	for (unsigned i = 0; i < candidates.size(); ++i)
+	{
+		const Collider &collider = m_colliders[candidates[i]];
+		SweepHit sweepHit;
+		if (!collider.triangles.SweepCapsule(capsule, displacement, sweepHit) || sweepHit.fraction >= hit.distance)
+			continue;
+
+		hit.userData = collider.userData;
+		hit.distance = sweepHit.fraction;
+		hit.point = sweepHit.point;
+		hit.normal = sweepHit.normal;
+		found = true;
+	}
+	return found;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Move to the first contact, drop the part of the remaining move into the
+surface and carry on with the rest, so walking into a wall at an angle runs
+along it
+
+\param capsule - the capsule at the start
+\param displacement - the move wanted
+
+\return The move made, displacement itself if nothing is in the way
+*/
+/******************************************************************************/
+Vector3 CollisionWorld::Slide(const Capsule &capsule, const Vector3 &displacement) const
+{
+	Capsule moving = capsule;
+	Vector3 moved, remaining = displacement;
+	for (unsigned i = 0; i < MAX_SLIDES && !remaining.IsZero(); ++i)
+	{
+		CollisionHit hit;
+		if (!Sweep(moving, remaining, hit))
+		{
+			moved += remaining;
+			break;
+		}
+
+		Vector3 step = remaining * hit.distance;
+		moved += step;
+		moving.a += step;
+		moving.b += step;
+		remaining -= step;
+		remaining -= hit.normal * remaining.Dot(hit.normal);
+	}
+	return moved;
+}
@@ -0,0 +1,70 @@
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include <vector>
+#include "Bvh.h"
+#include "TriangleBvh.h"
+#include "MeshBuilder.h"
+
+/******************************************************************************/
+/*!
+		Struct CollisionHit:
+\brief	Nearest contact of a pick or sweep: the user value of the collider
+		hit, the contact point and the surface normal there. distance is
+		along the ray for picks, the fraction of the move for sweeps.
+*/
+/******************************************************************************/
+struct CollisionHit
+{
+	unsigned userData;
+	float distance;
+	Vector3 point;
+	Vector3 normal;
+};
+
+/******************************************************************************/
+/*!
+		Class CollisionWorld:
+\brief	Static meshes for picking and collision. Each collider is a mesh's
+		CPU copy baked into world space with a TriangleBvh of its own, and
+		the colliders' boxes go in a Bvh, so a query tests only the
+		triangles near it: O(log n) in both the number of meshes and the
+		triangles of each.
+
+		Baking costs memory per placed mesh but gives exact sweeps under any
+		transform, including non-uniform scale. Colliders do not move;
+		Clear and add them again if the scene changes.
+*/
+/******************************************************************************/
+class CollisionWorld
+{
+public:
+	CollisionWorld();
+	~CollisionWorld();
+
+	//Lines and meshes with no triangles are skipped; returns false for those
+	bool Add(const MeshData &data, const Mtx44 &world, unsigned userData);
+	//Build the tree over the colliders; call after adding them
+	void Build();
+	void Clear();
+
+	//Nearest triangle hit within ray.maxDistance
+	bool Raycast(const Ray &ray, CollisionHit &hit) const;
+	//First contact of the capsule moving by displacement
+	bool Sweep(const Capsule &capsule, const Vector3 &displacement, CollisionHit &hit) const;
+	//How far the capsule gets trying to move by displacement, sliding along
+	//what it touches instead of stopping
+	Vector3 Slide(const Capsule &capsule, const Vector3 &displacement) const;
+
+private:
+	struct Collider
+	{
+		TriangleBvh triangles;
+		unsigned userData;
+	};
+
+	std::vector<Collider> m_colliders;
+	Bvh m_bvh; //Collider boxes, by index
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+#include "CookedMesh.h"
+#include "FileSystem.h"
+
+static const unsigned COOKED_MESH_VERSION = 1;
+
+bool LoadCookedMesh(const char *file_path, MeshData &data)
+{
+	FileData file;
+	if (!FileSystem::Open(file_path, file))
+	{
+		std::cout << "Impossible to open " << file_path << ". Are you in the right directory ?\n";
+		return false;
+	}
+
+	CookedMeshHeader header;
+	if (file.Size() < sizeof(header))
+	{
+		std::cout << "File header error.\n";
+		return false;
+	}
+	memcpy(&header, file.Data(), sizeof(header));
+
+	size_t vertexBytes = (size_t)header.vertexCount * sizeof(Vertex);
+	size_t indexBytes = (size_t)header.indexCount * sizeof(unsigned);
+	if (memcmp(header.magic, "MESH", 4) != 0 ||
+		header.version != COOKED_MESH_VERSION ||
+		header.mode >= Mesh::DRAW_MODE_LAST ||
+		file.Size() < sizeof(header) + vertexBytes + indexBytes)
+	{
+		std::cout << "File header error.\n";
+		return false;
+	}
+
+	const unsigned char *vertices = file.Data() + sizeof(header);
+	const unsigned char *indices = vertices + vertexBytes;
+	data.vertices.resize(header.vertexCount);
+	data.indices.resize(header.indexCount);
+	if (vertexBytes > 0)
+		memcpy((void*)&data.vertices[0], vertices, vertexBytes);
+	if (indexBytes > 0)
+		memcpy(&data.indices[0], indices, indexBytes);
+	data.mode = (Mesh::DRAW_MODE)header.mode;
+
+	return true;
+}
+
+bool SaveCookedMesh(const char *file_path, const MeshData &data)
+{
+	std::ofstream fileStream(file_path, std::ios::binary);
+	if (!fileStream.is_open())
+	{
+		std::cout << "Impossible to write " << file_path << "\n";
+		return false;
+	}
+
+	CookedMeshHeader header;
+	memcpy(header.magic, "MESH", 4);
+	header.version = COOKED_MESH_VERSION;
+	header.mode = data.mode;
+	header.vertexCount = data.vertices.size();
+	header.indexCount = data.indices.size();
+
+	fileStream.write((const char*)&header, sizeof(header));
+	if (!data.vertices.empty())
+		fileStream.write((const char*)&data.vertices[0], data.vertices.size() * sizeof(Vertex));
+	if (!data.indices.empty())
+		fileStream.write((const char*)&data.indices[0], data.indices.size() * sizeof(unsigned));
+
+	return fileStream.good();
+}
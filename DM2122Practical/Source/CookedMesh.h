@@ -0,0 +1,22 @@
+#ifndef COOKED_MESH_H
+#define COOKED_MESH_H
+
+#include <string>
+#include "MeshBuilder.h"
+
+//Cooked meshes store MeshData as raw arrays, ready to copy into a VBO/IBO:
+//header, then vertexCount Vertex structs, then indexCount unsigned indices
+struct CookedMeshHeader
+{
+	char magic[4];				// "MESH"
+	unsigned version;
+	unsigned mode;				// Mesh::DRAW_MODE
+	unsigned vertexCount;
+	unsigned indexCount;
+};
+
+bool LoadCookedMesh(const char *file_path, MeshData &data);
+
+bool SaveCookedMesh(const char *file_path, const MeshData &data);
+
+#endif
@@ -0,0 +1,58 @@
+#include <cmath>
+#include "EntitySystems.h"
+
+void EntitySystems::Animate(EntityWorld &world, ThreadPool &pool, float dt)
+{
+	world.ForEachChunk(COMPONENT_TRANSFORM | COMPONENT_ANIMATION, pool, [dt](Archetype &archetype, unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+		{
+			AnimationComponent &animation = archetype.animations[i];
+			animation.angle += animation.speed * dt;
+
+			if (animation.minAngle < animation.maxAngle)
+			{
+				//Bounce off the limits, turning around
+				if (animation.angle > animation.maxAngle)
+				{
+					animation.angle = animation.maxAngle;
+					animation.speed = -std::fabs(animation.speed);
+				}
+				else if (animation.angle < animation.minAngle)
+				{
+					animation.angle = animation.minAngle;
+					animation.speed = std::fabs(animation.speed);
+				}
+			}
+			else
+			{
+				//Keep the angle small so float precision does not run out
+				animation.angle = std::fmod(animation.angle, 360.f);
+			}
+
+			Quaternion swing;
+			swing.SetToRotation(animation.angle, animation.axis.x, animation.axis.y, animation.axis.z);
+			archetype.transforms[i].local.rotation = animation.rest * swing;
+		}
+	});
+}
+
+void EntitySystems::UpdateTransforms(EntityWorld &world, ThreadPool &pool)
+{
+	world.ForEachChunk(COMPONENT_TRANSFORM, pool, [](Archetype &archetype, unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+		{
+			archetype.transforms[i].world = archetype.transforms[i].local.GetMatrix();
+		}
+	});
+}
+
+void EntitySystems::UpdateLights(EntityWorld &world, ThreadPool &pool)
+{
+	world.ForEachChunk(COMPONENT_TRANSFORM | COMPONENT_LIGHT, pool, [](Archetype &archetype, unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+		{
+			const Mtx44 &matrix = archetype.transforms[i].world;
+			archetype.lights[i].light->position.Set(matrix.a[12], matrix.a[13], matrix.a[14]);
+		}
+	});
+}
@@ -0,0 +1,25 @@
+#ifndef ENTITY_SYSTEMS_H
+#define ENTITY_SYSTEMS_H
+
+#include "EntityWorld.h"
+
+/******************************************************************************/
+/*!
+\brief
+Systems over an EntityWorld, each a pass over the archetypes with the
+components it needs, run in chunks across the pool. Run them in the order
+declared: animation writes local transforms, which make world matrices,
+which place the lights.
+*/
+/******************************************************************************/
+namespace EntitySystems
+{
+	//Advance every AnimationComponent by dt seconds and set the local rotation
+	void Animate(EntityWorld &world, ThreadPool &pool, float dt);
+	//world = local.GetMatrix() for every TransformComponent
+	void UpdateTransforms(EntityWorld &world, ThreadPool &pool);
+	//Move every light to the translation of its world matrix
+	void UpdateLights(EntityWorld &world, ThreadPool &pool);
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include <cassert>
+#include "EntityWorld.h"
+
+const EntityWorld::EntityID EntityWorld::NO_ENTITY;
+const unsigned EntityWorld::CHUNK_SIZE;
+
+EntityWorld::EntityWorld()
+{
+}
+
+EntityWorld::~EntityWorld()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Add an entity to the end of the archetype for mask, creating the archetype
+the first time the mask is seen
+
+\param mask - COMPONENT bits of the entity
+
+\return ID of the new entity
+*/
+/******************************************************************************/
+EntityWorld::EntityID EntityWorld::Create(ComponentMask mask)
+{
+	unsigned index;
+	Archetype &archetype = FindArchetype(mask, index);
+
+	EntityID entity = m_locations.size();
+	Location location = { index, archetype.Size() };
+	m_locations.push_back(location);
+
+	archetype.entities.push_back(entity);
+	if (mask & COMPONENT_TRANSFORM)
+		archetype.transforms.push_back(TransformComponent());
+	if (mask & COMPONENT_ANIMATION)
+		archetype.animations.push_back(AnimationComponent());
+	if (mask & COMPONENT_RENDER)
+		archetype.renders.push_back(RenderComponent());
+	if (mask & COMPONENT_LIGHT)
+		archetype.lights.push_back(LightComponent());
+	return entity;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Remove an entity by moving the last row of its archetype into its place, so
+the arrays stay packed
+
+\param entity - entity to destroy; its ID is not reused
+*/
+/******************************************************************************/
+void EntityWorld::Destroy(EntityID entity)
+{
+	Location location = Locate(entity);
+	Archetype &archetype = m_archetypes[location.archetype];
+	unsigned last = archetype.Size() - 1;
+
+	if (location.row != last)
+	{
+		EntityID moved = archetype.entities[last];
+		archetype.entities[location.row] = moved;
+		if (archetype.mask & COMPONENT_TRANSFORM)
+			archetype.transforms[location.row] = archetype.transforms[last];
+		if (archetype.mask & COMPONENT_ANIMATION)
+			archetype.animations[location.row] = archetype.animations[last];
+		if (archetype.mask & COMPONENT_RENDER)
+			archetype.renders[location.row] = archetype.renders[last];
+		if (archetype.mask & COMPONENT_LIGHT)
+			archetype.lights[location.row] = archetype.lights[last];
+		m_locations[moved].row = location.row;
+	}
+
+	archetype.entities.pop_back();
+	if (archetype.mask & COMPONENT_TRANSFORM)
+		archetype.transforms.pop_back();
+	if (archetype.mask & COMPONENT_ANIMATION)
+		archetype.animations.pop_back();
+	if (archetype.mask & COMPONENT_RENDER)
+		archetype.renders.pop_back();
+	if (archetype.mask & COMPONENT_LIGHT)
+		archetype.lights.pop_back();
+	m_locations[entity].archetype = NO_ENTITY;
+}
+
+void EntityWorld::Clear()
+{
+	m_archetypes.clear();
+	m_locations.clear();
+}
+
+bool EntityWorld::IsAlive(EntityID entity) const
+{
+	return entity < m_locations.size() && m_locations[entity].archetype != NO_ENTITY;
+}
+
+ComponentMask EntityWorld::GetMask(EntityID entity) const
+{
+	return m_archetypes[Locate(entity).archetype].mask;
+}
+
+TransformComponent& EntityWorld::GetTransform(EntityID entity)
+{
+	const Location &location = Locate(entity);
+	assert(m_archetypes[location.archetype].mask & COMPONENT_TRANSFORM);
+	return m_archetypes[location.archetype].transforms[location.row];
+}
+
+AnimationComponent& EntityWorld::GetAnimation(EntityID entity)
+{
+	const Location &location = Locate(entity);
+	assert(m_archetypes[location.archetype].mask & COMPONENT_ANIMATION);
+	return m_archetypes[location.archetype].animations[location.row];
+}
+
+RenderComponent& EntityWorld::GetRender(EntityID entity)
+{
+	const Location &location = Locate(entity);
+	assert(m_archetypes[location.archetype].mask & COMPONENT_RENDER);
+	return m_archetypes[location.archetype].renders[location.row];
+}
+
+LightComponent& EntityWorld::GetLight(EntityID entity)
+{
+	const Location &location = Locate(entity);
+	assert(m_archetypes[location.archetype].mask & COMPONENT_LIGHT);
+	return m_archetypes[location.archetype].lights[location.row];
+}
+
+/******************************************************************************/
+/*!
+\brief
+Run body over every matching chunk on the pool. The chunks of all matching
+archetypes go into one ParallelFor, so small archetypes do not leave the
+workers idle between them.
+
+\param required - COMPONENT bits an archetype must have
+\param pool - pool to run the chunks on; this thread helps
+\param body - called with an archetype and a row range of at most CHUNK_SIZE
+*/
+/******************************************************************************/
+void EntityWorld::ForEachChunk(ComponentMask required, ThreadPool &pool, const std::function<void(Archetype &archetype, unsigned begin, unsigned end)> &body)
+{
+	//First chunk of each matching archetype, and one past the last
+	std::vector<unsigned> archetypes;
+	std::vector<unsigned> firstChunk(1, 0);
+	for (unsigned i = 0; i < m_archetypes.size(); ++i)
+	{
+		if (m_archetypes[i].Has(required) && m_archetypes[i].Size() > 0)
+		{
+			archetypes.push_back(i);
+			firstChunk.push_back(firstChunk.back() + (m_archetypes[i].Size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+		}
+	}
+
+	pool.ParallelFor(firstChunk.back(), 1, [&](unsigned begin, unsigned end) {
+		for (unsigned chunk = begin; chunk < end; ++chunk)
+		{
+			unsigned i = 0;
+			while (firstChunk[i + 1] <= chunk)
+			{
+				++i;
+			}
+			Archetype &archetype = m_archetypes[archetypes[i]];
+			unsigned row = (chunk - firstChunk[i]) * CHUNK_SIZE;
+			unsigned rowEnd = row + CHUNK_SIZE < archetype.Size() ? row + CHUNK_SIZE : archetype.Size();
+			body(archetype, row, rowEnd);
+		}
+	});
+}
+
+void EntityWorld::ForEach(ComponentMask required, const std::function<void(Archetype &archetype, unsigned begin, unsigned end)> &body)
+{
+	for (unsigned i = 0; i < m_archetypes.size(); ++i)
+	{
+		if (m_archetypes[i].Has(required) && m_archetypes[i].Size() > 0)
+		{
+			body(m_archetypes[i], 0, m_archetypes[i].Size());
+		}
+	}
+}
+
+Archetype& EntityWorld::FindArchetype(ComponentMask mask, unsigned &index)
+{
+	for (index = 0; index < m_archetypes.size(); ++index)
+	{
+		if (m_archetypes[index].mask == mask)
+		{
+			return m_archetypes[index];
+		}
+	}
+	m_archetypes.push_back(Archetype());
+	m_archetypes.back().mask = mask;
+	return m_archetypes.back();
+}
+
+const EntityWorld::Location& EntityWorld::Locate(EntityID entity) const
+{
+	assert(IsAlive(entity));
+	return m_locations[entity];
+}
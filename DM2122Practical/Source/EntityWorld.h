@@ -0,0 +1,133 @@
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <vector>
+#include <functional>
+#include "Transform.h"
+#include "Mesh.h"
+#include "Light.h"
+#include "ThreadPool.h"
+
+//Component bits; an entity's mask picks its archetype
+enum COMPONENT
+{
+	COMPONENT_TRANSFORM = 1,
+	COMPONENT_ANIMATION = 2,
+	COMPONENT_RENDER = 4,
+	COMPONENT_LIGHT = 8,
+};
+typedef unsigned ComponentMask;
+
+struct TransformComponent
+{
+	Transform local;
+	Mtx44 world; //As of the last UpdateTransforms
+};
+
+//Rotation about one axis, either spinning or swinging between two limits
+struct AnimationComponent
+{
+	Quaternion rest; //Rotation at angle 0
+	Vector3 axis; //Must not be a zero vector
+	float angle; //Degrees
+	float speed; //Degrees per second; the sign is the direction
+	float minAngle, maxAngle; //Swing between these; equal to spin forever
+
+	AnimationComponent() : axis(0, 1, 0), angle(0), speed(0), minAngle(0), maxAngle(0) {}
+};
+
+struct RenderComponent
+{
+	Mesh *mesh; //Not owned
+	const Material *material; //NULL for the mesh's own
+	bool enableLight;
+
+	RenderComponent() : mesh(NULL), material(NULL), enableLight(true) {}
+};
+
+struct LightComponent
+{
+	Light *light; //Not owned; its position follows the entity
+
+	LightComponent() : light(NULL) {}
+};
+
+/******************************************************************************/
+/*!
+		Struct Archetype:
+\brief	Every entity with the same component mask, each component type in
+		its own array so a system streams only the components it uses.
+		Arrays of components outside the mask stay empty. Row i of every
+		array belongs to entities[i].
+*/
+/******************************************************************************/
+struct Archetype
+{
+	ComponentMask mask;
+	std::vector<unsigned> entities;
+	std::vector<TransformComponent> transforms;
+	std::vector<AnimationComponent> animations;
+	std::vector<RenderComponent> renders;
+	std::vector<LightComponent> lights;
+
+	unsigned Size() const { return entities.size(); }
+	bool Has(ComponentMask required) const { return (mask & required) == required; }
+};
+
+/******************************************************************************/
+/*!
+		Class EntityWorld:
+\brief	Entities grouped into archetypes by their component mask. An entity
+		is only an ID; its components live in its archetype's arrays and
+		move when other entities are destroyed, so hold IDs, not pointers.
+
+		Systems walk archetypes in chunks of CHUNK_SIZE rows, and ForEachChunk
+		runs the chunks across a ThreadPool. Entities must not be created or
+		destroyed while chunks are running.
+*/
+/******************************************************************************/
+class EntityWorld
+{
+public:
+	typedef unsigned EntityID;
+	static const EntityID NO_ENTITY = 0xFFFFFFFF;
+	static const unsigned CHUNK_SIZE = 256;
+
+	EntityWorld();
+	~EntityWorld();
+
+	//New entity with default components for every bit in mask
+	EntityID Create(ComponentMask mask);
+	void Destroy(EntityID entity);
+	void Clear();
+
+	bool IsAlive(EntityID entity) const;
+	ComponentMask GetMask(EntityID entity) const;
+
+	//The entity must have the component
+	TransformComponent& GetTransform(EntityID entity);
+	AnimationComponent& GetAnimation(EntityID entity);
+	RenderComponent& GetRender(EntityID entity);
+	LightComponent& GetLight(EntityID entity);
+
+	//Call body on every chunk of every archetype with all of the required
+	//components, spread over pool; returns once every chunk is done
+	void ForEachChunk(ComponentMask required, ThreadPool &pool, const std::function<void(Archetype &archetype, unsigned begin, unsigned end)> &body);
+	//The same on this thread, in order, e.g. for drawing
+	void ForEach(ComponentMask required, const std::function<void(Archetype &archetype, unsigned begin, unsigned end)> &body);
+
+private:
+	struct Location
+	{
+		unsigned archetype; //NO_ENTITY once destroyed
+		unsigned row;
+	};
+
+	Archetype& FindArchetype(ComponentMask mask, unsigned &index);
+	const Location& Locate(EntityID entity) const;
+
+	std::vector<Archetype> m_archetypes;
+	std::vector<Location> m_locations; //Per EntityID
+};
+
+#endif
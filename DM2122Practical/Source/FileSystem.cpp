@@ -0,0 +1,194 @@
+#include <iostream>
+#include <cstring>
+#include <string>
+
+#include "FileSystem.h"
+#include "PackFile.h"
+
+FileData::FileData()
+	: m_data(NULL)
+	, m_size(0)
+{
+}
+
+void FileData::Close()
+{
+	m_file.Close();
+	m_buffer.clear();
+	m_data = NULL;
+	m_size = 0;
+}
+
+struct FileSystem::Pack
+{
+	MappedFile file;
+	const PackEntry *entries;
+	unsigned entryCount;
+	const char *names;
+
+	const PackEntry* Find(const std::string &name) const
+	{
+		//The table of contents is sorted by name
+		unsigned low = 0;
+		unsigned high = entryCount;
+		while (low < high)
+		{
+			unsigned mid = (low + high) / 2;
+			int order = strcmp(names + entries[mid].nameOffset, name.c_str());
+			if (order == 0)
+			{
+				return &entries[mid];
+			}
+			if (order < 0)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return NULL;
+	}
+};
+
+std::vector<FileSystem::Pack*> FileSystem::s_packs;
+
+/******************************************************************************/
+/*!
+\brief
+Map a pack and check its table of contents so lookups never read outside it
+
+\param pack_path - path of pack file
+
+\return true if the pack is mounted
+*/
+/******************************************************************************/
+bool FileSystem::Mount(const char *pack_path)
+{
+	Pack *pack = new Pack;
+	if (!pack->file.Open(pack_path))
+	{
+		std::cout << "Impossible to open " << pack_path << ". Are you in the right directory ?\n";
+		delete pack;
+		return false;
+	}
+
+	const unsigned char *data = pack->file.Data();
+	size_t size = pack->file.Size();
+
+	PackHeader header;
+	bool valid = size >= sizeof(header);
+	if (valid)
+	{
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, "PACK", 4) == 0 && header.version == PACK_VERSION &&
+			header.entryCount <= (size - sizeof(header)) / sizeof(PackEntry) &&
+			header.nameTableSize <= size - sizeof(header) - header.entryCount * sizeof(PackEntry);
+	}
+	if (valid)
+	{
+		pack->entries = (const PackEntry*)(data + sizeof(header));
+		pack->entryCount = header.entryCount;
+		pack->names = (const char*)(pack->entries + header.entryCount);
+
+		//Every name must end inside the table, every entry inside the file,
+		//and the names must be sorted for Find
+		for (unsigned i = 0; valid && i < pack->entryCount; ++i)
+		{
+			const PackEntry &entry = pack->entries[i];
+			valid = entry.nameOffset < header.nameTableSize &&
+				memchr(pack->names + entry.nameOffset, 0, header.nameTableSize - entry.nameOffset) != NULL &&
+				entry.offset <= size && entry.storedSize <= size - entry.offset &&
+				((entry.flags & PackEntry::FLAG_COMPRESSED) || entry.storedSize == entry.size) &&
+				(i == 0 || strcmp(pack->names + pack->entries[i - 1].nameOffset, pack->names + entry.nameOffset) < 0);
+		}
+	}
+	if (!valid)
+	{
+		std::cout << "File header error.\n";
+		delete pack;
+		return false;
+	}
+
+	s_packs.push_back(pack);
+	return true;
+}
+
+void FileSystem::UnmountAll()
+{
+	for (unsigned i = 0; i < s_packs.size(); ++i)
+	{
+		delete s_packs[i];
+	}
+	s_packs.clear();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Open a file from the newest pack holding it, or from disk
+
+\param file_path - path as used for the loose file, e.g. "Image//front.tga"
+\param file - receives the contents
+
+\return true if the file was found and read
+*/
+/******************************************************************************/
+bool FileSystem::Open(const char *file_path, FileData &file)
+{
+	file.Close();
+
+	if (!s_packs.empty())
+	{
+		std::string name = NormalizePackPath(file_path);
+		for (unsigned i = s_packs.size(); i-- > 0;)
+		{
+			const PackEntry *entry = s_packs[i]->Find(name);
+			if (!entry)
+			{
+				continue;
+			}
+
+			const unsigned char *stored = s_packs[i]->file.Data() + entry->offset;
+			if (entry->flags & PackEntry::FLAG_COMPRESSED)
+			{
+				file.m_buffer.resize(entry->size);
+				if (!DecompressBlock(stored, entry->storedSize, file.m_buffer.empty() ? NULL : &file.m_buffer[0], entry->size))
+				{
+					std::cout << "Corrupt pack entry " << name << "\n";
+					file.m_buffer.clear();
+					return false;
+				}
+				//Empty entries keep pointing at their slot so they still open
+				if (!file.m_buffer.empty())
+				{
+					stored = &file.m_buffer[0];
+				}
+			}
+
+			file.m_data = stored;
+			file.m_size = entry->size;
+			return true;
+		}
+	}
+
+	if (!file.m_file.Open(file_path))
+	{
+		return false;
+	}
+	file.m_data = file.m_file.Data();
+	file.m_size = file.m_file.Size();
+	return true;
+}
+
+bool FileSystem::Exists(const char *file_path)
+{
+	std::string name = NormalizePackPath(file_path);
+	for (unsigned i = 0; i < s_packs.size(); ++i)
+	{
+		if (s_packs[i]->Find(name))
+		{
+			return true;
+		}
+	}
+
+	MappedFile file;
+	return file.Open(file_path);
+}
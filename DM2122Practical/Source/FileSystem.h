@@ -0,0 +1,61 @@
+#ifndef FILE_SYSTEM_H
+#define FILE_SYSTEM_H
+
+#include <cstddef>
+#include <vector>
+#include "MappedFile.h"
+
+/******************************************************************************/
+/*!
+		Class FileData:
+\brief	Contents of a file opened through FileSystem. Uncompressed pack
+		entries point straight into the mapped pack, compressed entries are
+		decoded into a buffer and loose files are mapped on their own.
+*/
+/******************************************************************************/
+class FileData
+{
+public:
+	FileData();
+
+	void Close();
+
+	bool IsOpen() const { return m_data != NULL; }
+	const unsigned char* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	FileData(const FileData&);
+	FileData& operator=(const FileData&);
+
+	friend class FileSystem;
+
+	MappedFile m_file;					// loose file
+	std::vector<unsigned char> m_buffer; // decompressed pack entry
+	const unsigned char *m_data;
+	size_t m_size;
+};
+
+/******************************************************************************/
+/*!
+		Class FileSystem:
+\brief	Virtual file system over packs and loose files. Mounted packs are
+		searched newest first, then the path is tried as a loose file. Mount
+		and Unmount before starting worker threads; Open is thread safe.
+*/
+/******************************************************************************/
+class FileSystem
+{
+public:
+	static bool Mount(const char *pack_path);
+	static void UnmountAll();			// Invalidates FileData pointing into packs
+
+	static bool Open(const char *file_path, FileData &file);
+	static bool Exists(const char *file_path);
+
+private:
+	struct Pack;
+	static std::vector<Pack*> s_packs;
+};
+
+#endif
@@ -1,8 +1,10 @@
 #include <iostream>
-#include <fstream>
+#include <cstring>
+#include <algorithm>
 #include <map>
 
 #include "LoadOBJ.h"
+#include "FileSystem.h"
 
 bool LoadOBJ(
 	const char *file_path,
@@ -11,8 +13,8 @@ bool LoadOBJ(
 	std::vector<Vector3> & out_normals
 )
 {
-	std::ifstream fileStream(file_path, std::ios::binary);
-	if (!fileStream.is_open())
+	FileData file;
+	if (!FileSystem::Open(file_path, file))
 	{
 		std::cout << "Impossible to open " << file_path << ". Are you in the right directory ?\n";
 		return false;
@@ -23,10 +25,19 @@ bool LoadOBJ(
 	std::vector<TexCoord> temp_uvs;
 	std::vector<Vector3> temp_normals;
 
-	while (!fileStream.eof())
+	const char *cursor = (const char*)file.Data();
+	const char *end = cursor + file.Size();
+	while (cursor < end)
 	{
+		//Copy out one line, cut to the buffer size
+		const char *lineEnd = (const char*)memchr(cursor, '\n', end - cursor);
+		if (!lineEnd)
+			lineEnd = end;
 		char buf[256];
-		fileStream.getline(buf, 256);
+		size_t length = std::min((size_t)(lineEnd - cursor), sizeof(buf) - 1);
+		memcpy(buf, cursor, length);
+		buf[length] = '\0';
+		cursor = lineEnd < end ? lineEnd + 1 : end;
 		if (strncmp("v ", buf, 2) == 0)
 		{
 			Position vertex;
@@ -96,7 +107,7 @@ bool LoadOBJ(
 			}
 		}
 	}
-	fileStream.close();
+	file.Close();
 
 	// For each vertex of each triangle
 	for (unsigned i = 0; i < vertexIndices.size(); ++i)
@@ -1,52 +1,237 @@
 
 #include <iostream>
-#include <fstream>
+#include <cstring>
 #include <GL\glew.h>
 
 #include "LoadTGA.h"
+#include "FileSystem.h"
 
-GLuint LoadTGA(const char *file_path)				// load TGA file to memory
+//TGA image types we can decode
+enum TGA_TYPE
 {
-	std::ifstream fileStream(file_path, std::ios::binary);
-	if(!fileStream.is_open()) {
-		std::cout << "Impossible to open " << file_path << ". Are you in the right directory ?\n";
-		return 0;
+	TGA_TRUECOLOR = 2,
+	TGA_GRAYSCALE = 3,
+	TGA_RLE_TRUECOLOR = 10,
+	TGA_RLE_GRAYSCALE = 11,
+};
+
+//Describes the pixel data of a TGA file in place, inside its file mapping or pack entry
+struct TGAImage
+{
+	const GLubyte *pixels;		// first byte after header, image ID and colour map
+	const GLubyte *end;			// end of the file
+	unsigned width, height;
+	unsigned bytesPerPixel;
+	bool rle;
+	bool topDown;				// descriptor bit 5, rows are stored top to bottom
+};
+
+static bool ParseTGA(const FileData &file, TGAImage &image)	// read TGA header without copying
+{
+	if (file.Size() < 18)
+		return false;
+
+	const GLubyte *header = file.Data();
+	unsigned idLength = header[0];
+	unsigned colorMapType = header[1];
+	unsigned imageType = header[2];
+	unsigned colorMapLength = header[5] + header[6] * 256;
+	unsigned colorMapEntrySize = header[7];
+	unsigned bitsPerPixel = header[16];
+
+	image.width = header[12] + header[13] * 256;
+	image.height = header[14] + header[15] * 256;
+	image.rle = imageType == TGA_RLE_TRUECOLOR || imageType == TGA_RLE_GRAYSCALE;
+	image.topDown = (header[17] & 0x20) != 0;
+
+	bool grayscale = imageType == TGA_GRAYSCALE || imageType == TGA_RLE_GRAYSCALE;
+	bool truecolor = imageType == TGA_TRUECOLOR || imageType == TGA_RLE_TRUECOLOR;
+	if (image.width == 0 ||
+		image.height == 0 ||
+		(!(truecolor && (bitsPerPixel == 24 || bitsPerPixel == 32)) &&
+		 !(grayscale && bitsPerPixel == 8)))
+	{
+		return false;
 	}
+	image.bytesPerPixel = bitsPerPixel / 8;
 
-	GLubyte		header[ 18 ];									// first 6 useful header bytes
-	GLuint		bytesPerPixel;								    // number of bytes per pixel in TGA gile
-	GLuint		imageSize;									    // for setting memory
-	GLubyte *	data;
-	GLuint		texture = 0;
-	unsigned	width, height;
+	//Skip the image ID field and any colour map that precedes the pixels
+	size_t offset = 18 + idLength;
+	if (colorMapType != 0)
+		offset += colorMapLength * ((colorMapEntrySize + 7) / 8);
+	if (offset > file.Size())
+		return false;
 
-	fileStream.read((char*)header, 18);
-	width = header[12] + header[13] * 256;
-	height = header[14] + header[15] * 256;
+	image.pixels = header + offset;
+	image.end = header + file.Size();
+	return true;
+}
 
- 	if(	width <= 0 ||								// is width <= 0
-		height <= 0 ||								// is height <=0
-		(header[16] != 24 && header[16] != 32))		// is TGA 24 or 32 Bit
+//Replicate one pixel count times, doubling the copied span each pass
+static void FillPixels(GLubyte *out, const GLubyte *pixel, unsigned bytesPerPixel, unsigned count)
+{
+	unsigned total = count * bytesPerPixel;
+	unsigned filled = bytesPerPixel;
+	memcpy(out, pixel, bytesPerPixel);
+	while (filled < total)
 	{
-		fileStream.close();							// close file on failure
-		std::cout << "File header error.\n";
-		return 0;										
+		unsigned span = filled < total - filled ? filled : total - filled;
+		memcpy(out + filled, out, span);
+		filled += span;
 	}
+}
 
-	bytesPerPixel	= header[16] / 8;						//divide by 8 to get bytes per pixel
-	imageSize		= width * height * bytesPerPixel;	// calculate memory required for TGA data
-	
-	data = new GLubyte[ imageSize ];
-	fileStream.seekg(18, std::ios::beg);
-	fileStream.read((char *)data, imageSize);
-	fileStream.close();	
+/******************************************************************************/
+/*!
+\brief
+Decode the pixels of a TGA into dst, which must hold width * height *
+bytesPerPixel bytes. RLE packets are split at row ends so rows can be written
+in either vertical order.
 
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	if(bytesPerPixel == 3)
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
+\param image - parsed TGA
+\param dst - destination pixels
+\param topDown - true to write the top row first, false for the bottom row first
+
+\return false if the pixel data runs past the end of the file
+*/
+/******************************************************************************/
+static bool DecodeTGA(const TGAImage &image, GLubyte *dst, bool topDown)
+{
+	const unsigned bpp = image.bytesPerPixel;
+	const size_t rowSize = image.width * bpp;
+	const bool flip = image.topDown != topDown;
+	const GLubyte *src = image.pixels;
+
+	unsigned remaining = 0;				// pixels left in the current RLE packet
+	bool repeat = false;
+	const GLubyte *pixel = NULL;
+
+	for (unsigned row = 0; row < image.height; ++row)
+	{
+		GLubyte *out = dst + (flip ? image.height - 1 - row : row) * rowSize;
+		if (!image.rle)
+		{
+			if ((size_t)(image.end - src) < rowSize)
+				return false;
+			memcpy(out, src, rowSize);
+			src += rowSize;
+			continue;
+		}
+
+		unsigned x = 0;
+		while (x < image.width)
+		{
+			if (remaining == 0)
+			{
+				if (src >= image.end)
+					return false;
+				GLubyte packet = *src++;
+				remaining = (packet & 0x7F) + 1;
+				repeat = (packet & 0x80) != 0;
+				if (repeat)
+				{
+					if ((size_t)(image.end - src) < bpp)
+						return false;
+					pixel = src;
+					src += bpp;
+				}
+			}
+
+			unsigned count = remaining < image.width - x ? remaining : image.width - x;
+			if (repeat)
+			{
+				FillPixels(out + x * bpp, pixel, bpp, count);
+			}
+			else
+			{
+				if ((size_t)(image.end - src) < count * bpp)
+					return false;
+				memcpy(out + x * bpp, src, count * bpp);
+				src += count * bpp;
+			}
+			x += count;
+			remaining -= count;
+		}
+	}
+	return true;
+}
+
+//GL formats matching the byte layout of TGA pixels
+static void GetTGAFormat(unsigned bytesPerPixel, GLenum &internalFormat, GLenum &format)
+{
+	if (bytesPerPixel == 1)
+	{
+		internalFormat = GL_R8;
+		format = GL_RED;
+	}
+	else if (bytesPerPixel == 3)
+	{
+		internalFormat = GL_RGB;
+		format = GL_BGR;
+	}
 	else //bytesPerPixel == 4
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, data);
+	{
+		internalFormat = GL_RGBA;
+		format = GL_BGRA;
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Allocate the texture image, then decode straight into a mapped pixel unpack
+buffer and let the driver copy it from there asynchronously
+
+\param target - GL_TEXTURE_2D or a cube map face
+\param image - parsed TGA
+\param topDown - row order the target expects
+
+\return false if the TGA could not be decoded
+*/
+/******************************************************************************/
+static bool UploadTGA(GLenum target, const TGAImage &image, bool topDown)
+{
+	GLenum internalFormat, format;
+	GetTGAFormat(image.bytesPerPixel, internalFormat, format);
+
+	GLsizeiptr imageSize = (GLsizeiptr)image.width * image.height * image.bytesPerPixel;
+	glTexImage2D(target, 0, internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, NULL);
+
+	GLuint pixelBuffer;
+	glGenBuffers(1, &pixelBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, imageSize, NULL, GL_STREAM_DRAW);
+
+	GLubyte *dst = (GLubyte*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, imageSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	bool decoded = dst && DecodeTGA(image, dst, topDown);
+	if (dst && glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE)
+		decoded = false;
+
+	if (decoded)
+	{
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(target, 0, 0, 0, image.width, image.height, format, GL_UNSIGNED_BYTE, (void*)0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	//GL keeps the buffer alive until the pending copy has finished
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &pixelBuffer);
+	return decoded;
+}
+
+//Show single channel images as grey instead of red
+static void SetGrayscaleSwizzle(GLenum target)
+{
+	GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+	glTexParameteriv(target, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+}
+
+//Filtering and wrapping of the bound 2D texture
+static void SetTextureParameters(unsigned bytesPerPixel)
+{
+	if (bytesPerPixel == 1)
+		SetGrayscaleSwizzle(GL_TEXTURE_2D);
 
 	//to do: modify the texture parameters code from here
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -55,8 +240,123 @@ GLuint LoadTGA(const char *file_path)				// load TGA file to memory
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
 	//end of modifiable code
+}
+
+GLuint LoadTGA(const char *file_path)				// load TGA file to memory
+{
+	FileData file;
+	if (!FileSystem::Open(file_path, file))
+	{
+		std::cout << "Impossible to open " << file_path << ". Are you in the right directory ?\n";
+		return 0;
+	}
 
-	delete []data;
+	TGAImage image;
+	if (!ParseTGA(file, image))
+	{
+		std::cout << "File header error.\n";
+		return 0;
+	}
+
+	GLuint		texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	if (!UploadTGA(GL_TEXTURE_2D, image, false))
+	{
+		std::cout << "File data error: " << file_path << "\n";
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDeleteTextures(1, &texture);
+		return 0;
+	}
+	SetTextureParameters(image.bytesPerPixel);
+
+	return texture;
+}
+
+bool ReadTGAPixels(const char *file_path, TGAPixels &pixels, bool topDown)	// decode TGA file to memory, no GL calls
+{
+	FileData file;
+	TGAImage image;
+	if (!FileSystem::Open(file_path, file) || !ParseTGA(file, image))
+		return false;
 
-	return texture;						
-}
\ No newline at end of file
+	pixels.width = image.width;
+	pixels.height = image.height;
+	pixels.bytesPerPixel = image.bytesPerPixel;
+	pixels.data.resize((size_t)image.width * image.height * image.bytesPerPixel);
+	return DecodeTGA(image, &pixels.data[0], topDown);
+}
+
+void UploadTGAPixels(GLuint texture, const TGAPixels &pixels)	// (re)specify texture from decoded pixels
+{
+	GLenum internalFormat, format;
+	GetTGAFormat(pixels.bytesPerPixel, internalFormat, format);
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, pixels.width, pixels.height, 0, format, GL_UNSIGNED_BYTE, &pixels.data[0]);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	SetTextureParameters(pixels.bytesPerPixel);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+//Filtering and wrapping of the bound cube map
+static void SetCubemapParameters(bool grayscale)
+{
+	if (grayscale)
+		SetGrayscaleSwizzle(GL_TEXTURE_CUBE_MAP);
+
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+}
+
+GLuint LoadTGACubemap(const char *file_paths[6])	// load 6 TGA files into one cube map
+{
+	GLuint		texture = 0;
+	bool		grayscale = true;
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+	for (unsigned face = 0; face < 6; ++face)
+	{
+		FileData file;
+		TGAImage image;
+		bool loaded = FileSystem::Open(file_paths[face], file) && ParseTGA(file, image);
+
+		//Cube map faces are addressed top row first
+		if (!loaded || !UploadTGA(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, image, true))
+		{
+			std::cout << "Impossible to load " << file_paths[face] << " for cube map.\n";
+			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+			glDeleteTextures(1, &texture);
+			return 0;
+		}
+		grayscale = grayscale && image.bytesPerPixel == 1;
+	}
+	SetCubemapParameters(grayscale);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+	return texture;
+}
+
+void UploadTGACubemapPixels(GLuint texture, const TGAPixels faces[6])	// (re)specify cube map from decoded faces
+{
+	bool grayscale = true;
+
+	glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned face = 0; face < 6; ++face)
+	{
+		GLenum internalFormat, format;
+		GetTGAFormat(faces[face].bytesPerPixel, internalFormat, format);
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, internalFormat, faces[face].width, faces[face].height, 0, format, GL_UNSIGNED_BYTE, &faces[face].data[0]);
+		grayscale = grayscale && faces[face].bytesPerPixel == 1;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	SetCubemapParameters(grayscale);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
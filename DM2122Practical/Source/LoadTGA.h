@@ -1,6 +1,25 @@
 #ifndef LOAD_TGA_H
 #define LOAD_TGA_H
 
+#include <vector>
+
+//Decoded TGA pixels, bottom row first unless read top down
+struct TGAPixels
+{
+	std::vector<unsigned char> data;
+	unsigned width, height;
+	unsigned bytesPerPixel;
+};
+
 GLuint LoadTGA(const char *file_path);
 
+//Faces in GL order: right (+X), left (-X), top (+Y), bottom (-Y), back (+Z), front (-Z)
+GLuint LoadTGACubemap(const char *file_paths[6]);
+
+//Split loading for background streaming: the read makes no GL calls and is
+//safe on worker threads, the upload must run on the GL thread
+bool ReadTGAPixels(const char *file_path, TGAPixels &pixels, bool topDown = false); // topDown for cube map faces
+void UploadTGAPixels(GLuint texture, const TGAPixels &pixels);
+void UploadTGACubemapPixels(GLuint texture, const TGAPixels faces[6]); // faces read top down, in LoadTGACubemap order
+
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile()
+	: m_data(NULL)
+	, m_size(0)
+#ifdef _WIN32
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_mapping(NULL)
+#else
+	, m_file(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Map the whole file read-only. An empty file opens as a failure since it
+cannot be mapped.
+
+\param file_path - path of file to map
+
+\return true if the file is mapped
+*/
+/******************************************************************************/
+bool MappedFile::Open(const char *file_path)
+{
+	Close();
+#ifdef _WIN32
+	m_file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_mapping)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	m_file = open(file_path, O_RDONLY);
+	if (m_file < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(m_file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data != MAP_FAILED)
+	{
+		m_data = (const unsigned char*)data;
+		m_size = (size_t)fileStat.st_size;
+	}
+#endif
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Unmap the file and release its handles
+*/
+/******************************************************************************/
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_mapping = NULL;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data)
+		munmap((void*)m_data, m_size);
+	if (m_file >= 0)
+		close(m_file);
+	m_file = -1;
+#endif
+	m_data = NULL;
+	m_size = 0;
+}
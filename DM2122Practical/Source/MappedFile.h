@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+/******************************************************************************/
+/*!
+		Class MappedFile:
+\brief	Read-only memory mapping of a whole file; the OS pages the contents in
+		on demand so loaders can parse in place without a staging copy
+*/
+/******************************************************************************/
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool Open(const char *file_path);
+	void Close();
+
+	bool IsOpen() const { return m_data != NULL; }
+	const unsigned char* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const unsigned char *m_data;
+	size_t m_size;
+#ifdef _WIN32
+	void *m_file;
+	void *m_mapping;
+#else
+	int m_file;
+#endif
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <string>
 #include "Vertex.h"
 #include "Material.h"
+#include "Bounds.h"
 
 /******************************************************************************/
 /*!
@@ -36,6 +37,7 @@ public:
 	unsigned indexBuffer;
 	unsigned indexSize;
 	unsigned textureID;
+	AABB bounds; //Of the positions, in model space; empty if unknown
 
 	Material material;
 };
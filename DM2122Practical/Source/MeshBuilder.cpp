@@ -4,228 +4,238 @@
 #include "Vertex.h"
 #include "MyMath.h"
 #include "LoadOBJ.h"
+#include "ParametricMesh.h"
+#include "BakedMeshes.h"
+
+//Box of the vertex positions, each multiplied by scale
+static AABB PositionBounds(const Vertex *vertices, unsigned count, float scale = 1)
+{
+	AABB bounds;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		bounds.Expand(Vector3(vertices[i].pos.x * scale, vertices[i].pos.y * scale, vertices[i].pos.z * scale));
+	}
+	return bounds;
+}
+
+//Append the output of a generator to CPU side data
+template<typename Generator>
+static void AppendGenerated(MeshData &data, const Generator &generator)
+{
+	unsigned baseVertex = data.vertices.size();
+	unsigned baseIndex = data.indices.size();
+	data.vertices.resize(baseVertex + generator.VertexCount());
+	data.indices.resize(baseIndex + generator.IndexCount());
+	generator.Write(&data.vertices[baseVertex], &data.indices[baseIndex], baseVertex);
+
+	data.mode = generator.Mode();
+}
 
 /******************************************************************************/
 /*!
 \brief
-Generate the vertices of a reference Axes; Use red for x-axis, green for y-axis, blue for z-axis
-Then generate the VBO/IBO and store them in Mesh object
+Create a mesh and generate its contents straight into the mapped VBO/IBO, so
+no intermediate vertex or index arrays are allocated. Falls back to a MeshData
+upload if the buffers cannot be mapped or their contents are lost on unmap.
 
 \param meshName - name of mesh
-\param lengthX - x-axis should start at -lengthX / 2 and end at lengthX / 2
-\param lengthY - y-axis should start at -lengthY / 2 and end at lengthY / 2
-\param lengthZ - z-axis should start at -lengthZ / 2 and end at lengthZ / 2
+\param generator - ParametricMesh or BakedCopy producing Vertex
 
-\return Pointer to mesh storing VBO/IBO of reference axes
+\return Pointer to mesh storing VBO/IBO of the generated data
 */
 /******************************************************************************/
-Mesh* MeshBuilder::GenerateAxes(const std::string &meshName, float lengthX, float lengthY, float lengthZ)
+template<typename Generator>
+static Mesh* CreateGenerated(const std::string &meshName, const Generator &generator)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	v.pos.Set(-1000, 0, 0);
-	v.color.Set(1, 0, 0);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(1000, 0, 0);
-	v.color.Set(1, 0, 0);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0, -1000, 0);
-	v.color.Set(0, 1, 0);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0, 1000, 0);
-	v.color.Set(0, 1, 0);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0, 0, -1000);
-	v.color.Set(0, 0, 1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0, 0, 1000);
-	v.color.Set(0, 0, 1);
-	vertex_buffer_data.push_back(v);
-
-	std::vector<GLuint> index_buffer_data;
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(4);
-	index_buffer_data.push_back(5);
-
+	typedef typename Generator::VertexType VertexType;
 	Mesh *mesh = new Mesh(meshName);
+	if (generator.VertexCount() == 0 || generator.IndexCount() == 0)
+	{
+		return mesh;
+	}
 
+	GLsizeiptr vertexSize = generator.VertexCount() * sizeof(VertexType);
+	GLsizeiptr indexSize = generator.IndexCount() * sizeof(GLuint);
 	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-
+	glBufferData(GL_ARRAY_BUFFER, vertexSize, NULL, GL_STATIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, NULL, GL_STATIC_DRAW);
+
+	const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	VertexType *vertices = (VertexType*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexSize, access);
+	GLuint *indices = (GLuint*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indexSize, access);
+	bool written = vertices && indices;
+	if (written)
+	{
+		generator.Write(vertices, indices);
+	}
+	if (vertices && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+	{
+		written = false;
+	}
+	if (indices && glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE)
+	{
+		written = false;
+	}
 
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_LINES;
+	if (!written)
+	{
+		MeshData data;
+		AppendGenerated(data, generator);
+		MeshBuilder::Upload(mesh, data);
+		return mesh;
+	}
 
+	mesh->indexSize = generator.IndexCount();
+	mesh->mode = generator.Mode();
+	mesh->bounds = generator.Bounds();
 	return mesh;
 }
 
+//A baked mesh copied as is, or recolored and scaled on the way, for the
+//primitives that take a color and size
+class BakedCopy
+{
+public:
+	typedef Vertex VertexType;
+
+	BakedCopy(const BakedMesh &baked) : baked(baked), recolor(false), scale(1) {}
+	BakedCopy(const BakedMesh &baked, Color color, float scale) : baked(baked), recolor(true), color(color), scale(scale) {}
+
+	unsigned VertexCount() const { return baked.vertexCount; }
+	unsigned IndexCount() const { return baked.indexCount; }
+	Mesh::DRAW_MODE Mode() const { return baked.mode; }
+	AABB Bounds() const { return PositionBounds(baked.vertices, baked.vertexCount, recolor ? scale : 1); }
+
+	void Write(Vertex *vertices, unsigned *indices, unsigned baseVertex = 0) const
+	{
+		for (unsigned i = 0; i < baked.vertexCount; ++i)
+		{
+			Vertex v = baked.vertices[i];
+			if (recolor)
+			{
+				v.pos.Set(v.pos.x * scale, v.pos.y * scale, v.pos.z * scale);
+				v.color = color;
+			}
+			vertices[i] = v;
+		}
+		for (unsigned i = 0; i < baked.indexCount; ++i)
+		{
+			indices[i] = baseVertex + baked.indices[i];
+		}
+	}
+
+private:
+	const BakedMesh &baked;
+	bool recolor;
+	Color color;
+	float scale;
+};
+
+//The sphere family only differs in how far the patch sweeps
+static ParametricMesh<SphereSurface, ColoredVertex> SpherePatch(Color color, unsigned numStack, unsigned numSlice, float radius, float stackDegrees, float sliceDegrees)
+{
+	return MakeParametricMesh(SphereSurface(numStack, numSlice, radius, stackDegrees, sliceDegrees), ColoredVertex(color), numStack, numSlice);
+}
+
+static ParametricMesh<CylinderSurface, ColoredVertex> Cylinder(Color color, unsigned numStack, unsigned numSlice, float radius, float height)
+{
+	return MakeParametricMesh(CylinderSurface(numStack, numSlice, radius, height), ColoredVertex(color), numStack, numSlice);
+}
+
+static ParametricMesh<ConeSurface, ColoredVertex> Cone(Color color, unsigned numSlice, float radius, float height)
+{
+	return MakeParametricMesh(ConeSurface(numSlice, radius, height), ColoredVertex(color), 1, numSlice);
+}
+
 /******************************************************************************/
 /*!
 \brief
-Generate the vertices of a quad; Use random color for each vertex
+Generate the vertices of a reference Axes; Use red for x-axis, green for y-axis, blue for z-axis
 Then generate the VBO/IBO and store them in Mesh object
 
+Each axis runs from -1000 to 1000
+
 \param meshName - name of mesh
-\param lengthX - width of quad
-\param lengthY - height of quad
 
-\return Pointer to mesh storing VBO/IBO of quad
+\return Pointer to mesh storing VBO/IBO of reference axes
 */
 /******************************************************************************/
-Mesh* MeshBuilder::GenerateQuad(const std::string &meshName, Color color, float length)
+Mesh* MeshBuilder::GenerateAxes(const std::string &meshName)
 {
-	// An array of 3 vectors which represents 3 vertices
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	v.pos.Set(-0.5f * length, -0.5f * length, 0); v.color = color;
-	v.normal.Set(-1, -1, 1);
-	v.texCoord.Set(0, 0);
-	vertex_buffer_data.push_back(v);
-
-	v.pos.Set(0.5f * length, -0.5f * length, 0); v.color = color;
-	v.normal.Set(1, -1, 1);
-	v.texCoord.Set(1, 0);
-	vertex_buffer_data.push_back(v);
-
-	v.pos.Set(0.5f * length, 0.5f * length, 0); v.color = color;
-	v.normal.Set(1, 1, 1);
-	v.texCoord.Set(1, 1);
-	vertex_buffer_data.push_back(v);
-
-	v.pos.Set(-0.5f * length, 0.5f * length, 0); v.color = color;
-	v.normal.Set(-1, 1, 1);
-	v.texCoord.Set(0, 1);
-	vertex_buffer_data.push_back(v);
-
-	std::vector<GLuint> index_buffer_data;
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(0);
+	return Create(meshName, BakedMeshes::AXES);
+}
 
-	Mesh *mesh = new Mesh(meshName);
+void MeshBuilder::BuildAxes(MeshData &data)
+{
+	AppendGenerated(data, BakedCopy(BakedMeshes::AXES));
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+/******************************************************************************/
+/*!
+\brief
+Generate the vertices of a quad; Use random color for each vertex
+Then generate the VBO/IBO and store them in Mesh object
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+\param meshName - name of mesh
+\param color - color of every vertex
+\param length - width and height of quad
 
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLES;
+\return Pointer to mesh storing VBO/IBO of quad
+*/
+/******************************************************************************/
+Mesh* MeshBuilder::GenerateQuad(const std::string &meshName, Color color, float length)
+{
+	return Create(meshName, BakedMeshes::QUAD, color, length);
+}
 
-	return mesh;
+void MeshBuilder::BuildQuad(MeshData &data, Color color, float length)
+{
+	AppendGenerated(data, BakedCopy(BakedMeshes::QUAD, color, length));
 }
 
 /******************************************************************************/
 /*!
 \brief
-Generate the vertices of a cube; Use random color for each vertex
+Generate the vertices of a 1 x 1 x 1 cube centred on the origin
 Then generate the VBO/IBO and store them in Mesh object
 
 \param meshName - name of mesh
-\param lengthX - width of cube
-\param lengthY - height of cube
-\param lengthZ - depth of cube
+\param color - color of every vertex
 
 \return Pointer to mesh storing VBO/IBO of cube
 */
 /******************************************************************************/
-Mesh* MeshBuilder::GenerateCube(const std::string &meshName, Color color, float lengthX, float lengthY, float lengthZ)
+Mesh* MeshBuilder::GenerateCube(const std::string &meshName, Color color)
 {
-	// An array of 3 vectors which represents 3 vertices
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	v.pos.Set(-0.5f, -0.5f, -0.5f); 
-	v.color = color;
-	v.normal.Set(-1, -1, -1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0.5f, -0.5f, -0.5f); 
-	v.color = color;
-	v.normal.Set(1, -1, -1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0.5f, 0.5f, -0.5f); 
-	v.color = color;
-	v.normal.Set(1, 1, -1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(-0.5f, 0.5f, -0.5f); 
-	v.color = color;
-	v.normal.Set(-1, 1, -1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(-0.5f, -0.5f, 0.5f); 
-	v.color = color;
-	v.normal.Set(-1, -1, 1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0.5f, -0.5f, 0.5f); 
-	v.color = color;
-	v.normal.Set(1, 1, 1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(0.5f, 0.5f, 0.5f); 
-	v.color = color;
-	v.normal.Set(1, 1, 1);
-	vertex_buffer_data.push_back(v);
-	v.pos.Set(-0.5f, 0.5f, 0.5f); 
-	v.color = color;
-	v.normal.Set(-1, 1, 1);
-	vertex_buffer_data.push_back(v);
-
-	std::vector<GLuint> index_buffer_data;
-	index_buffer_data.push_back(7);
-	index_buffer_data.push_back(4);
-	index_buffer_data.push_back(6);
-	index_buffer_data.push_back(5);
-	index_buffer_data.push_back(6);
-	index_buffer_data.push_back(4);
-	index_buffer_data.push_back(6);
-	index_buffer_data.push_back(5);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(5);
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(7);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(6);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(7);
-	index_buffer_data.push_back(2);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(3);
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(7);
-	index_buffer_data.push_back(4);
-	index_buffer_data.push_back(7);
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(4);
-	index_buffer_data.push_back(0);
-	index_buffer_data.push_back(5);
-	index_buffer_data.push_back(1);
-	index_buffer_data.push_back(5);
-	index_buffer_data.push_back(0);
+	return Create(meshName, BakedMeshes::CUBE, color, 1);
+}
 
-	Mesh *mesh = new Mesh(meshName);
+void MeshBuilder::BuildCube(MeshData &data, Color color)
+{
+	AppendGenerated(data, BakedCopy(BakedMeshes::CUBE, color, 1));
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+/******************************************************************************/
+/*!
+\brief
+Generate the vertices of a skybox cube from -1 to 1 on every axis, wound to face
+inwards so it survives back face culling when viewed from the inside.
+Only positions are used; the cube map is sampled with the vertex direction.
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+\param meshName - name of mesh
 
-	mesh->indexSize = 36;
-	mesh->mode = Mesh::DRAW_TRIANGLES;
+\return Pointer to mesh storing VBO/IBO of skybox cube
+*/
+/******************************************************************************/
+Mesh* MeshBuilder::GenerateSkybox(const std::string &meshName)
+{
+	return Create(meshName, BakedMeshes::SKYBOX);
+}
 
-	return mesh;
+void MeshBuilder::BuildSkybox(MeshData &data)
+{
+	AppendGenerated(data, BakedCopy(BakedMeshes::SKYBOX));
 }
 
 /******************************************************************************/
@@ -242,15 +252,26 @@ Mesh* MeshBuilder::GenerateCube(const std::string &meshName, Color color, float
  */
  /******************************************************************************/
 Mesh* MeshBuilder::GenerateCircle(const std::string &meshName, Color color, unsigned numSlice, float radius)
+{
+	MeshData data;
+	BuildCircle(data, color, numSlice, radius);
+
+	return Create(meshName, data);
+}
+
+void MeshBuilder::BuildCircle(MeshData &data, Color color, unsigned numSlice, float radius)
 {
 	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
+	std::vector<Vertex> &vertex_buffer_data = data.vertices;
+	std::vector<unsigned> &index_buffer_data = data.indices;
 	float degreePerSlice = 360.f / numSlice;
+	AngleTable slices(numSlice + 1, 0, degreePerSlice);
+	vertex_buffer_data.reserve(vertex_buffer_data.size() + numSlice * 3);
+	index_buffer_data.reserve(index_buffer_data.size() + numSlice * 3);
 	for (unsigned slice = 0; slice < numSlice; ++slice) {
 
 		float theta = slice * degreePerSlice;
-		/*v0*/	v.pos.Set(radius * cos(Math::DegreeToRadian(theta)), 0, radius * sin(Math::DegreeToRadian(theta)));
+		/*v0*/	v.pos.Set(radius * slices.cosines[slice], 0, radius * slices.sines[slice]);
 		v.color = color;
 		v.normal.Set(theta), 0, (theta);
 		vertex_buffer_data.push_back(v);
@@ -261,7 +282,7 @@ Mesh* MeshBuilder::GenerateCircle(const std::string &meshName, Color color, unsi
 		vertex_buffer_data.push_back(v);
 
 		float theta2 = (slice + 1) * degreePerSlice;
-		/*v2*/	v.pos.Set(radius * cos(Math::DegreeToRadian(theta2)), 0, radius * sin(Math::DegreeToRadian(theta2)));
+		/*v2*/	v.pos.Set(radius * slices.cosines[slice + 1], 0, radius * slices.sines[slice + 1]);
 		v.color = color;
 		v.normal.Set(theta2), 0, (theta2);
 		vertex_buffer_data.push_back(v);
@@ -271,16 +292,8 @@ Mesh* MeshBuilder::GenerateCircle(const std::string &meshName, Color color, unsi
 		index_buffer_data.push_back(slice * 3 + 1);
 		index_buffer_data.push_back(slice * 3 + 2);
 	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLES;
 
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	return mesh;
+	data.mode = Mesh::DRAW_TRIANGLES;
 }
 
 /******************************************************************************/
@@ -298,31 +311,42 @@ Mesh* MeshBuilder::GenerateCircle(const std::string &meshName, Color color, unsi
  */
  /******************************************************************************/
 Mesh* MeshBuilder::GenerateRing(const std::string &meshName, Color color, unsigned numSlice, float outerR, float innerR)
+{
+	MeshData data;
+	BuildRing(data, color, numSlice, outerR, innerR);
+
+	return Create(meshName, data);
+}
+
+void MeshBuilder::BuildRing(MeshData &data, Color color, unsigned numSlice, float outerR, float innerR)
 {
 	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
+	std::vector<Vertex> &vertex_buffer_data = data.vertices;
+	std::vector<unsigned> &index_buffer_data = data.indices;
 	float degreePerSlice = 360.f / numSlice;
+	AngleTable slices(numSlice + 1, 0, degreePerSlice);
+	vertex_buffer_data.reserve(vertex_buffer_data.size() + numSlice * 4);
+	index_buffer_data.reserve(index_buffer_data.size() + numSlice * 6);
 	for (unsigned slice = 0; slice < numSlice; ++slice) {
 
 		float theta = slice * degreePerSlice;
-		/*v0*/	v.pos.Set(outerR * cos(Math::DegreeToRadian(theta)), 0, outerR * sin(Math::DegreeToRadian(theta)));
+		/*v0*/	v.pos.Set(outerR * slices.cosines[slice], 0, outerR * slices.sines[slice]);
 		v.color = color;
 		v.normal.Set(theta, 0, theta);
 		vertex_buffer_data.push_back(v);
 
-		/*v1*/	v.pos.Set(innerR * cos(Math::DegreeToRadian(theta)), 0, innerR * sin(Math::DegreeToRadian(theta)));
+		/*v1*/	v.pos.Set(innerR * slices.cosines[slice], 0, innerR * slices.sines[slice]);
 		v.color = color;
 		v.normal.Set(theta, 0, theta);
 		vertex_buffer_data.push_back(v);
 
 		float theta2 = (slice + 1) * degreePerSlice;
-		/*v2*/	v.pos.Set(outerR * cos(Math::DegreeToRadian(theta2)), 0, outerR * sin(Math::DegreeToRadian(theta2)));
+		/*v2*/	v.pos.Set(outerR * slices.cosines[slice + 1], 0, outerR * slices.sines[slice + 1]);
 		v.color = color;
 		v.normal.Set(theta2, 0,theta2);
 		vertex_buffer_data.push_back(v);
 
-		/*v3*/	v.pos.Set(innerR * cos(Math::DegreeToRadian(theta2)), 0, innerR * sin(Math::DegreeToRadian(theta2)));
+		/*v3*/	v.pos.Set(innerR * slices.cosines[slice + 1], 0, innerR * slices.sines[slice + 1]);
 		v.color = color;
 		v.normal.Set(theta2, 0, theta2);
 		vertex_buffer_data.push_back(v);
@@ -336,16 +360,8 @@ Mesh* MeshBuilder::GenerateRing(const std::string &meshName, Color color, unsign
 		index_buffer_data.push_back(slice * 4 + 2);
 		index_buffer_data.push_back(slice * 4 + 1);
 	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLES;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
 
-	return mesh;
+	data.mode = Mesh::DRAW_TRIANGLES;
 }
 
 /******************************************************************************/
@@ -362,60 +378,39 @@ Mesh* MeshBuilder::GenerateRing(const std::string &meshName, Color color, unsign
  \return Pointer to mesh storing VBO/IBO of cube
  */
  /******************************************************************************/
-
-float sphereX(float phi, float theta) {
-	return cos(Math::DegreeToRadian(phi)) * cos(Math::DegreeToRadian(theta));
-}
-float sphereY(float phi, float theta) {
-	return sin(Math::DegreeToRadian(phi));
-}
-float sphereZ(float phi, float theta) {
-	return cos(Math::DegreeToRadian(phi)) * sin(Math::DegreeToRadian(theta));
-}
-float cylinderX(float theta) {
-	return cos(Math::DegreeToRadian(theta));
+Mesh* MeshBuilder::GenerateSphere(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
 }
-float cylinderZ(float theta) {
-	return sin(Math::DegreeToRadian(theta));
+
+void MeshBuilder::BuildSphere(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
 }
 
-/******************************************************************************/
-Mesh* MeshBuilder::GenerateSphere(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
+Mesh* MeshBuilder::GenerateOBJ(const std::string & meshName, const std::string & file_path)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 360.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.color = color;
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
+	MeshData data;
+	if (!BuildOBJ(file_path, data))
+	{
+		return NULL;
 	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
 
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	return mesh;
+	return Create(meshName, data);
 }
 
-Mesh* MeshBuilder::GenerateOBJ(const std::string & meshName, const std::string & file_path)
+/******************************************************************************/
+/*!
+\brief
+Read an OBJ file and index its vertices without touching OpenGL
+
+\param file_path - path of OBJ file
+\param data - receives the indexed vertices
+
+\return true if the file could be read
+*/
+/******************************************************************************/
+bool MeshBuilder::BuildOBJ(const std::string & file_path, MeshData & data)
 {
 	//Read vertices, texCoords & normals from OBJ
 	std::vector<Position> vertices;
@@ -424,123 +419,205 @@ Mesh* MeshBuilder::GenerateOBJ(const std::string & meshName, const std::string &
 	bool success = LoadOBJ(file_path.c_str(), vertices, uvs, normals);
 	if (!success)
 	{
-		return NULL;
+		return false;
 	}
 
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
+	IndexVBO(vertices, uvs, normals, data.indices, data.vertices);
+	data.mode = Mesh::DRAW_TRIANGLES;
 
-	IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
+	return true;
+}
 
-	Mesh *mesh = new Mesh(meshName);
+/******************************************************************************/
+/*!
+\brief
+Replace the VBO/IBO contents of a mesh with CPU side data
 
-	mesh->mode = Mesh::DRAW_TRIANGLES;
+\param mesh - mesh to fill
+\param data - vertices, indices and draw mode
+*/
+/******************************************************************************/
+void MeshBuilder::Upload(Mesh * mesh, const MeshData & data)
+{
+	if (data.vertices.empty() || data.indices.empty())
+	{
+		return;
+	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(Vertex), &data.vertices[0], GL_STATIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), &data.indices[0], GL_STATIC_DRAW);
 
-	mesh->indexSize = index_buffer_data.size();
+	mesh->indexSize = data.indices.size();
+	mesh->mode = data.mode;
+	mesh->bounds = PositionBounds(&data.vertices[0], data.vertices.size());
+}
+
+/******************************************************************************/
+/*!
+rief
+Create a mesh and upload CPU side data into its VBO/IBO; must be called on the
+GL thread. Every Generate function is its Build counterpart followed by this.
+
+\param meshName - name of mesh
+\param data - vertices, indices and draw mode
+
+
+eturn Pointer to mesh storing VBO/IBO of the data
+*/
+/******************************************************************************/
+Mesh* MeshBuilder::Create(const std::string &meshName, const MeshData &data)
+{
+	Mesh *mesh = new Mesh(meshName);
+	Upload(mesh, data);
 
 	return mesh;
 }
 
-Mesh * MeshBuilder::GenerateText(const std::string & meshName, unsigned numRow, unsigned numCol)
+/******************************************************************************/
+/*!
+\brief
+Unroll the indices of a mesh into a triangle list, for code that works on
+triangles rather than drawing them, such as colliders and skinned meshes.
+Unindexed data draws its vertices in order.
+
+\param data - vertices, indices and draw mode
+\param triangles - three indices per triangle, replaced
+
+\return false if the mesh is lines or has no triangles
+*/
+/******************************************************************************/
+bool MeshBuilder::TriangleIndices(const MeshData &data, std::vector<unsigned> &triangles)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
+	triangles.clear();
+	if (data.mode == Mesh::DRAW_LINES || data.vertices.empty())
+		return false;
+
+	std::vector<unsigned> order;
+	if (data.indices.empty())
+	{
+		order.resize(data.vertices.size());
+		for (unsigned i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+	}
+	const std::vector<unsigned> &indices = data.indices.empty() ? order : data.indices;
 
-	float width = 1.f / numCol;
-	float height = 1.f / numRow;
-	int offset = 0;
-	for (unsigned i = 0; i < numCol; ++i)
+	if (data.mode == Mesh::DRAW_TRIANGLES)
 	{
-		for (unsigned j = 0; j < numCol; ++j)
+		triangles.assign(indices.begin(), indices.end() - indices.size() % 3);
+	}
+	else
+	{
+		for (unsigned i = 2; i < indices.size(); ++i)
 		{
-			float u1 = j * width;
-			float v1 = 1.f - height - i * height;
-			v.pos.Set(-0.5f, -0.5f, 0);
-			v.texCoord.Set(u1, v1);
-			vertex_buffer_data.push_back(v);
-
-			v.pos.Set(0.5f, -0.5f, 0);
-			v.texCoord.Set(u1 + width, v1);
-			vertex_buffer_data.push_back(v);
-
-			v.pos.Set(0.5f, 0.5f, 0);
-			v.texCoord.Set(u1 + width, v1 + height);
-			vertex_buffer_data.push_back(v);
-
-			v.pos.Set(-0.5f, 0.5f, 0);
-			v.texCoord.Set(u1, v1 + height);
-			vertex_buffer_data.push_back(v);
-
-			index_buffer_data.push_back(offset + 0);
-			index_buffer_data.push_back(offset + 1);
-			index_buffer_data.push_back(offset + 2);
-			index_buffer_data.push_back(offset + 0);
-			index_buffer_data.push_back(offset + 2);
-			index_buffer_data.push_back(offset + 3);
-			offset += 4;
+			if (data.mode == Mesh::DRAW_FAN)
+			{
+				triangles.push_back(indices[0]);
+				triangles.push_back(indices[i - 1]);
+			}
+			else
+			{
+				//Every other strip triangle is wound the other way
+				triangles.push_back(indices[i - 2 + (i & 1)]);
+				triangles.push_back(indices[i - 1 - (i & 1)]);
+			}
+			triangles.push_back(indices[i]);
 		}
 	}
+	return !triangles.empty();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Create a mesh of a baked primitive, uploaded straight from its read only
+arrays; must be called on the GL thread
+
+\param meshName - name of mesh
+\param baked - vertices, indices and draw mode built at compile time
+
+\return Pointer to mesh storing VBO/IBO of the primitive
+*/
+/******************************************************************************/
+Mesh* MeshBuilder::Create(const std::string &meshName, const BakedMesh &baked)
+{
 	Mesh *mesh = new Mesh(meshName);
 
 	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, baked.vertexCount * sizeof(Vertex), baked.vertices, GL_STATIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLES;
-
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, baked.indexCount * sizeof(GLuint), baked.indices, GL_STATIC_DRAW);
 
+	mesh->indexSize = baked.indexCount;
+	mesh->mode = baked.mode;
+	mesh->bounds = PositionBounds(baked.vertices, baked.vertexCount);
 	return mesh;
 }
 
-Mesh* MeshBuilder::GenerateCylinder(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius, float height)
+/******************************************************************************/
+/*!
+\brief
+Create a mesh of a baked primitive with every vertex set to one color and its
+positions scaled, written straight into the mapped VBO
+
+\param meshName - name of mesh
+\param baked - vertices, indices and draw mode built at compile time
+\param color - color of every vertex
+\param scale - uniform scale of the positions
+
+\return Pointer to mesh storing VBO/IBO of the primitive
+*/
+/******************************************************************************/
+Mesh* MeshBuilder::Create(const std::string &meshName, const BakedMesh &baked, Color color, float scale)
 {
-	Vertex v;
+	return CreateGenerated(meshName, BakedCopy(baked, color, scale));
+}
 
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.0f / numStack;
-	float degreePerSlice = 360.0f / numSlice;
-	float stackHeight = height / numStack;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack)
+Mesh * MeshBuilder::GenerateText(const std::string & meshName, unsigned numRow, unsigned numCol)
+{
+	if (numRow == BakedMeshes::TEXT_ROWS && numCol == BakedMeshes::TEXT_COLUMNS)
 	{
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice)
-		{
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * cylinderX(theta), -height / 2 + stack * stackHeight, radius*cylinderZ(theta));
-			v.color = color;
-			v.normal.Set(cylinderX(theta), 0, cylinderZ(theta));
-			vertex_buffer_data.push_back(v);
-		}
+		return Create(meshName, BakedMeshes::TEXT);
 	}
 
-	for (unsigned stack = 0; stack < numStack; ++stack)
+	MeshData data;
+	BuildText(data, numRow, numCol);
+
+	return Create(meshName, data);
+}
+
+void MeshBuilder::BuildText(MeshData &data, unsigned numRow, unsigned numCol)
+{
+	if (numRow == BakedMeshes::TEXT_ROWS && numCol == BakedMeshes::TEXT_COLUMNS)
 	{
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice)
-		{
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
+		AppendGenerated(data, BakedCopy(BakedMeshes::TEXT));
+		return;
+	}
 
+	unsigned baseVertex = data.vertices.size();
+	unsigned baseIndex = data.indices.size();
+	data.vertices.resize(baseVertex + numRow * numCol * 4);
+	data.indices.resize(baseIndex + numRow * numCol * 6);
+	WriteTextQuads(&data.vertices[baseVertex], &data.indices[baseIndex], numRow, numCol);
+	for (unsigned i = baseIndex; i < data.indices.size(); ++i)
+	{
+		data.indices[i] += baseVertex;
 	}
 
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
+	data.mode = Mesh::DRAW_TRIANGLES;
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+Mesh* MeshBuilder::GenerateCylinder(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius, float height)
+{
+	return CreateGenerated(meshName, Cylinder(color, numStack, numSlice, radius, height));
+}
 
-	return mesh;
+void MeshBuilder::BuildCylinder(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius, float height)
+{
+	AppendGenerated(data, Cylinder(color, numStack, numSlice, radius, height));
 }
 
 //// STAR -----------------------------------------------------------------------------------
@@ -644,10 +721,18 @@ Mesh* MeshBuilder::GenerateCylinder(const std::string &meshName, Color color, un
 
 // STAR -----------------------------------------------------------------------------------
 Mesh * MeshBuilder::GenerateStar(const std::string & meshName, Color color, float length)
+{
+	MeshData data;
+	BuildStar(data, color, length);
+
+	return Create(meshName, data);
+}
+
+void MeshBuilder::BuildStar(MeshData &data, Color color, float length)
 {
 	// An array of 3 vectors which represents 3 vertices
 	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
+	std::vector<Vertex> &vertex_buffer_data = data.vertices;
 	v.pos.Set(0.0f * length, 0.0f * length, 0); v.color = color; //v.pos.Set(-0.5f * length, -0.5f * length, 0); v.color = color;
 	v.normal.Set(-0.5f, 0, 1);
 	vertex_buffer_data.push_back(v);
@@ -703,7 +788,7 @@ Mesh * MeshBuilder::GenerateStar(const std::string & meshName, Color color, floa
 	v.pos.Set(-0.0f * length, 0.5f * length, 0); v.color = color;
 	vertex_buffer_data.push_back(v);*/
 
-	std::vector<GLuint> index_buffer_data;
+	std::vector<unsigned> &index_buffer_data = data.indices;
 	index_buffer_data.push_back(0);
 	index_buffer_data.push_back(1); // point 1
 	index_buffer_data.push_back(2); // point 2
@@ -727,273 +812,77 @@ Mesh * MeshBuilder::GenerateStar(const std::string & meshName, Color color, floa
 	index_buffer_data.push_back(2);
 	index_buffer_data.push_back(0);*/
 
-	Mesh *mesh = new Mesh(meshName);
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	return mesh;
+	data.mode = Mesh::DRAW_TRIANGLE_STRIP;
 }
 
 // BODY -----------------------------------------------------------------------------------
 Mesh * MeshBuilder::GenerateBody(const std::string & meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 360.f / numSlice;
-
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.color = color;
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			vertex_buffer_data.push_back(v);
-		}
-	}
-
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildBody(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
 }
 
 // HAT -----------------------------------------------------------------------------------
 Mesh * MeshBuilder::GenerateHat(const std::string & meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 180.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			v.color = color;
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildHat(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
 }
 
 Mesh * MeshBuilder::GenerateHatSide(const std::string & meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 360.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.color = color;
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildHatSide(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 360.f));
 }
 
 Mesh * MeshBuilder::GenerateFoot(const std::string & meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 180.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			v.color = color;
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildFoot(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
 }
 
 Mesh* MeshBuilder::GenerateMouth(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 90.f / numStack;
-	float degreePerSlice = 90.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			v.color = color;
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 90.f, 90.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildMouth(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 90.f, 90.f));
 }
 
 Mesh * MeshBuilder::GenerateMouth2(const std::string & meshName, Color color, unsigned numStack, unsigned numSlice, float radius)
 {
-	Vertex v;
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	float degreePerStack = 180.f / numStack;
-	float degreePerSlice = 180.f / numSlice;
-	for (unsigned stack = 0; stack < numStack + 1; ++stack) {
-		float phi = -90 + stack * degreePerStack;
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			float theta = slice * degreePerSlice;
-			v.pos.Set(radius * sphereX(phi, theta), radius * sphereY(phi, theta), radius * sphereZ(phi, theta));
-			v.color = color;
-			v.normal.Set(sphereX(phi, theta), sphereY(phi, theta), sphereZ(phi, theta));
-			vertex_buffer_data.push_back(v);
-		}
-	}
-	for (unsigned stack = 0; stack < numStack; ++stack) {
-		for (unsigned slice = 0; slice < numSlice + 1; ++slice) {
-			index_buffer_data.push_back(stack * (numSlice + 1) + slice);
-			index_buffer_data.push_back((stack + 1) * (numSlice + 1) + slice);
-		}
-	}
-	Mesh *mesh = new Mesh(meshName);
-	mesh->indexSize = index_buffer_data.size();
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+	return CreateGenerated(meshName, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
+}
 
-	return mesh;
+void MeshBuilder::BuildMouth2(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius)
+{
+	AppendGenerated(data, SpherePatch(color, numStack, numSlice, radius, 180.f, 180.f));
 }
 
 Mesh* MeshBuilder::GenerateCone(const std::string &meshName, Color color, unsigned numSlice, float radius, float height)
 {
-	std::vector<Vertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-
-	Vertex v;
-	float degreePerSlice = 360.f / numSlice;
-
-	for (unsigned slice = 0; slice < numSlice + 1; ++slice) //slice
-	{
-		float theta = slice * degreePerSlice;
-
-		v.pos.Set(radius * cos(Math::DegreeToRadian(theta)), 0, radius * sin(Math::DegreeToRadian(theta)));
-		v.color = color;
-		v.normal.Set(cos(Math::DegreeToRadian(theta)), 0, sin(Math::DegreeToRadian(theta)));
-		vertex_buffer_data.push_back(v);
-
-		v.pos.Set(0, height, 0);
-		v.color = color;
-		v.normal.Set(1, 1, 1);
-		vertex_buffer_data.push_back(v);
-	}
-	for (unsigned slice = 0; slice < numSlice + 1; ++slice)
-	{
-		index_buffer_data.push_back(slice * 2 + 0);
-		index_buffer_data.push_back(slice * 2 + 1);
-	}
-
-	Mesh *mesh = new Mesh(meshName);
-
-	mesh->mode = Mesh::DRAW_TRIANGLE_STRIP;
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-
-	mesh->indexSize = index_buffer_data.size();
+	return CreateGenerated(meshName, Cone(color, numSlice, radius, height));
+}
 
-	return mesh;
-}
\ No newline at end of file
+void MeshBuilder::BuildCone(MeshData &data, Color color, unsigned numSlice, float radius, float height)
+{
+	AppendGenerated(data, Cone(color, numSlice, radius, height));
+}
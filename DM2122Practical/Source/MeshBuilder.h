@@ -1,22 +1,47 @@
 #ifndef MESH_BUILDER_H
 #define MESH_BUILDER_H
 
+#include <vector>
 #include "Mesh.h"
+#include "BakedMeshes.h"
+
+/******************************************************************************/
+/*!
+		Struct MeshData:
+\brief	CPU copy of the VBO/IBO contents of a mesh, so geometry can be built
+		away from the GL thread and uploaded later
+*/
+/******************************************************************************/
+struct MeshData
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned> indices;
+	Mesh::DRAW_MODE mode;
+
+	MeshData() : mode(Mesh::DRAW_TRIANGLES) {}
+};
 
 /******************************************************************************/
 /*!
 		Class MeshBuilder:
 \brief	Provides methods to generate mesh of different shapes
+		Each GenerateX(meshName, ...) is BuildX(data, ...) followed by Create;
+		the Build functions make no GL calls and are safe on worker threads.
+		The sphere family, cylinder and cone are ParametricMesh grids that
+		Generate writes straight into the mapped VBO/IBO instead. Axes, quad,
+		cube, skybox and the 16 x 16 text sheet are baked at compile time.
 */
 /******************************************************************************/
 class MeshBuilder
 {
 public:
-	static Mesh* GenerateAxes(const std::string &meshName, float lengthX, float lengthY, float lengthZ); //AXES , X Y Z
+	static Mesh* GenerateAxes(const std::string &meshName); //AXES , X Y Z, 2000 long
 
 	static Mesh* GenerateQuad(const std::string &meshName, Color color, float length); // Plane
 
-	static Mesh* GenerateCube(const std::string &meshName, Color color, float lengthX, float lengthY, float lengthZ);
+	static Mesh* GenerateCube(const std::string &meshName, Color color); // 1 x 1 x 1
+
+	static Mesh* GenerateSkybox(const std::string &meshName); // Inward facing cube for the cube map skybox
 
 	static Mesh* GenerateCircle(const std::string &meshName, Color color, unsigned numSlice, float radius);
 
@@ -26,6 +51,17 @@ public:
 	
 	//OBJ
 	static Mesh* GenerateOBJ(const std::string &meshName, const std::string &file_path);
+	static bool BuildOBJ(const std::string &file_path, MeshData &data); // No GL calls, safe on worker threads
+
+	//Fill the VBO/IBO of an existing mesh from CPU side data
+	static void Upload(Mesh *mesh, const MeshData &data);
+	static Mesh* Create(const std::string &meshName, const MeshData &data);
+	//Indices of data as a triangle list, strips and fans unrolled; false for lines or no triangles
+	static bool TriangleIndices(const MeshData &data, std::vector<unsigned> &triangles);
+
+	//Meshes of the compile time primitives in BakedMeshes, no building involved
+	static Mesh* Create(const std::string &meshName, const BakedMesh &baked);
+	static Mesh* Create(const std::string &meshName, const BakedMesh &baked, Color color, float scale);
 
 	//Text
 	static Mesh* GenerateText(const std::string &meshName, unsigned numRow, unsigned numCol);
@@ -41,6 +77,25 @@ public:
 	static Mesh* GenerateMouth2(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius); // The Mouth Itself
 	static Mesh* GenerateCylinder(const std::string &meshName, Color color, unsigned numStack, unsigned numSlice, float radius, float height); // Legs, Arms, Barrel, Gun Body
 	static Mesh* GenerateCone(const std::string &meshName, Color color, unsigned numSlice, float radius, float height); // Laser Gun Point
+
+	//CPU halves of the generators above
+	static void BuildAxes(MeshData &data);
+	static void BuildQuad(MeshData &data, Color color, float length);
+	static void BuildCube(MeshData &data, Color color);
+	static void BuildSkybox(MeshData &data);
+	static void BuildCircle(MeshData &data, Color color, unsigned numSlice, float radius);
+	static void BuildRing(MeshData &data, Color color, unsigned numSlice, float outerR, float innerR);
+	static void BuildSphere(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildText(MeshData &data, unsigned numRow, unsigned numCol);
+	static void BuildStar(MeshData &data, Color color, float length);
+	static void BuildBody(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildHat(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildHatSide(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildFoot(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildMouth(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildMouth2(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius);
+	static void BuildCylinder(MeshData &data, Color color, unsigned numStack, unsigned numSlice, float radius, float height);
+	static void BuildCone(MeshData &data, Color color, unsigned numSlice, float radius, float height);
 };
 
 #endif
\ No newline at end of file
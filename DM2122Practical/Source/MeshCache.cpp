@@ -0,0 +1,84 @@
+#include "MeshCache.h"
+#include "MeshBuilder.h"
+
+MeshCache::MeshCache()
+{
+}
+
+MeshCache::~MeshCache()
+{
+	Clear();
+}
+
+Mesh* MeshCache::Acquire(const std::string &meshName, const BakedMesh &baked)
+{
+	return Acquire(meshName, baked, false, Color(), 1);
+}
+
+Mesh* MeshCache::Acquire(const std::string &meshName, const BakedMesh &baked, Color color, float scale)
+{
+	return Acquire(meshName, baked, true, color, scale);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Return the shared mesh for these arguments, uploading it on first use
+
+\param meshName - name given to the mesh if it has to be created
+\param baked - primitive to upload
+\param recolor - whether color and scale apply
+\param color - color of every vertex
+\param scale - uniform scale of the positions
+
+\return Shared mesh, owned by the cache
+*/
+/******************************************************************************/
+Mesh* MeshCache::Acquire(const std::string &meshName, const BakedMesh &baked, bool recolor, Color color, float scale)
+{
+	for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		if (it->baked == &baked && it->recolor == recolor &&
+			(!recolor || (it->color.r == color.r && it->color.g == color.g && it->color.b == color.b && it->scale == scale)))
+		{
+			++it->references;
+			return it->mesh;
+		}
+	}
+
+	Entry entry;
+	entry.baked = &baked;
+	entry.recolor = recolor;
+	entry.color = color;
+	entry.scale = scale;
+	entry.mesh = recolor ? MeshBuilder::Create(meshName, baked, color, scale) : MeshBuilder::Create(meshName, baked);
+	entry.references = 1;
+	m_entries.push_back(entry);
+	return entry.mesh;
+}
+
+bool MeshCache::Release(Mesh *mesh)
+{
+	for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		if (it->mesh == mesh)
+		{
+			if (--it->references == 0)
+			{
+				delete it->mesh;
+				m_entries.erase(it);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void MeshCache::Clear()
+{
+	for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		delete it->mesh;
+	}
+	m_entries.clear();
+}
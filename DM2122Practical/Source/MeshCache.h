@@ -0,0 +1,52 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <string>
+#include <vector>
+#include "BakedMeshes.h"
+
+/******************************************************************************/
+/*!
+		Class MeshCache:
+\brief	Shares one mesh between every user of the same baked primitive with
+		the same color and scale, so identical primitives are uploaded once.
+		The cache owns its meshes; release them instead of deleting them.
+		A shared mesh keeps the name it was first acquired with, and a
+		texture set on it is seen by every user. GL thread only.
+*/
+/******************************************************************************/
+class MeshCache
+{
+public:
+	MeshCache();
+	~MeshCache();
+
+	//As baked
+	Mesh* Acquire(const std::string &meshName, const BakedMesh &baked);
+	//Every vertex set to color and the positions scaled
+	Mesh* Acquire(const std::string &meshName, const BakedMesh &baked, Color color, float scale);
+
+	//Drop one reference, deleting the mesh with the last one; returns false,
+	//doing nothing, if the mesh did not come from this cache
+	bool Release(Mesh *mesh);
+
+	//Delete every mesh, acquired or not
+	void Clear();
+
+private:
+	struct Entry
+	{
+		const BakedMesh *baked;
+		bool recolor;
+		Color color;
+		float scale;
+		Mesh *mesh;
+		unsigned references;
+	};
+
+	Mesh* Acquire(const std::string &meshName, const BakedMesh &baked, bool recolor, Color color, float scale);
+
+	std::vector<Entry> m_entries;
+};
+
+#endif
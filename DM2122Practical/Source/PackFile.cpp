@@ -0,0 +1,329 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#include "PackFile.h"
+
+std::string NormalizePackPath(const char *file_path)
+{
+	std::string name;
+	for (const char *c = file_path; *c; ++c)
+	{
+		char ch = (*c == '\\') ? '/' : *c;
+		if (ch >= 'A' && ch <= 'Z')
+		{
+			ch = ch - 'A' + 'a';
+		}
+		//"Image//front.tga" is used throughout, collapse the double slashes
+		if (ch == '/' && (name.empty() || name[name.size() - 1] == '/'))
+		{
+			continue;
+		}
+		name += ch;
+	}
+	while (name.compare(0, 2, "./") == 0)
+	{
+		name.erase(0, 2);
+	}
+	return name;
+}
+
+static size_t AlignPack(size_t offset)
+{
+	return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Write files into a pack. Entries are sorted by normalized name so lookups can
+binary search the table of contents.
+
+\param pack_path - pack to write
+\param file_paths - loose files to store, also used as the entry names
+\param compress - try LZ4 on every entry
+
+\return true if the pack was written
+*/
+/******************************************************************************/
+bool SavePack(const char *pack_path, const std::vector<std::string> &file_paths, bool compress)
+{
+	struct Source
+	{
+		std::string name;
+		std::vector<unsigned char> data;
+		std::vector<unsigned char> compressed;
+	};
+
+	std::vector<Source> sources(file_paths.size());
+	for (unsigned i = 0; i < file_paths.size(); ++i)
+	{
+		std::ifstream fileStream(file_paths[i].c_str(), std::ios::binary);
+		if (!fileStream.is_open())
+		{
+			std::cout << "Impossible to open " << file_paths[i] << ". Are you in the right directory ?\n";
+			return false;
+		}
+		sources[i].name = NormalizePackPath(file_paths[i].c_str());
+		sources[i].data.assign(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+
+		if (compress)
+		{
+			CompressBlock(sources[i].data.empty() ? NULL : &sources[i].data[0], sources[i].data.size(), sources[i].compressed);
+			if (sources[i].compressed.size() >= sources[i].data.size())
+			{
+				sources[i].compressed.clear();
+			}
+		}
+	}
+
+	std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b) { return a.name < b.name; });
+	for (unsigned i = 1; i < sources.size(); ++i)
+	{
+		if (sources[i].name == sources[i - 1].name)
+		{
+			std::cout << "Pack has two files named " << sources[i].name << "\n";
+			return false;
+		}
+	}
+
+	PackHeader header;
+	memcpy(header.magic, "PACK", 4);
+	header.version = PACK_VERSION;
+	header.entryCount = sources.size();
+	header.nameTableSize = 0;
+	for (unsigned i = 0; i < sources.size(); ++i)
+	{
+		header.nameTableSize += sources[i].name.size() + 1;
+	}
+
+	std::vector<PackEntry> entries(sources.size());
+	unsigned nameOffset = 0;
+	size_t offset = AlignPack(sizeof(header) + entries.size() * sizeof(PackEntry) + header.nameTableSize);
+	for (unsigned i = 0; i < sources.size(); ++i)
+	{
+		bool compressed = !sources[i].compressed.empty();
+		entries[i].nameOffset = nameOffset;
+		entries[i].flags = compressed ? PackEntry::FLAG_COMPRESSED : 0;
+		entries[i].offset = offset;
+		entries[i].size = sources[i].data.size();
+		entries[i].storedSize = compressed ? sources[i].compressed.size() : sources[i].data.size();
+
+		nameOffset += sources[i].name.size() + 1;
+		offset = AlignPack(offset + entries[i].storedSize);
+	}
+
+	std::ofstream fileStream(pack_path, std::ios::binary);
+	if (!fileStream.is_open())
+	{
+		std::cout << "Impossible to write " << pack_path << "\n";
+		return false;
+	}
+
+	fileStream.write((const char*)&header, sizeof(header));
+	if (!entries.empty())
+		fileStream.write((const char*)&entries[0], entries.size() * sizeof(PackEntry));
+	for (unsigned i = 0; i < sources.size(); ++i)
+	{
+		fileStream.write(sources[i].name.c_str(), sources[i].name.size() + 1);
+	}
+
+	const char padding[PACK_ALIGNMENT] = {};
+	for (unsigned i = 0; i < sources.size(); ++i)
+	{
+		fileStream.write(padding, entries[i].offset - (size_t)fileStream.tellp());
+		const std::vector<unsigned char> &stored = (entries[i].flags & PackEntry::FLAG_COMPRESSED) ? sources[i].compressed : sources[i].data;
+		if (!stored.empty())
+			fileStream.write((const char*)&stored[0], stored.size());
+	}
+
+	return fileStream.good();
+}
+
+//LZ4 block format: sequences of [token][literal length+][literals][offset][match length+].
+//The last sequence is literals only; it holds at least the final 5 bytes, and
+//no match starts within the final 12 bytes.
+static const size_t LZ4_MIN_MATCH = 4;
+static const size_t LZ4_LAST_LITERALS = 5;
+static const size_t LZ4_MATCH_LIMIT = 12;
+static const size_t LZ4_MAX_OFFSET = 65535;
+static const unsigned LZ4_HASH_BITS = 12;
+
+static unsigned Read32(const unsigned char *p)
+{
+	unsigned value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static void WriteLength(std::vector<unsigned char> &dst, size_t length)
+{
+	while (length >= 255)
+	{
+		dst.push_back(255);
+		length -= 255;
+	}
+	dst.push_back((unsigned char)length);
+}
+
+static void WriteSequence(std::vector<unsigned char> &dst, const unsigned char *literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+	size_t extraMatch = matchLength ? matchLength - LZ4_MIN_MATCH : 0;
+	unsigned char token = (unsigned char)((std::min(numLiterals, (size_t)15) << 4) | std::min(extraMatch, (size_t)15));
+	dst.push_back(token);
+	if (numLiterals >= 15)
+	{
+		WriteLength(dst, numLiterals - 15);
+	}
+	dst.insert(dst.end(), literals, literals + numLiterals);
+
+	if (matchLength)
+	{
+		dst.push_back((unsigned char)(offset & 0xFF));
+		dst.push_back((unsigned char)(offset >> 8));
+		if (extraMatch >= 15)
+		{
+			WriteLength(dst, extraMatch - 15);
+		}
+	}
+}
+
+void CompressBlock(const unsigned char *src, size_t srcSize, std::vector<unsigned char> &dst)
+{
+	dst.clear();
+	dst.reserve(srcSize + srcSize / 255 + 16);
+
+	size_t anchor = 0;
+	if (srcSize > LZ4_MATCH_LIMIT)
+	{
+		//Last position each 4 byte hash was seen, plus one so 0 means never
+		std::vector<size_t> table(1 << LZ4_HASH_BITS, 0);
+		size_t matchStartLimit = srcSize - LZ4_MATCH_LIMIT;
+		size_t matchEndLimit = srcSize - LZ4_LAST_LITERALS;
+
+		size_t ip = 0;
+		while (ip < matchStartLimit)
+		{
+			unsigned sequence = Read32(src + ip);
+			unsigned hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+			size_t candidate = table[hash];
+			table[hash] = ip + 1;
+
+			if (candidate == 0 || ip - (candidate - 1) > LZ4_MAX_OFFSET || Read32(src + candidate - 1) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			size_t ref = candidate - 1;
+			size_t length = LZ4_MIN_MATCH;
+			while (ip + length < matchEndLimit && src[ref + length] == src[ip + length])
+			{
+				++length;
+			}
+
+			WriteSequence(dst, src + anchor, ip - anchor, ip - ref, length);
+			ip += length;
+			anchor = ip;
+		}
+	}
+
+	WriteSequence(dst, src + anchor, srcSize - anchor, 0, 0);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Decode one LZ4 block, checking every length and offset against both buffers
+
+\param src - compressed block
+\param srcSize - bytes in src
+\param dst - receives the decoded bytes
+\param dstSize - expected decoded size
+
+\return true if the block decoded to exactly dstSize bytes
+*/
+/******************************************************************************/
+bool DecompressBlock(const unsigned char *src, size_t srcSize, unsigned char *dst, size_t dstSize)
+{
+	size_t ip = 0;
+	size_t op = 0;
+	for (;;)
+	{
+		if (ip >= srcSize)
+		{
+			return false;
+		}
+		unsigned token = src[ip++];
+
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (ip >= srcSize)
+				{
+					return false;
+				}
+				extra = src[ip++];
+				numLiterals += extra;
+			} while (extra == 255);
+		}
+		if (numLiterals > srcSize - ip || numLiterals > dstSize - op)
+		{
+			return false;
+		}
+		if (numLiterals)
+			memcpy(dst + op, src + ip, numLiterals);
+		ip += numLiterals;
+		op += numLiterals;
+
+		if (ip == srcSize)
+		{
+			break;
+		}
+
+		if (srcSize - ip < 2)
+		{
+			return false;
+		}
+		size_t offset = src[ip] | (src[ip + 1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > op)
+		{
+			return false;
+		}
+
+		size_t length = token & 15;
+		if (length == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (ip >= srcSize)
+				{
+					return false;
+				}
+				extra = src[ip++];
+				length += extra;
+			} while (extra == 255);
+		}
+		length += LZ4_MIN_MATCH;
+		if (length > dstSize - op)
+		{
+			return false;
+		}
+
+		//Byte by byte, the match may overlap the bytes it produces
+		const unsigned char *match = dst + op - offset;
+		for (size_t i = 0; i < length; ++i)
+		{
+			dst[op + i] = match[i];
+		}
+		op += length;
+	}
+
+	return op == dstSize;
+}
@@ -0,0 +1,46 @@
+#ifndef PACK_FILE_H
+#define PACK_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//A pack stores many asset files in one archive:
+//header, entryCount entries sorted by name, the name table, then the data of
+//every entry starting on a PACK_ALIGNMENT boundary
+struct PackHeader
+{
+	char magic[4];				// "PACK"
+	unsigned version;
+	unsigned entryCount;
+	unsigned nameTableSize;		// bytes of null terminated names after the entries
+};
+
+struct PackEntry
+{
+	enum FLAG
+	{
+		FLAG_COMPRESSED = 1,	// stored as one LZ4 block
+	};
+
+	unsigned nameOffset;		// into the name table
+	unsigned flags;
+	unsigned offset;			// from the start of the pack, PACK_ALIGNMENT aligned
+	unsigned size;				// size once decompressed
+	unsigned storedSize;		// size in the pack
+};
+
+const unsigned PACK_VERSION = 1;
+const unsigned PACK_ALIGNMENT = 64;
+
+//Pack entry names are normalized so "Image//front.tga" and "image\front.tga" match
+std::string NormalizePackPath(const char *file_path);
+
+//Write the files into a pack; compressed entries are only kept when they are smaller
+bool SavePack(const char *pack_path, const std::vector<std::string> &file_paths, bool compress);
+
+//LZ4 block format, without the frame header
+void CompressBlock(const unsigned char *src, size_t srcSize, std::vector<unsigned char> &dst);
+bool DecompressBlock(const unsigned char *src, size_t srcSize, unsigned char *dst, size_t dstSize);
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef PARAMETRIC_MESH_H
+#define PARAMETRIC_MESH_H
+
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "Mesh.h"
+#include "MyMath.h"
+#include "Bounds.h"
+
+//cos and sin of count evenly spaced angles, start + i * step degrees, so the
+//parametric generators do their trig once per stack or slice, not per vertex
+struct AngleTable
+{
+	std::vector<float> cosines;
+	std::vector<float> sines;
+
+	AngleTable(unsigned count, float start, float step) : cosines(count), sines(count)
+	{
+		for (unsigned i = 0; i < count; ++i)
+		{
+			float angle = Math::DegreeToRadian(start + i * step);
+			cosines[i] = cos(angle);
+			sines[i] = sin(angle);
+		}
+	}
+};
+
+/******************************************************************************/
+/*!
+		Struct SphereSurface:
+\brief	Sphere patch from the south pole up stackDegrees, each stack sweeping
+		sliceDegrees around y from +x towards +z. 180 x 360 is a full sphere.
+*/
+/******************************************************************************/
+struct SphereSurface
+{
+	float radius;
+	AngleTable stacks;
+	AngleTable slices;
+
+	SphereSurface(unsigned numStack, unsigned numSlice, float radius, float stackDegrees, float sliceDegrees)
+		: radius(radius)
+		, stacks(numStack + 1, -90, stackDegrees / numStack)
+		, slices(numSlice + 1, 0, sliceDegrees / numSlice)
+	{
+	}
+
+	void operator()(unsigned stack, unsigned slice, Position &pos, Vector3 &normal) const
+	{
+		float cosPhi = stacks.cosines[stack];
+		float sinPhi = stacks.sines[stack];
+		float x = cosPhi * slices.cosines[slice];
+		float z = cosPhi * slices.sines[slice];
+		pos.Set(radius * x, radius * sinPhi, radius * z);
+		normal.Set(x, sinPhi, z);
+	}
+	//The whole sphere, which holds any patch of it
+	AABB Bounds() const
+	{
+		float r = fabs(radius);
+		return AABB(Vector3(-r, -r, -r), Vector3(r, r, r));
+	}
+};
+
+/******************************************************************************/
+/*!
+		Struct CylinderSurface:
+\brief	Open cylinder around y, centred on the origin
+*/
+/******************************************************************************/
+struct CylinderSurface
+{
+	float radius;
+	float height;
+	float stackHeight;
+	AngleTable slices;
+
+	CylinderSurface(unsigned numStack, unsigned numSlice, float radius, float height)
+		: radius(radius)
+		, height(height)
+		, stackHeight(height / numStack)
+		, slices(numSlice + 1, 0, 360.f / numSlice)
+	{
+	}
+
+	void operator()(unsigned stack, unsigned slice, Position &pos, Vector3 &normal) const
+	{
+		float x = slices.cosines[slice];
+		float z = slices.sines[slice];
+		pos.Set(radius * x, -height / 2 + stack * stackHeight, radius * z);
+		normal.Set(x, 0, z);
+	}
+	AABB Bounds() const
+	{
+		float r = fabs(radius), h = fabs(height) / 2;
+		return AABB(Vector3(-r, -h, -r), Vector3(r, h, r));
+	}
+};
+
+/******************************************************************************/
+/*!
+		Struct ConeSurface:
+\brief	Open cone with its base on y = 0 and its apex at y = height; one
+		stack, the second row of the grid is the apex repeated per slice
+*/
+/******************************************************************************/
+struct ConeSurface
+{
+	float radius;
+	float height;
+	AngleTable slices;
+
+	ConeSurface(unsigned numSlice, float radius, float height)
+		: radius(radius)
+		, height(height)
+		, slices(numSlice + 1, 0, 360.f / numSlice)
+	{
+	}
+
+	void operator()(unsigned stack, unsigned slice, Position &pos, Vector3 &normal) const
+	{
+		if (stack == 0)
+		{
+			float x = slices.cosines[slice];
+			float z = slices.sines[slice];
+			pos.Set(radius * x, 0, radius * z);
+			normal.Set(x, 0, z);
+		}
+		else
+		{
+			pos.Set(0, height, 0);
+			normal.Set(1, 1, 1);
+		}
+	}
+	AABB Bounds() const
+	{
+		float r = fabs(radius);
+		return AABB(Vector3(-r, Math::Min(height, 0.f), -r), Vector3(r, Math::Max(height, 0.f), r));
+	}
+};
+
+/******************************************************************************/
+/*!
+		Struct ColoredVertex:
+\brief	Vertex format of the mesh shader: position, one color and normal
+*/
+/******************************************************************************/
+struct ColoredVertex
+{
+	typedef Vertex VertexType;
+	Color color;
+
+	ColoredVertex(Color color) : color(color) {}
+
+	void operator()(Vertex &out, const Position &pos, const Vector3 &normal) const
+	{
+		out.pos = pos;
+		out.color = color;
+		out.normal = normal;
+		out.texCoord.Set(0, 0);
+	}
+};
+
+/******************************************************************************/
+/*!
+		Struct PositionOnly:
+\brief	Bare positions, e.g. for collision geometry
+*/
+/******************************************************************************/
+struct PositionOnly
+{
+	typedef Position VertexType;
+
+	void operator()(Position &out, const Position &pos, const Vector3 &) const
+	{
+		out = pos;
+	}
+};
+
+/******************************************************************************/
+/*!
+		Class ParametricMesh:
+\brief	Grid of (numStack + 1) x (numSlice + 1) vertices drawn as one triangle
+		strip, stack by stack. Surface maps (stack, slice) to a position and
+		normal and Format turns those into a vertex. Both are known at compile
+		time, so Write inlines them into a single loop.
+
+		The counts are exact before anything is generated, so the caller can
+		size a std::vector or a mapped GL buffer once and Write straight into
+		it; nothing is allocated while generating.
+*/
+/******************************************************************************/
+template<typename Surface, typename Format>
+class ParametricMesh
+{
+public:
+	typedef typename Format::VertexType VertexType;
+
+	ParametricMesh(Surface surface, const Format &format, unsigned numStack, unsigned numSlice)
+		: surface(std::move(surface))
+		, format(format)
+		, numStack(numStack)
+		, numSlice(numSlice)
+	{
+	}
+
+	unsigned VertexCount() const { return (numStack + 1) * (numSlice + 1); }
+	unsigned IndexCount() const { return numStack * (numSlice + 1) * 2; }
+	Mesh::DRAW_MODE Mode() const { return Mesh::DRAW_TRIANGLE_STRIP; }
+	AABB Bounds() const { return surface.Bounds(); } //May be larger than the positions written
+
+	//vertices and indices must hold VertexCount() and IndexCount() entries;
+	//baseVertex is added to every index, for appending to a shared buffer
+	void Write(VertexType *vertices, unsigned *indices, unsigned baseVertex = 0) const
+	{
+		Position pos;
+		Vector3 normal;
+		for (unsigned stack = 0; stack < numStack + 1; ++stack)
+		{
+			for (unsigned slice = 0; slice < numSlice + 1; ++slice)
+			{
+				surface(stack, slice, pos, normal);
+				format(*vertices++, pos, normal);
+			}
+		}
+
+		for (unsigned stack = 0; stack < numStack; ++stack)
+		{
+			for (unsigned slice = 0; slice < numSlice + 1; ++slice)
+			{
+				*indices++ = baseVertex + stack * (numSlice + 1) + slice;
+				*indices++ = baseVertex + (stack + 1) * (numSlice + 1) + slice;
+			}
+		}
+	}
+
+private:
+	Surface surface;
+	Format format;
+	unsigned numStack;
+	unsigned numSlice;
+};
+
+template<typename Surface, typename Format>
+ParametricMesh<Surface, Format> MakeParametricMesh(Surface surface, const Format &format, unsigned numStack, unsigned numSlice)
+{
+	return ParametricMesh<Surface, Format>(std::move(surface), format, numStack, numSlice);
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "ProceduralShape.h"
+
+static ProceduralShape MakeShape(ProceduralShape::SHAPE type, Color color, unsigned numStack, unsigned numSlice, float radius, float height, float stackDegrees, float sliceDegrees)
+{
+	ProceduralShape shape;
+	shape.shape = type;
+	shape.numStack = numStack;
+	shape.numSlice = numSlice;
+	shape.params[0] = radius;
+	shape.params[1] = height;
+	shape.params[2] = stackDegrees;
+	shape.params[3] = sliceDegrees;
+	shape.color = color;
+	return shape;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Sphere patch from the south pole up stackDegrees, each stack sweeping
+sliceDegrees around y from +x towards +z
+
+\param color - color of the whole shape
+\param numStack - number of stacks
+\param numSlice - number of slices
+\param radius - radius of the sphere
+\param stackDegrees - 180 for a full sphere, 90 for the lower half
+\param sliceDegrees - 360 for a full sphere
+
+\return Shape to draw with Scene1::RenderShape
+*/
+/******************************************************************************/
+ProceduralShape ProceduralShape::Sphere(Color color, unsigned numStack, unsigned numSlice, float radius, float stackDegrees, float sliceDegrees)
+{
+	return MakeShape(SHAPE_SPHERE, color, numStack, numSlice, radius, 0, stackDegrees, sliceDegrees);
+}
+
+//Open cylinder around y, centred on the origin
+ProceduralShape ProceduralShape::Cylinder(Color color, unsigned numStack, unsigned numSlice, float radius, float height)
+{
+	return MakeShape(SHAPE_CYLINDER, color, numStack, numSlice, radius, height, 0, 360);
+}
+
+//Open cone with its base on y = 0 and its apex at y = height
+ProceduralShape ProceduralShape::Cone(Color color, unsigned numSlice, float radius, float height)
+{
+	return MakeShape(SHAPE_CONE, color, 1, numSlice, radius, height, 0, 360);
+}
+
+//Disc on y = 0 facing +y
+ProceduralShape ProceduralShape::Circle(Color color, unsigned numSlice, float radius)
+{
+	return MakeShape(SHAPE_DISC, color, 1, numSlice, radius, 0, 0, 360);
+}
+
+//Flat ring on y = 0 facing +y
+ProceduralShape ProceduralShape::Ring(Color color, unsigned numSlice, float outerR, float innerR)
+{
+	return MakeShape(SHAPE_DISC, color, 1, numSlice, outerR, innerR, 0, 360);
+}
@@ -0,0 +1,45 @@
+#ifndef PROCEDURAL_SHAPE_H
+#define PROCEDURAL_SHAPE_H
+
+#include "Vertex.h"
+#include "Material.h"
+
+/******************************************************************************/
+/*!
+		Struct ProceduralShape:
+\brief	A parametric shape with no vertex memory at all. The mesh vertex
+		shader rebuilds position, normal and UV from gl_VertexID and these
+		values, drawn with glDrawArrays(GL_TRIANGLES, 0, VertexCount()).
+		Stacks and slices form a grid of cells, two triangles each, wound
+		like the MeshBuilder strips.
+*/
+/******************************************************************************/
+struct ProceduralShape
+{
+	//Must match the SHAPE_ constants in Texture.vertexshader; 0 is a mesh
+	enum SHAPE
+	{
+		SHAPE_SPHERE = 1,
+		SHAPE_CYLINDER,
+		SHAPE_CONE,
+		SHAPE_DISC, //Circle, or ring with an inner radius
+	};
+
+	SHAPE shape;
+	unsigned numStack;
+	unsigned numSlice;
+	float params[4]; //radius, height or inner radius, stack and slice sweep in degrees
+	Color color;
+	Material material;
+
+	unsigned VertexCount() const { return numStack * numSlice * 6; }
+
+	//Same shapes as the MeshBuilder generators of the same name
+	static ProceduralShape Sphere(Color color, unsigned numStack, unsigned numSlice, float radius, float stackDegrees = 180, float sliceDegrees = 360);
+	static ProceduralShape Cylinder(Color color, unsigned numStack, unsigned numSlice, float radius, float height);
+	static ProceduralShape Cone(Color color, unsigned numSlice, float radius, float height);
+	static ProceduralShape Circle(Color color, unsigned numSlice, float radius);
+	static ProceduralShape Ring(Color color, unsigned numSlice, float outerR, float innerR);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include <cassert>
+#include <algorithm>
+#include <functional>
+#include "RenderQueue.h"
+
+RenderCommandList::RenderCommandList() : m_view(NULL), m_viewProjection(NULL)
+{
+}
+
+void RenderCommandList::Draw(const Mtx44 &world, Mesh *mesh, const Material &material, bool enableLight)
+{
+	assert(m_view != NULL && mesh != NULL);
+
+	m_packets.push_back(DrawPacket());
+	DrawPacket &packet = m_packets.back();
+	packet.modelView = *m_view * world;
+	packet.MVP = *m_viewProjection * world;
+	if (enableLight)
+		packet.normalMatrix = packet.modelView.GetNormalMatrix(false);
+	packet.material = &material;
+	packet.mesh = mesh;
+	packet.enableLight = enableLight;
+}
+
+unsigned RenderCommandList::Size() const
+{
+	return m_packets.size();
+}
+
+const DrawPacket& RenderCommandList::operator[](unsigned i) const
+{
+	return m_packets[i];
+}
+
+RenderQueue::RenderQueue() : m_usedLists(0)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::Begin(const Mtx44 &view, const Mtx44 &projection)
+{
+	m_view = view;
+	m_viewProjection = projection * view;
+	for (unsigned i = 0; i < m_usedLists; ++i)
+	{
+		m_lists[i].m_packets.clear();
+	}
+	m_usedLists = 0;
+	m_order.clear();
+}
+
+RenderCommandList& RenderQueue::AcquireList()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_usedLists == m_lists.size())
+	{
+		m_lists.push_back(RenderCommandList());
+	}
+	RenderCommandList &list = m_lists[m_usedLists++];
+	list.m_view = &m_view;
+	list.m_viewProjection = &m_viewProjection;
+	return list;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Gather every recorded packet and sort them so that draws sharing a texture,
+and then a mesh, are submitted together. Only pointers are sorted; the
+packets stay in their lists.
+*/
+/******************************************************************************/
+void RenderQueue::Merge()
+{
+	m_order.clear();
+	for (unsigned i = 0; i < m_usedLists; ++i)
+	{
+		const RenderCommandList &list = m_lists[i];
+		for (unsigned j = 0; j < list.Size(); ++j)
+		{
+			m_order.push_back(&list[j]);
+		}
+	}
+
+	std::sort(m_order.begin(), m_order.end(), [](const DrawPacket *a, const DrawPacket *b) {
+		if (a->mesh->textureID != b->mesh->textureID)
+			return a->mesh->textureID < b->mesh->textureID;
+		return std::less<const Mesh*>()(a->mesh, b->mesh);
+	});
+}
+
+unsigned RenderQueue::Size() const
+{
+	return m_order.size();
+}
+
+const DrawPacket& RenderQueue::operator[](unsigned i) const
+{
+	return *m_order[i];
+}
@@ -0,0 +1,95 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "Mtx44.h"
+#include "Mesh.h"
+#include "Material.h"
+
+/******************************************************************************/
+/*!
+		Struct DrawPacket:
+\brief	Everything one mesh draw needs from the CPU, worked out ahead of
+		time: the matrices the shader takes, the material and the mesh
+*/
+/******************************************************************************/
+struct DrawPacket
+{
+	Mtx44 MVP;
+	Mtx44 modelView;
+	Mtx44 normalMatrix; //Lit packets only
+	const Material *material;
+	Mesh *mesh;
+	bool enableLight;
+};
+
+/******************************************************************************/
+/*!
+		Class RenderCommandList:
+\brief	Draw packets recorded by one task. Makes no GL calls, so any thread
+		can record into its own list.
+*/
+/******************************************************************************/
+class RenderCommandList
+{
+public:
+	RenderCommandList();
+
+	//Work out the matrices of mesh drawn at world and append the packet
+	void Draw(const Mtx44 &world, Mesh *mesh, const Material &material, bool enableLight);
+
+	unsigned Size() const;
+	const DrawPacket& operator[](unsigned i) const;
+
+private:
+	friend class RenderQueue;
+
+	const Mtx44 *m_view;
+	const Mtx44 *m_viewProjection;
+	std::vector<DrawPacket> m_packets;
+};
+
+/******************************************************************************/
+/*!
+		Class RenderQueue:
+\brief	A frame's draws, recorded in parallel and submitted from the GL
+		thread. Begin takes the camera; each task recording draws then
+		takes a list of its own with AcquireList, so recording needs no
+		locking past that. Merge concatenates the lists and sorts the
+		packets by texture and mesh, so the order the tasks ran in does
+		not matter and the submission changes as little GL state as it
+		can.
+
+		Lists and the merged packets keep their memory between frames.
+*/
+/******************************************************************************/
+class RenderQueue
+{
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	//Drop last frame's draws and record against this camera
+	void Begin(const Mtx44 &view, const Mtx44 &projection);
+	//An empty list for the calling task; safe from any thread
+	RenderCommandList& AcquireList();
+	//After every recording task has finished
+	void Merge();
+
+	unsigned Size() const;
+	const DrawPacket& operator[](unsigned i) const;
+
+private:
+	Mtx44 m_view;
+	Mtx44 m_viewProjection;
+
+	std::mutex m_mutex;
+	std::deque<RenderCommandList> m_lists; //A deque, so acquired lists never move
+	unsigned m_usedLists;
+
+	std::vector<const DrawPacket*> m_order; //Merged and sorted
+};
+
+#endif
@@ -8,7 +8,10 @@ public:
 	~Scene() {}
 
 	virtual void Init() = 0;
+	//Fixed step on the simulation thread, running alongside Render
 	virtual void Update(double dt) = 0;
+	//On the GL thread, as often as frames are presented; draws the latest
+	//simulated state, interpolated up to the present
 	virtual void Render() = 0;
 	virtual void Exit() = 0;
 };
@@ -1,5 +1,7 @@
 #include "Scene1.h"
 
+#include <cstring>
+
 #include "GL\glew.h"
 #include "shader.hpp"
 
@@ -10,7 +12,17 @@
 #include "Utility.h"
 
 #include "LoadTGA.h"
-
+#include "TaskGraph.h"
+#include "EntitySystems.h"
+#include "SceneFile.h"
+#include "CookedMesh.h"
+
+//The camera keeps this far from colliders
+static const float CAMERA_RADIUS = 1.0f;
+//Visible nodes recorded per task
+static const unsigned RECORD_GRAIN = 64;
+//Static batches are baked into world space
+static const Mtx44 IDENTITY(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
 
 Scene1::Scene1()
 {
@@ -31,6 +43,8 @@ void Scene1::Init()
 	glEnable(GL_CULL_FACE);
 	//Default to Fill Mode
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	//Sample across cube map face edges for the skybox
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 	//Enable blending
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -39,8 +53,62 @@ void Scene1::Init()
 	glGenVertexArrays(1, &m_vertexArrayID);
 	glBindVertexArray(m_vertexArrayID);
 
+	//Start the init workers and background asset loading
+	threadPool.Init();
+	streamer.Init();
+
+	//Initialize all meshes to NULL
+	for (int i = 0; i < NUM_GEOMETRY; ++i)
+	{
+		meshList[i] = NULL;
+	}
+
+	//The character's parts are merged into one skinned mesh on a worker
+	//while the shaders compile below, then uploaded on this thread
+	SkinnedMeshData characterData;
+	TaskGraph initGraph;
+
+	TaskGraph::TaskID uploadMeshes = initGraph.Add([&]() {
+		character.Upload(characterData);
+	}, TaskGraph::MAIN_THREAD);
+	initGraph.Depend(uploadMeshes, initGraph.Add([&]() { character.Build(characterData); }));
+
+	//The fixed primitives are baked at compile time and only uploaded here
+	meshList[GEO_AXES] = primitives.Acquire("reference", BakedMeshes::AXES);
+	meshList[GEO_QUAD] = primitives.Acquire("Plane", BakedMeshes::QUAD, Color(1, 1, 1), 1);
+	meshList[GEO_PLANE] = primitives.Acquire("Plane", BakedMeshes::QUAD, Color(0, 0, 0), 50);
+
+	//TEXT
+	meshList[GEO_TEXT] = primitives.Acquire("text", BakedMeshes::TEXT);
+
+	//Skybox
+	meshList[GEO_SKYBOX] = primitives.Acquire("Skybox", BakedMeshes::SKYBOX);
+
+	//Textures are assigned to the meshes, so they wait for the upload
+	TaskGraph::TaskID loadTextures = initGraph.Add([&]() {
+		//Streamed in the background, shows a placeholder until uploaded
+		meshList[GEO_TEXT]->textureID = streamer.RequestTGA("Image//calibri.tga");
+
+		const char *skyboxFaces[6] = {
+			"Image//right.tga",
+			"Image//left.tga",
+			"Image//top.tga",
+			"Image//bottom.tga",
+			"Image//back.tga",
+			"Image//front.tga",
+		};
+		meshList[GEO_SKYBOX]->textureID = streamer.RequestTGACubemap(skyboxFaces);
+	}, TaskGraph::MAIN_THREAD);
+	initGraph.Depend(loadTextures, uploadMeshes);
+
+	initGraph.Start(threadPool);
+
 	//Load vertex and fragment shaders 
 	m_programID = LoadShaders("Shader//Texture.vertexshader", "Shader//Text.fragmentshader");
+	m_skyboxProgramID = LoadShaders("Shader//Skybox.vertexshader", "Shader//Skybox.fragmentshader");
+
+	m_parameters[U_SKYBOX_VP] = glGetUniformLocation(m_skyboxProgramID, "VP");
+	m_parameters[U_SKYBOX_CUBEMAP] = glGetUniformLocation(m_skyboxProgramID, "skybox");
 
 	m_parameters[U_MVP] = glGetUniformLocation(m_programID, "MVP");
 	m_parameters[U_MODELVIEW] = glGetUniformLocation(m_programID, "MV");
@@ -71,28 +139,32 @@ void Scene1::Init()
 	m_parameters[U_TEXT_ENABLED] = glGetUniformLocation(m_programID,"textEnabled");
 	m_parameters[U_TEXT_COLOR] = glGetUniformLocation(m_programID,"textColor");
 
+	m_parameters[U_SHAPE] = glGetUniformLocation(m_programID, "shape");
+	m_parameters[U_SHAPE_PARAMS] = glGetUniformLocation(m_programID, "shapeParams");
+	m_parameters[U_SHAPE_COLOR] = glGetUniformLocation(m_programID, "shapeColor");
+
+	m_parameters[U_SKINNED] = glGetUniformLocation(m_programID, "skinned");
+
 	m_parameters[U_COLOR_TEXTURE_ENABLED] = glGetUniformLocation(m_programID, "colorTextureEnabled");
 	m_parameters[U_COLOR_TEXTURE] = glGetUniformLocation(m_programID, "colorTexture");
 
 	// Use our shader 
 	glUseProgram(m_programID);
+	glUniform1i(m_parameters[U_SKINNED], 0);
+
+	//Joint palette uniform block at binding point 0, refilled before each skinned draw
+	glGenBuffers(1, &m_paletteBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_paletteBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, Skeleton::MAX_JOINTS * sizeof(Mtx44), NULL, GL_DYNAMIC_DRAW);
+	glUniformBlockBinding(m_programID, glGetUniformBlockIndex(m_programID, "JointPalette"), 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_paletteBuffer);
 	// Get a handle for our "MVP" uniform
 	m_parameters[U_MVP] = glGetUniformLocation(m_programID, "MVP");
 
-	//Initialize Light Parameters
-	//First Light
-	light[0].type = Light::LIGHT_SPOT;
-	light[0].position.Set(0, 60, 30);
-	light[0].color.Set(1, 1, 1);
-	light[0].power = 5;
-	light[0].kC = 0.1f;
-	light[0].kL = 0.01f;
-	light[0].kQ = 0.001f;
-	light[0].cosCutoff = cos(Math::DegreeToRadian(45));
-	light[0].cosInner = cos(Math::DegreeToRadian(30));
-	light[0].exponent - 3.0f;
-	light[0].spotDirection.Set(0.0f, 5.0f, 0.0f);
+	//Meshes, hierarchy and lights authored in Scene//Scene1.txt
+	LoadScene("Scene//Scene1.scene");
 
+	//First Light
 	glUniform1f(m_parameters[U_LIGHT0_TYPE], light[0].type);
 	glUniform3fv(m_parameters[U_LIGHT0_COLOR], 1, &light[0].color.r);
 	glUniform1f(m_parameters[U_LIGHT0_POWER], light[0].power);
@@ -104,103 +176,343 @@ void Scene1::Init()
 	glUniform1f(m_parameters[U_LIGHT0_EXPONENT], light[0].exponent);
 
 	glUniform1i(m_parameters[U_NUMLIGHTS], 1);
+	lightGizmo = ProceduralShape::Sphere(light[0].color, 9, 18, 1);
 
 	//Initialize camera settings
 	camera.Init(Vector3(0, 20, -100), Vector3(0, 45, 180), Vector3(0, 1, 0));
+	camera.SetCollision(&collision, CAMERA_RADIUS);
+	picking = false;
+	hasPick = false;
 
-	//Initialize all meshes to NULL
-	for (int i = 0; i < NUM_GEOMETRY; ++i)
-	{
-		meshList[i] = NULL;
-	}
-
-	meshList[GEO_AXES] = MeshBuilder::GenerateAxes("reference", 1000, 1000, 1000);
-	meshList[GEO_QUAD] = MeshBuilder::GenerateQuad("Plane", Color(1, 1, 1), 1);
-	meshList[GEO_PLANE] = MeshBuilder::GenerateQuad("Plane", Color(0, 0, 0), 50);
-
-	//TEXT
-	meshList[GEO_TEXT] = MeshBuilder::GenerateText("text", 16, 16);
-
-	//Skybox
-	meshList[GEO_FRONT] = MeshBuilder::GenerateQuad("SkyFront", Color(1, 1, 1), 1.f);
-	meshList[GEO_BACK] = MeshBuilder::GenerateQuad("SkyBack", Color(1, 1, 1), 1.f);
-	meshList[GEO_TOP] = MeshBuilder::GenerateQuad("SkyTop", Color(1, 1, 1), 1.f);
-	meshList[GEO_LEFT] = MeshBuilder::GenerateQuad("SkyLeft", Color(1, 1, 1), 1.f);
-	meshList[GEO_RIGHT] = MeshBuilder::GenerateQuad("SkyRight", Color(1, 1, 1), 1.f);
-	meshList[GEO_BOTTOM] = MeshBuilder::GenerateQuad("SkyBottom", Color(1, 1, 1), 1.f);
-	
-	//Texture Load
-	meshList[GEO_TEXT]->textureID = LoadTGA("Image//calibri.tga");
-
-	//Skybox
-	meshList[GEO_FRONT]->textureID = LoadTGA("Image//front.tga");
-	meshList[GEO_BACK]->textureID = LoadTGA("Image//back.tga");
-	meshList[GEO_TOP]->textureID = LoadTGA("Image//top.tga");
-	meshList[GEO_LEFT]->textureID = LoadTGA("Image//left.tga");
-	meshList[GEO_RIGHT]->textureID = LoadTGA("Image//right.tga");
-	meshList[GEO_BOTTOM]->textureID = LoadTGA("Image//bottom.tga");
+	//Upload the built meshes and load textures
+	initGraph.Wait();
 
 	Mtx44 projection;
 	projection.SetToPerspective(45.0f, 4.0f / 3.0f, 0.1f, 10000.0f);
 	projectionStack.LoadMatrix(projection);
+
+	//Render has a state to draw before the first step: the initial one twice
+	CaptureState(simState);
+	PublishSnapshot(1.0 / 60);
 }
 
 static float ROT_LIMIT = 45.0f;
 static float SCALE_LIMIT = 5.0f;
 
+//Runs on the simulation thread: no GL calls, and nothing Render reads
+//except through the snapshots
 void Scene1::Update(double dt)
 {
 	static const float LSPEED = 30.0f;
 
-	if (Application::IsKeyPressed('1'))
+	camera.Update(dt);
+
+	//Walks on the spot while G is held
+	character.Update((float)dt, Application::IsKeyPressed('G'));
+
+	EntitySystems::Animate(entities, threadPool, (float)dt);
+	EntitySystems::UpdateTransforms(entities, threadPool);
+	EntitySystems::UpdateLights(entities, threadPool);
+
+	PublishSnapshot(dt);
+}
+
+//Copy out what Render draws; simulation thread
+void Scene1::CaptureState(SimState &state)
+{
+	state.cameraPosition = camera.position;
+	state.cameraTarget = camera.target;
+	state.cameraUp = camera.up;
+	if (lightEntity != EntityWorld::NO_ENTITY)
+		state.light = entities.GetTransform(lightEntity).local;
+	state.characterPose = character.GetPose();
+
+	state.entityLocals.clear();
+	state.entityRenders.clear();
+	entities.ForEach(COMPONENT_TRANSFORM | COMPONENT_RENDER, [&state](Archetype &archetype, unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+		{
+			state.entityLocals.push_back(archetype.transforms[i].local);
+			state.entityRenders.push_back(archetype.renders[i]);
+		}
+	});
+}
+
+/******************************************************************************/
+/*!
+\brief
+Publish the step just simulated together with the one before it, so Render
+can interpolate between the two while the next step runs. Every field of the
+back snapshot is set; its vectors keep their capacity from step to step.
+
+\param step - seconds the step simulated
+*/
+/******************************************************************************/
+void Scene1::PublishSnapshot(double step)
+{
+	Snapshot &snapshot = snapshots.Back();
+	snapshot.previous = simState;
+	CaptureState(simState);
+	snapshot.current = simState;
+	snapshot.time = std::chrono::steady_clock::now();
+	snapshot.step = step;
+	snapshots.Publish();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Populate the scene from a compiled scene file in one pass over its records:
+meshes are created, materials copied, nodes added to the scene graph in the
+file's depth first order and lights made into entities at their nodes
+
+\param file_path - .scene file, compiled with "-scene"
+
+\return false, leaving the scene empty, if the file could not be opened
+*/
+/******************************************************************************/
+bool Scene1::LoadScene(const char *file_path)
+{
+	lightEntity = EntityWorld::NO_ENTITY;
+
+	SceneFile scene;
+	if (!scene.Open(file_path))
+		return false;
+
+	static const struct { const char *name; const BakedMesh *baked; } BAKED[] = {
+		{ "axes", &BakedMeshes::AXES },
+		{ "quad", &BakedMeshes::QUAD },
+		{ "cube", &BakedMeshes::CUBE },
+		{ "skybox", &BakedMeshes::SKYBOX },
+		{ "text", &BakedMeshes::TEXT },
+	};
+
+	sceneMeshes.assign(scene.MeshCount(), (Mesh*)NULL);
+	//CPU copies, kept until the colliders are baked from them
+	std::vector<MeshData> geometry(scene.MeshCount());
+	for (unsigned i = 0; i < scene.MeshCount(); ++i)
 	{
-		glEnable(GL_CULL_FACE);
+		const SceneMeshRecord &record = scene.Meshes()[i];
+		const char *name = scene.String(record.name);
+		const char *path = scene.String(record.path);
+		if (record.source == SceneMeshRecord::SOURCE_BAKED)
+		{
+			for (unsigned j = 0; j < sizeof(BAKED) / sizeof(BAKED[0]); ++j)
+			{
+				if (strcmp(path, BAKED[j].name) != 0)
+					continue;
+				const BakedMesh &baked = *BAKED[j].baked;
+				sceneMeshes[i] = record.scale == 0 ?
+					primitives.Acquire(name, baked) :
+					primitives.Acquire(name, baked, Color(record.color[0], record.color[1], record.color[2]), record.scale);
+
+				geometry[i].vertices.assign(baked.vertices, baked.vertices + baked.vertexCount);
+				geometry[i].indices.assign(baked.indices, baked.indices + baked.indexCount);
+				geometry[i].mode = baked.mode;
+				for (unsigned k = 0; k < baked.vertexCount && record.scale != 0; ++k)
+				{
+					Vertex &v = geometry[i].vertices[k];
+					v.pos.Set(v.pos.x * record.scale, v.pos.y * record.scale, v.pos.z * record.scale);
+					v.color.Set(record.color[0], record.color[1], record.color[2]);
+				}
+			}
+		}
+		else if (record.source == SceneMeshRecord::SOURCE_OBJ)
+		{
+			if (MeshBuilder::BuildOBJ(path, geometry[i]))
+				sceneMeshes[i] = MeshBuilder::Create(name, geometry[i]);
+		}
+		else
+		{
+			if (LoadCookedMesh(path, geometry[i]))
+				sceneMeshes[i] = MeshBuilder::Create(name, geometry[i]);
+		}
 	}
-	if (Application::IsKeyPressed('2'))
+
+	//Sized once; the scene graph keeps pointers to these
+	sceneMaterials.resize(scene.MaterialCount());
+	for (unsigned i = 0; i < scene.MaterialCount(); ++i)
 	{
-		glDisable(GL_CULL_FACE);
+		const SceneMaterialRecord &record = scene.Materials()[i];
+		sceneMaterials[i].kAmbient.Set(record.ambient[0], record.ambient[1], record.ambient[2]);
+		sceneMaterials[i].kDiffuse.Set(record.diffuse[0], record.diffuse[1], record.diffuse[2]);
+		sceneMaterials[i].kSpecular.Set(record.specular[0], record.specular[1], record.specular[2]);
+		sceneMaterials[i].kShininess = record.shininess;
 	}
-	if (Application::IsKeyPressed('3'))
+
+	//Parents come first, so each node's parent and world transform are known
+	std::vector<SceneGraph::NodeID> nodes(scene.NodeCount());
+	std::vector<Transform> worlds(scene.NodeCount());
+	for (unsigned i = 0; i < scene.NodeCount(); ++i)
 	{
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		const SceneNodeRecord &record = scene.Nodes()[i];
+		Transform local(Vector3(record.translation[0], record.translation[1], record.translation[2]),
+			Quaternion(record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3]),
+			Vector3(record.scale[0], record.scale[1], record.scale[2]));
+		Mesh *mesh = record.mesh == SCENE_NONE ? NULL : sceneMeshes[record.mesh];
+
+		if (record.parent == SCENE_NONE)
+		{
+			nodes[i] = sceneGraph.AddNode(SceneGraph::NO_NODE, local, mesh);
+			worlds[i] = local;
+		}
+		else
+		{
+			nodes[i] = sceneGraph.AddNode(nodes[record.parent], local, mesh);
+			worlds[i] = worlds[record.parent] * local;
+		}
+		if (record.material != SCENE_NONE)
+			sceneGraph.SetMaterial(nodes[i], &sceneMaterials[record.material]);
+		sceneGraph.SetVisible(nodes[i], (record.flags & SceneNodeRecord::FLAG_VISIBLE) != 0);
+		sceneGraph.SetLighting(nodes[i], (record.flags & SceneNodeRecord::FLAG_LIGHTING) != 0);
 	}
-	if (Application::IsKeyPressed('4'))
+
+	//The shader has room for four lights
+	for (unsigned i = 0; i < scene.LightCount() && i < 4; ++i)
 	{
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+		const SceneLightRecord &record = scene.Lights()[i];
+		light[i].type = (Light::LIGHT_TYPE)record.type;
+		light[i].color.Set(record.color[0], record.color[1], record.color[2]);
+		light[i].power = record.power;
+		light[i].kC = record.kC;
+		light[i].kL = record.kL;
+		light[i].kQ = record.kQ;
+		light[i].spotDirection.Set(record.spotDirection[0], record.spotDirection[1], record.spotDirection[2]);
+		light[i].cosCutoff = record.cosCutoff;
+		light[i].cosInner = record.cosInner;
+		light[i].exponent = record.exponent;
+
+		const Vector3 &position = worlds[record.node].translation;
+		light[i].position.Set(position.x, position.y, position.z);
+
+		EntityWorld::EntityID entity = entities.Create(COMPONENT_TRANSFORM | COMPONENT_LIGHT);
+		entities.GetTransform(entity).local = worlds[record.node];
+		entities.GetLight(entity).light = &light[i];
+		if (i == 0)
+			lightEntity = entity;
 	}
 
-	camera.Update(dt);
+	//Untextured static nodes are merged into batches and drawn by those
+	//instead, so they are hidden from the graph
+	sceneGraph.Update();
+	for (unsigned i = 0; i < scene.NodeCount(); ++i)
+	{
+		const SceneNodeRecord &record = scene.Nodes()[i];
+		const unsigned batchFlags = SceneNodeRecord::FLAG_STATIC | SceneNodeRecord::FLAG_VISIBLE;
+		if ((record.flags & batchFlags) != batchFlags || record.mesh == SCENE_NONE ||
+			sceneMeshes[record.mesh] == NULL || sceneMeshes[record.mesh]->textureID != 0)
+			continue;
+
+		const Material &material = record.material == SCENE_NONE ? sceneMeshes[record.mesh]->material : sceneMaterials[record.material];
+		if (staticBatch.Add(geometry[record.mesh], sceneGraph.GetWorld(nodes[i]), material, (record.flags & SceneNodeRecord::FLAG_LIGHTING) != 0))
+			sceneGraph.SetVisible(nodes[i], false);
+	}
+	staticBatch.Build();
+
+	//The scene is static, so its boxes are placed once and never refit;
+	//hidden and batched nodes are never drawn and left out
+	for (unsigned i = 0; i < sceneGraph.Size(); ++i)
+	{
+		if (sceneGraph.GetMesh(i) != NULL && sceneGraph.IsVisible(i))
+			cullingBvh.Insert(sceneGraph.GetMesh(i)->bounds.Transformed(sceneGraph.GetWorldAt(i)), i);
+	}
+	cullingBvh.Build();
+
+	//Colliders are baked at their world transforms and hit by node
+	for (unsigned i = 0; i < scene.NodeCount(); ++i)
+	{
+		const SceneNodeRecord &record = scene.Nodes()[i];
+		if ((record.flags & SceneNodeRecord::FLAG_COLLISION) && record.mesh != SCENE_NONE)
+			collision.Add(geometry[record.mesh], sceneGraph.GetWorld(nodes[i]), nodes[i]);
+	}
+	collision.Build();
+	return true;
 }
 
-static const float SKYBOXSIZE = 2000.f;
+//Clip space point back through the inverse view projection
+static Vector3 Unproject(const Mtx44 &inverse, float x, float y, float z)
+{
+	const float *a = inverse.a;
+	float w = a[3] * x + a[7] * y + a[11] * z + a[15];
+	return Vector3((a[0] * x + a[4] * y + a[8] * z + a[12]) / w,
+		(a[1] * x + a[5] * y + a[9] * z + a[13]) / w,
+		(a[2] * x + a[6] * y + a[10] * z + a[14]) / w);
+}
 
-//Mesh Renderer
-void Scene1::RenderMesh(Mesh* mesh, bool enableLight)
+/******************************************************************************/
+/*!
+\brief
+Cast the ray under the cursor, from the near plane to the far plane, into
+the scene's colliders and keep the nearest hit
+*/
+/******************************************************************************/
+void Scene1::Pick()
 {
-	Mtx44 MVP, modelView, modelView_inverse_transpose;
+	double x, y;
+	int width, height;
+	Application::GetCursorPos(x, y);
+	Application::GetWindowSize(width, height);
+	if (width <= 0 || height <= 0)
+		return;
 
-	MVP = projectionStack.Top() * viewStack.Top() * modelStack.Top();
-	glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
+	Mtx44 view, inverse;
+	view.SetToLookAt(viewPosition.x, viewPosition.y, viewPosition.z,
+		viewTarget.x, viewTarget.y, viewTarget.z,
+		viewUp.x, viewUp.y, viewUp.z);
+	if (!(projectionStack.Top() * view).TryGetInverse(inverse))
+		return;
+
+	float ndcX = (float)(2 * x / width - 1), ndcY = (float)(1 - 2 * y / height);
+	Vector3 nearPoint = Unproject(inverse, ndcX, ndcY, -1);
+	Vector3 farPoint = Unproject(inverse, ndcX, ndcY, 1);
 
-	modelView = viewStack.Top() * modelStack.Top();
+	CollisionHit hit;
+	hasPick = collision.Raycast(Ray(nearPoint, farPoint - nearPoint, 1), hit);
+	if (hasPick)
+	{
+		pickPoint = hit.point;
+	}
+}
+
+//Matrices of the current stacks, and the material if lit
+void Scene1::SetDrawUniforms(const Material &material, bool enableLight)
+{
+	transforms.Update(projectionStack, viewStack, modelStack);
+	SetDrawUniforms(transforms.GetMVP(), transforms.GetModelView(), enableLight ? &transforms.GetNormalMatrix() : NULL, material);
+}
+
+//Given matrices, lit with the material if there is a normal matrix
+void Scene1::SetDrawUniforms(const Mtx44 &MVP, const Mtx44 &modelView, const Mtx44 *normalMatrix, const Material &material)
+{
+	glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
 	glUniformMatrix4fv(m_parameters[U_MODELVIEW], 1, GL_FALSE, &modelView.a[0]);
 
-	if (enableLight)
+	if (normalMatrix != NULL)
 	{
 		glUniform1i(m_parameters[U_LIGHTENABLED], 1);
-		modelView_inverse_transpose = modelView.GetInverse().GetTranspose();
-		glUniformMatrix4fv(m_parameters[U_MODELVIEW_INVERSE_TRANSPOSE], 1, GL_FALSE, &modelView_inverse_transpose.a[0]);
+		glUniformMatrix4fv(m_parameters[U_MODELVIEW_INVERSE_TRANSPOSE], 1, GL_FALSE, &normalMatrix->a[0]);
 
 		//load material
-		glUniform3fv(m_parameters[U_MATERIAL_AMBIENT], 1, &mesh->material.kAmbient.r);
-		glUniform3fv(m_parameters[U_MATERIAL_DIFFUSE], 1, &mesh->material.kDiffuse.r);
-		glUniform3fv(m_parameters[U_MATERIAL_SPECULAR], 1, &mesh->material.kSpecular.r);
-		glUniform1f(m_parameters[U_MATERIAL_SHININESS], mesh->material.kShininess);
+		glUniform3fv(m_parameters[U_MATERIAL_AMBIENT], 1, &material.kAmbient.r);
+		glUniform3fv(m_parameters[U_MATERIAL_DIFFUSE], 1, &material.kDiffuse.r);
+		glUniform3fv(m_parameters[U_MATERIAL_SPECULAR], 1, &material.kSpecular.r);
+		glUniform1f(m_parameters[U_MATERIAL_SHININESS], material.kShininess);
 	}
 	else
 	{
 		glUniform1i(m_parameters[U_LIGHTENABLED], 0);
 	}
+}
+
+//Mesh Renderer
+void Scene1::RenderMesh(Mesh* mesh, bool enableLight)
+{
+	RenderMesh(mesh, mesh->material, enableLight);
+}
+
+void Scene1::RenderMesh(Mesh* mesh, const Material &material, bool enableLight)
+{
+	SetDrawUniforms(material, enableLight);
 
 	if (mesh->textureID > 0)
 	{
@@ -222,59 +534,170 @@ void Scene1::RenderMesh(Mesh* mesh, bool enableLight)
 	}
 }
 
-//SkyBox Renderer
-void Scene1::RenderSkybox()
+/******************************************************************************/
+/*!
+\brief
+Cull the scene graph against the view and record the visible nodes, split
+into ranges across the thread pool, each range into its own list, and then
+the visible static batches
+*/
+/******************************************************************************/
+void Scene1::RecordGraph()
 {
-	//Left
-	modelStack.PushMatrix();
-	modelStack.Rotate(90, 0, 1, 0);
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_LEFT], false);
-	modelStack.PopMatrix();
+	Frustum frustum(projectionStack.Top() * viewStack.Top());
+	visibleNodes.clear();
+	cullingBvh.Query(frustum, visibleNodes);
 
-	//Right
-	modelStack.PushMatrix();
-	modelStack.Rotate(-90, 0, 1, 0);
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_RIGHT], false);
-	modelStack.PopMatrix();
+	threadPool.ParallelFor(visibleNodes.size(), RECORD_GRAIN, [this](unsigned begin, unsigned end) {
+		RenderCommandList &list = drawQueue.AcquireList();
+		for (unsigned j = begin; j < end; ++j)
+		{
+			unsigned i = visibleNodes[j];
+			if (sceneGraph.IsVisible(i))
+				list.Draw(sceneGraph.GetWorldAt(i), sceneGraph.GetMesh(i), sceneGraph.GetMaterial(i), sceneGraph.IsLit(i));
+		}
+	});
 
-	//Front
-	modelStack.PushMatrix();
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_FRONT], false);
-	modelStack.PopMatrix();
+	//A handful of static batches, one draw per cell and material, recorded here
+	visibleBatches.clear();
+	staticBatch.Query(frustum, visibleBatches);
+	if (!visibleBatches.empty())
+	{
+		RenderCommandList &list = drawQueue.AcquireList();
+		for (unsigned j = 0; j < visibleBatches.size(); ++j)
+		{
+			unsigned i = visibleBatches[j];
+			list.Draw(IDENTITY, staticBatch.GetMesh(i), staticBatch.GetMaterial(i), staticBatch.IsLit(i));
+		}
+	}
+}
+
+//Renderable entities of the snapshot at alpha between its steps, each range into its own list
+void Scene1::RecordEntities(const SimState &from, const SimState &to, float alpha)
+{
+	renderLocals = to.entityLocals;
+	if (from.entityLocals.size() == to.entityLocals.size() && !to.entityLocals.empty())
+		Transform::Lerp(&from.entityLocals[0], &to.entityLocals[0], alpha, &renderLocals[0], renderLocals.size());
+
+	threadPool.ParallelFor(renderLocals.size(), RECORD_GRAIN, [this, &to](unsigned begin, unsigned end) {
+		RenderCommandList &list = drawQueue.AcquireList();
+		for (unsigned i = begin; i < end; ++i)
+		{
+			const RenderComponent &render = to.entityRenders[i];
+			if (render.mesh != NULL)
+				list.Draw(renderLocals[i].GetMatrix(), render.mesh, render.material ? *render.material : render.mesh->material, render.enableLight);
+		}
+	});
+}
 
-	//Back
+//Replay the merged draws on this, the GL thread, binding each texture once per run of draws using it
+void Scene1::SubmitDraws()
+{
+	unsigned boundTexture = 0;
+	glUniform1i(m_parameters[U_COLOR_TEXTURE_ENABLED], 0);
+	for (unsigned i = 0; i < drawQueue.Size(); ++i)
+	{
+		const DrawPacket &packet = drawQueue[i];
+		SetDrawUniforms(packet.MVP, packet.modelView, packet.enableLight ? &packet.normalMatrix : NULL, *packet.material);
+
+		if (packet.mesh->textureID != boundTexture)
+		{
+			boundTexture = packet.mesh->textureID;
+			glUniform1i(m_parameters[U_COLOR_TEXTURE_ENABLED], boundTexture > 0 ? 1 : 0);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, boundTexture);
+			glUniform1i(m_parameters[U_COLOR_TEXTURE], 0);
+		}
+
+		packet.mesh->Render();
+	}
+	if (boundTexture > 0)
+	{
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+}
+
+void Scene1::RenderShape(const ProceduralShape &shape, bool enableLight)
+{
+	SetDrawUniforms(shape.material, enableLight);
+	glUniform1i(m_parameters[U_COLOR_TEXTURE_ENABLED], 0);
+
+	glUniform3i(m_parameters[U_SHAPE], shape.shape, shape.numStack, shape.numSlice);
+	glUniform4fv(m_parameters[U_SHAPE_PARAMS], 1, shape.params);
+	glUniform3fv(m_parameters[U_SHAPE_COLOR], 1, &shape.color.r);
+
+	glDrawArrays(GL_TRIANGLES, 0, shape.VertexCount());
+
+	glUniform3i(m_parameters[U_SHAPE], 0, 0, 0);
+}
+
+/******************************************************************************/
+/*!
+\brief
+Draw the character in one call: the poses sampled by the last two steps are
+blended at alpha into its palette, which goes into the uniform block for the
+shader to skin every vertex with
+*/
+/******************************************************************************/
+void Scene1::RenderCharacter(const SimState &from, const SimState &to, float alpha)
+{
+	SkinnedMesh *mesh = character.GetMesh();
+	if (mesh == NULL || mesh->indexSize == 0 || to.characterPose.size() != character.GetJointCount())
+		return;
+
+	if (from.characterPose.size() == to.characterPose.size())
+		BlendPoses(from.characterPose, to.characterPose, alpha, renderPose);
+	else
+		renderPose = to.characterPose;
+	character.ComputePalette(renderPose, palette);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_paletteBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, character.GetJointCount() * sizeof(Mtx44), palette);
+
+	//Facing the camera's start
 	modelStack.PushMatrix();
+	modelStack.Translate(0, 0, -60);
 	modelStack.Rotate(180, 0, 1, 0);
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_BACK], false);
-	modelStack.PopMatrix();
+	modelStack.Scale(2, 2, 2);
+	SetDrawUniforms(mesh->material, true);
+	glUniform1i(m_parameters[U_COLOR_TEXTURE_ENABLED], 0);
+	glUniform1i(m_parameters[U_SKINNED], 1);
 
-	//Top
-	modelStack.PushMatrix();
-	modelStack.Rotate(90, 1, 0, 0);
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Rotate(90, 0, 0, 1);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_TOP], false);
-	modelStack.PopMatrix();
+	mesh->Render();
 
-	//Bottom
-	modelStack.PushMatrix();
-	modelStack.Rotate(-90, 1, 0, 0);
-	modelStack.Translate(0, 0, -SKYBOXSIZE / 2 + 2.f);
-	modelStack.Rotate(-90, 0, 0, 1);
-	modelStack.Scale(SKYBOXSIZE, SKYBOXSIZE, SKYBOXSIZE);
-	RenderMesh(meshList[GEO_BOTTOM], false);
+	glUniform1i(m_parameters[U_SKINNED], 0);
 	modelStack.PopMatrix();
 }
 
+//SkyBox Renderer
+//Drawn after the opaque scene: depth is forced to 1 in the shader, so early-Z
+//rejects every pixel that is already covered
+void Scene1::RenderSkybox()
+{
+	Mesh *mesh = meshList[GEO_SKYBOX];
+	if (!mesh || mesh->textureID <= 0)
+		return;
+
+	//Keep only the camera rotation so the sky never moves with the camera
+	Mtx44 view = viewStack.Top();
+	view.a[12] = view.a[13] = view.a[14] = 0;
+	Mtx44 VP = projectionStack.Top() * view;
+
+	glUseProgram(m_skyboxProgramID);
+	glUniformMatrix4fv(m_parameters[U_SKYBOX_VP], 1, GL_FALSE, &VP.a[0]);
+
+	glDepthFunc(GL_LEQUAL);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, mesh->textureID);
+	glUniform1i(m_parameters[U_SKYBOX_CUBEMAP], 0);
+
+	mesh->Render();
+
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	glDepthFunc(GL_LESS);
+	glUseProgram(m_programID);
+}
+
 //Text Renderer
 void Scene1::RenderText(Mesh* mesh, std::string text, Color color)
 {
@@ -289,11 +712,12 @@ void Scene1::RenderText(Mesh* mesh, std::string text, Color color)
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, mesh->textureID);
 	glUniform1i(m_parameters[U_COLOR_TEXTURE], 0);
+	transforms.Update(projectionStack, viewStack, modelStack);
 	for (unsigned i = 0; i < text.length(); ++i)
 	{
 		Mtx44 characterSpacing;
 		characterSpacing.SetToTranslation(i * 1.0f, 0, 0); //1.0f is the spacing of each character, you may change this value
-		Mtx44 MVP = projectionStack.Top() * viewStack.Top() * modelStack.Top() * characterSpacing;
+		Mtx44 MVP = transforms.GetMVP() * characterSpacing;
 		glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
 		
 		mesh->Render((unsigned)text[i] * 6, 6);
@@ -329,11 +753,12 @@ void Scene1::RenderTextOnScreen(Mesh * mesh, std::string text, Color color, floa
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, mesh->textureID);
 	glUniform1i(m_parameters[U_COLOR_TEXTURE], 0);
+	transforms.Update(projectionStack, viewStack, modelStack);
 	for (unsigned i = 0; i < text.length(); ++i)
 	{
 		Mtx44 characterSpacing;
 		characterSpacing.SetToTranslation(i * 1.0f, 0, 0); //1.0f is the spacing of each character, you may change this value
-		Mtx44 MVP = projectionStack.Top() * viewStack.Top() * modelStack.Top() * characterSpacing;
+		Mtx44 MVP = transforms.GetMVP() * characterSpacing;
 		glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
 
 		mesh->Render((unsigned)text[i] * 6, 6);
@@ -352,29 +777,96 @@ Mtx44 MVP, modelView, modelView_inverse_transpose;
 
 void Scene1::Render()
 {
+	//Upload streamed assets within this frame's budget
+	streamer.Update();
+
+	//GL state, so toggled here on the GL thread
+	if (Application::IsKeyPressed('1'))
+	{
+		glEnable(GL_CULL_FACE);
+	}
+	if (Application::IsKeyPressed('2'))
+	{
+		glDisable(GL_CULL_FACE);
+	}
+	if (Application::IsKeyPressed('3'))
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	}
+	if (Application::IsKeyPressed('4'))
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+	}
+
+	//The newest step, drawn as far between it and the step before as the
+	//clock is into the next step; rendering lags the simulation by one step
+	snapshots.Acquire();
+	const Snapshot &snapshot = snapshots.Front();
+	float alpha = (float)(std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshot.time).count() / snapshot.step);
+	alpha = alpha < 0 ? 0 : alpha > 1 ? 1 : alpha;
+	const SimState &from = snapshot.previous, &to = snapshot.current;
+
+	viewPosition = from.cameraPosition + (to.cameraPosition - from.cameraPosition) * alpha;
+	viewTarget = from.cameraTarget + (to.cameraTarget - from.cameraTarget) * alpha;
+	viewUp = from.cameraUp + (to.cameraUp - from.cameraUp) * alpha;
+	Transform lightTransform = Transform::Lerp(from.light, to.light, alpha);
+
+	//Pick once per click, through the cursor; the cursor is read on this thread
+	bool click = Application::IsKeyPressed(VK_LBUTTON);
+	if (click && !picking)
+	{
+		Pick();
+	}
+	picking = click;
+
 	//Clear color & depth buffer every frame 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	viewStack.LoadIdentity();
-	viewStack.LookAt(camera.position.x, camera.position.y, camera.position.z,
-		camera.target.x, camera.target.y, camera.target.z,
-		camera.up.x, camera.up.y, camera.up.z);
+	viewStack.LookAt(viewPosition.x, viewPosition.y, viewPosition.z,
+		viewTarget.x, viewTarget.y, viewTarget.z,
+		viewUp.x, viewUp.y, viewUp.z);
 	modelStack.LoadIdentity();
 
-	Position lightPosition_cameraspace = viewStack.Top() * light[0].position;
+	//light[0] itself is moved on the simulation thread
+	Position lightPosition(lightTransform.translation.x, lightTransform.translation.y, lightTransform.translation.z);
+	if (lightEntity == EntityWorld::NO_ENTITY)
+		lightPosition = light[0].position;
+	Position lightPosition_cameraspace = viewStack.Top() * lightPosition;
 	glUniform3fv(m_parameters[U_LIGHT0_POSITION], 1, &lightPosition_cameraspace.x);
 
-	// Render Axes X Y Z
-	RenderMesh(meshList[GEO_AXES], false);
+	//Axes X Y Z and the rest of the hierarchy, recorded on the workers
+	sceneGraph.Update();
+	drawQueue.Begin(viewStack.Top(), projectionStack.Top());
+	RecordGraph();
+	RecordEntities(from, to, alpha);
+	drawQueue.Merge();
+	SubmitDraws();
+
+	//Character
+	RenderCharacter(from, to, alpha);
 
 	//Light 1
-	//modelStack.PushMatrix();
-	//modelStack.Translate(light[0].position.x, light[0].position.y, light[0].position.z);
-	//RenderMesh(meshList[GEO_LIGHTBALL], false);
-	//modelStack.PopMatrix();
+	if (lightEntity != EntityWorld::NO_ENTITY)
+	{
+		modelStack.PushMatrix();
+		modelStack.LoadMatrix(lightTransform.GetMatrix());
+		RenderShape(lightGizmo, false);
+		modelStack.PopMatrix();
+	}
 
-	//Skybox
-	//RenderSkybox();
+	//Last pick
+	if (hasPick)
+	{
+		modelStack.PushMatrix();
+		modelStack.Translate(pickPoint.x, pickPoint.y, pickPoint.z);
+		modelStack.Scale(0.5f, 0.5f, 0.5f);
+		RenderShape(lightGizmo, false);
+		modelStack.PopMatrix();
+	}
+
+	//Skybox - after opaque geometry, before text (text does not write depth)
+	RenderSkybox();
 
 	//Text in environment
 	/*modelStack.PushMatrix();
@@ -394,15 +886,33 @@ void Scene1::Render()
 void Scene1::Exit()
 {
 	//Clean up
+	streamer.Exit();
+	threadPool.Exit();
+	sceneGraph.Clear();
+	cullingBvh.Clear();
+	staticBatch.Clear();
+	collision.Clear();
+	entities.Clear();
+	character.Exit();
+	glDeleteBuffers(1, &m_paletteBuffer);
 
 	for (int i = 0; i < NUM_GEOMETRY; ++i)
 	{
-		if (meshList[i] != NULL)
+		if (meshList[i] != NULL && !primitives.Release(meshList[i]))
 		{
 			delete meshList[i];
 		}
 	}
+	for (unsigned i = 0; i < sceneMeshes.size(); ++i)
+	{
+		if (sceneMeshes[i] != NULL && !primitives.Release(sceneMeshes[i]))
+		{
+			delete sceneMeshes[i];
+		}
+	}
+	sceneMeshes.clear();
 	glDeleteVertexArrays(1, &m_vertexArrayID);
 	glDeleteProgram(m_programID);
+	glDeleteProgram(m_skyboxProgramID);
 
 }
\ No newline at end of file
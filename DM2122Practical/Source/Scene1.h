@@ -1,6 +1,8 @@
 #ifndef SCENE_1_H 
 #define SCENE_1_H
 
+#include <chrono>
+
 #include "Scene.h" 
 
 #include "Camera.h" 
@@ -10,7 +12,19 @@
 #include "MeshBuilder.h"
 
 #include "MatrixStack.h"
+#include "Bvh.h"
+#include "CollisionWorld.h"
+#include "RenderQueue.h"
+#include "StaticBatch.h"
 #include "Light.h"
+#include "AssetStreamer.h"
+#include "MeshCache.h"
+#include "ProceduralShape.h"
+#include "SceneGraph.h"
+#include "EntityWorld.h"
+#include "ThreadPool.h"
+#include "Character.h"
+#include "TripleBuffer.h"
 
 class Scene1 : public Scene
 {
@@ -24,52 +38,11 @@ class Scene1 : public Scene
 		GEO_LIGHTCRYSTAL,
 
 		//SkyBox
-		GEO_LEFT,
-		GEO_RIGHT,
-		GEO_TOP,
-		GEO_BOTTOM,
-		GEO_FRONT,
-		GEO_BACK,
+		GEO_SKYBOX,
 
 		//Text
 		GEO_TEXT,
 
-		//Character
-		GEO_HAT,
-		GEO_HATSTAR,
-		GEO_HATSIDE,
-
-		GEO_HEAD,
-		GEO_EYE1,
-		GEO_PUPIL1,
-		GEO_EYE2,
-		GEO_PUPIL2,
-
-		GEO_MOUTHSKIN,
-		GEO_MOUTH,
-
-		GEO_BODY,
-		GEO_BELLY,
-		GEO_BELLYSTAR,
-
-		GEO_LEFTSHOULDER,
-		GEO_LEFTARM,
-		GEO_LEFTARM2,
-		GEO_LEFTHAND,
-
-		GEO_RIGHTSHOULDER,
-		GEO_RIGHTARM,
-		GEO_RIGHTARM2,
-		GEO_RIGHTHAND,
-
-		GEO_LEFTLEG,
-		GEO_LEFTLEG2,
-		GEO_LEFTFOOT,
-
-		GEO_RIGHTLEG,
-		GEO_RIGHTLEG2,
-		GEO_RIGHTFOOT,
-
 		//Laser Gun
 		GEO_FRONTCONE,
 		GEO_BACKCONE,
@@ -181,6 +154,18 @@ class Scene1 : public Scene
 		U_TEXT_ENABLED,
 		U_TEXT_COLOR,
 
+		//Procedural shapes
+		U_SHAPE,
+		U_SHAPE_PARAMS,
+		U_SHAPE_COLOR,
+
+		//Skinned meshes
+		U_SKINNED,
+
+		//Skybox program
+		U_SKYBOX_VP,
+		U_SKYBOX_CUBEMAP,
+
 		U_TOTAL,
 	};
 
@@ -193,18 +178,8 @@ public:
 	virtual void Render();
 	virtual void Exit();
 
-	void Hat();
-	void Head();
-	void Body();
-
-	void RightArm();
 	void LaserGun();
 
-	void LeftArm();
-
-	void RightLeg();
-	void LeftLeg();
-
 	void chair();
 	void stairs();
 	void pillar();
@@ -229,23 +204,33 @@ public:
 
 
 private:
+	//What Render needs of one simulation step
+	struct SimState
+	{
+		Vector3 cameraPosition, cameraTarget, cameraUp;
+		Transform light; //Of lightEntity, if there is one
+		Pose characterPose;
+		std::vector<Transform> entityLocals; //Renderable entities, in ForEach order
+		std::vector<RenderComponent> entityRenders;
+	};
+
+	//The last two steps, so Render can interpolate between them
+	struct Snapshot
+	{
+		SimState previous, current;
+		std::chrono::steady_clock::time_point time; //When current was published
+		double step;
+	};
+
 	unsigned m_vertexArrayID;
 	Mesh* meshList[NUM_GEOMETRY];
 
 	unsigned m_programID;
+	unsigned m_skyboxProgramID;
 	unsigned m_parameters[U_TOTAL];
 
 	float rotateAngle;
 
-	float rotateLeftArm;
-	float rotateRightArm;
-
-	float rotateLeftLeg;
-	float rotateRightLeg;
-
-	float ArmAim;
-	float ArmAim2;
-
 	float LaserShootX;
 	float LaserShootY;
 
@@ -267,8 +252,6 @@ private:
 	float ButtonPress;
 	float missleShoot;
 
-	bool idle;
-	bool AnimateAim;
 	bool AnimateShoot;
 	bool leverflip;
 	bool chairFlip;
@@ -287,9 +270,57 @@ private:
 	Camera3 camera;
 
 	MS modelStack, viewStack, projectionStack;
+	MVPCache transforms; //matrices of the last draw, reused until a stack changes
+
+	MeshCache primitives;
+	AssetStreamer streamer;
+	ThreadPool threadPool;
 
 	Light light[4];
+	ProceduralShape lightGizmo; //Drawn at light[0], no vertex buffer
+
+	SceneGraph sceneGraph; //Static hierarchy
+	std::vector<Mesh*> sceneMeshes; //Loaded with the scene file
+	std::vector<Material> sceneMaterials;
+	Bvh cullingBvh; //World boxes of the scene graph meshes, by node position
+	std::vector<unsigned> visibleNodes;
+	StaticBatch staticBatch; //Nodes marked static, merged by material and cell
+	std::vector<unsigned> visibleBatches;
+	RenderQueue drawQueue; //Recorded on the workers, submitted here
+	CollisionWorld collision; //Scene nodes marked collide, for the camera and picking
+
+	bool picking; //Left button held last frame
+	bool hasPick;
+	Vector3 pickPoint;
+
+	SimState simState; //Simulation thread's, as of the last step
+	TripleBuffer<Snapshot> snapshots; //Simulation thread to GL thread
+
+	//GL thread's, interpolated from the snapshot for this frame
+	Vector3 viewPosition, viewTarget, viewUp;
+	Pose renderPose;
+	std::vector<Transform> renderLocals;
+	Mtx44 palette[Skeleton::MAX_JOINTS];
+
+	EntityWorld entities; //Animated objects and lights, updated in parallel
+	EntityWorld::EntityID lightEntity;
+
+	Character character; //One skinned draw, posed by the joint palette
+	unsigned m_paletteBuffer; //Uniform buffer of the palette
 	
+	bool LoadScene(const char *file_path);
+	void CaptureState(SimState &state);
+	void PublishSnapshot(double step);
+	void Pick();
+
 	void RenderMesh(Mesh *mesh, bool enableLight);
+	void RenderMesh(Mesh *mesh, const Material &material, bool enableLight);
+	void RecordGraph();
+	void RecordEntities(const SimState &from, const SimState &to, float alpha);
+	void SubmitDraws();
+	void RenderShape(const ProceduralShape &shape, bool enableLight);
+	void RenderCharacter(const SimState &from, const SimState &to, float alpha);
+	void SetDrawUniforms(const Material &material, bool enableLight);
+	void SetDrawUniforms(const Mtx44 &MVP, const Mtx44 &modelView, const Mtx44 *normalMatrix, const Material &material);
 };
 #endif
@@ -0,0 +1,439 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "SceneFile.h"
+#include "Quaternion.h"
+#include "Light.h"
+#include "MyMath.h"
+
+SceneFile::SceneFile()
+{
+	memset(&m_header, 0, sizeof(m_header));
+}
+
+/******************************************************************************/
+/*!
+\brief
+Map a compiled scene and check it, so the accessors never read out of bounds
+
+\param file_path - path of the .scene file, loose or in a mounted pack
+
+\return false, leaving the scene closed, if the file is missing or invalid
+*/
+/******************************************************************************/
+bool SceneFile::Open(const char *file_path)
+{
+	Close();
+	if (!FileSystem::Open(file_path, m_file))
+	{
+		std::cout << "Impossible to open " << file_path << ". Are you in the right directory ?\n";
+		return false;
+	}
+
+	if (m_file.Size() >= sizeof(m_header))
+	{
+		memcpy(&m_header, m_file.Data(), sizeof(m_header));
+	}
+	if (m_file.Size() < sizeof(m_header) || !Validate())
+	{
+		std::cout << "File header error.\n";
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void SceneFile::Close()
+{
+	m_file.Close();
+	memset(&m_header, 0, sizeof(m_header));
+}
+
+const SceneMeshRecord* SceneFile::Meshes() const
+{
+	return (const SceneMeshRecord*)(m_file.Data() + m_header.meshes.offset);
+}
+
+const SceneMaterialRecord* SceneFile::Materials() const
+{
+	return (const SceneMaterialRecord*)(m_file.Data() + m_header.materials.offset);
+}
+
+const SceneNodeRecord* SceneFile::Nodes() const
+{
+	return (const SceneNodeRecord*)(m_file.Data() + m_header.nodes.offset);
+}
+
+const SceneLightRecord* SceneFile::Lights() const
+{
+	return (const SceneLightRecord*)(m_file.Data() + m_header.lights.offset);
+}
+
+const char* SceneFile::String(unsigned offset) const
+{
+	return (const char*)m_file.Data() + m_header.strings.offset + offset;
+}
+
+static bool SectionFits(const SceneSection &section, size_t recordSize, size_t fileSize)
+{
+	return section.offset % 4 == 0 &&
+		section.offset <= fileSize &&
+		section.count <= (fileSize - section.offset) / recordSize;
+}
+
+bool SceneFile::Validate() const
+{
+	size_t size = m_file.Size();
+	if (memcmp(m_header.magic, "SCNE", 4) != 0 ||
+		m_header.version != SCENE_VERSION ||
+		!SectionFits(m_header.meshes, sizeof(SceneMeshRecord), size) ||
+		!SectionFits(m_header.materials, sizeof(SceneMaterialRecord), size) ||
+		!SectionFits(m_header.nodes, sizeof(SceneNodeRecord), size) ||
+		!SectionFits(m_header.lights, sizeof(SceneLightRecord), size) ||
+		!SectionFits(m_header.strings, 1, size))
+	{
+		return false;
+	}
+
+	//Every string ends inside the table once the table ends with a null
+	unsigned stringBytes = m_header.strings.count;
+	if (stringBytes == 0 || String(stringBytes - 1)[0] != '\0')
+	{
+		return false;
+	}
+
+	for (unsigned i = 0; i < MeshCount(); ++i)
+	{
+		const SceneMeshRecord &mesh = Meshes()[i];
+		if (mesh.name >= stringBytes || mesh.path >= stringBytes || mesh.source > SceneMeshRecord::SOURCE_COOKED)
+			return false;
+	}
+	for (unsigned i = 0; i < NodeCount(); ++i)
+	{
+		const SceneNodeRecord &node = Nodes()[i];
+		if (node.name >= stringBytes ||
+			(node.parent != SCENE_NONE && node.parent >= i) ||
+			(node.mesh != SCENE_NONE && node.mesh >= MeshCount()) ||
+			(node.material != SCENE_NONE && node.material >= MaterialCount()))
+			return false;
+	}
+	for (unsigned i = 0; i < LightCount(); ++i)
+	{
+		const SceneLightRecord &light = Lights()[i];
+		if (light.node >= NodeCount() || light.type > Light::LIGHT_SPOT)
+			return false;
+	}
+	return true;
+}
+
+//Text form, one record per line, # starts a comment:
+//	mesh <name> baked <axes|quad|cube|skybox|text> [r g b scale]
+//	mesh <name> obj|cooked <path>
+//	material <name> <ambient r g b> <diffuse r g b> <specular r g b> <shininess>
+//	node <name> <parent|-> <mesh|-> <material|-> [t x y z] [r degrees x y z]... [s x y z] [unlit] [hidden] [collide] [static]
+//	light <node> point|directional|spot <r g b> <power> <kC kL kQ> [spot dx dy dz cutoff inner exponent]
+//Rotations compose in the order written, like MS::Rotate; angles are degrees.
+//A node's parent must be declared before it.
+namespace
+{
+	struct SceneText
+	{
+		std::vector<SceneMeshRecord> meshes;
+		std::vector<SceneMaterialRecord> materials;
+		std::vector<SceneNodeRecord> nodes;
+		std::vector<SceneLightRecord> lights;
+		std::vector<char> strings;
+		std::map<std::string, unsigned> meshIndex, materialIndex, nodeIndex;
+
+		unsigned AddString(const std::string &text)
+		{
+			unsigned offset = strings.size();
+			strings.insert(strings.end(), text.begin(), text.end());
+			strings.push_back('\0');
+			return offset;
+		}
+	};
+}
+
+//Index of name in names, SCENE_NONE for "-", false if unknown
+static bool Lookup(const std::map<std::string, unsigned> &names, const std::string &name, unsigned &index)
+{
+	if (name == "-")
+	{
+		index = SCENE_NONE;
+		return true;
+	}
+	std::map<std::string, unsigned>::const_iterator it = names.find(name);
+	if (it == names.end())
+		return false;
+	index = it->second;
+	return true;
+}
+
+static bool ReadFloats(std::istream &line, float *values, unsigned count)
+{
+	for (unsigned i = 0; i < count; ++i)
+	{
+		if (!(line >> values[i]))
+			return false;
+	}
+	return true;
+}
+
+static bool ParseLine(const std::string &text, SceneText &scene)
+{
+	std::istringstream line(text);
+	std::string keyword, name;
+	if (!(line >> keyword) || keyword[0] == '#')
+		return true;
+	if (!(line >> name))
+		return false;
+
+	if (keyword == "mesh")
+	{
+		SceneMeshRecord mesh;
+		std::string source, path;
+		if (!(line >> source >> path))
+			return false;
+		if (source == "baked")
+			mesh.source = SceneMeshRecord::SOURCE_BAKED;
+		else if (source == "obj")
+			mesh.source = SceneMeshRecord::SOURCE_OBJ;
+		else if (source == "cooked")
+			mesh.source = SceneMeshRecord::SOURCE_COOKED;
+		else
+			return false;
+
+		mesh.color[0] = mesh.color[1] = mesh.color[2] = 1;
+		mesh.scale = 0;
+		if (!(line >> std::ws).eof())
+		{
+			if (mesh.source != SceneMeshRecord::SOURCE_BAKED || !ReadFloats(line, mesh.color, 3) || !(line >> mesh.scale))
+				return false;
+		}
+
+		mesh.name = scene.AddString(name);
+		mesh.path = scene.AddString(path);
+		scene.meshIndex[name] = scene.meshes.size();
+		scene.meshes.push_back(mesh);
+	}
+	else if (keyword == "material")
+	{
+		SceneMaterialRecord material;
+		if (!ReadFloats(line, material.ambient, 3) || !ReadFloats(line, material.diffuse, 3) ||
+			!ReadFloats(line, material.specular, 3) || !(line >> material.shininess))
+			return false;
+		scene.materialIndex[name] = scene.materials.size();
+		scene.materials.push_back(material);
+	}
+	else if (keyword == "node")
+	{
+		SceneNodeRecord node;
+		std::string parent, mesh, material;
+		if (!(line >> parent >> mesh >> material) ||
+			!Lookup(scene.nodeIndex, parent, node.parent) ||
+			!Lookup(scene.meshIndex, mesh, node.mesh) ||
+			!Lookup(scene.materialIndex, material, node.material))
+			return false;
+
+		node.flags = SceneNodeRecord::FLAG_VISIBLE | SceneNodeRecord::FLAG_LIGHTING;
+		Vector3 translation(0, 0, 0), scale(1, 1, 1);
+		Quaternion rotation;
+		std::string option;
+		while (line >> option)
+		{
+			if (option == "t")
+			{
+				if (!(line >> translation.x >> translation.y >> translation.z))
+					return false;
+			}
+			else if (option == "r")
+			{
+				float degrees, x, y, z;
+				if (!(line >> degrees >> x >> y >> z) || (x == 0 && y == 0 && z == 0))
+					return false;
+				Quaternion turn;
+				turn.SetToRotation(degrees, x, y, z);
+				rotation *= turn;
+			}
+			else if (option == "s")
+			{
+				if (!(line >> scale.x >> scale.y >> scale.z))
+					return false;
+			}
+			else if (option == "unlit")
+				node.flags &= ~SceneNodeRecord::FLAG_LIGHTING;
+			else if (option == "hidden")
+				node.flags &= ~SceneNodeRecord::FLAG_VISIBLE;
+			else if (option == "collide")
+				node.flags |= SceneNodeRecord::FLAG_COLLISION;
+			else if (option == "static")
+				node.flags |= SceneNodeRecord::FLAG_STATIC;
+			else
+				return false;
+		}
+
+		node.name = scene.AddString(name);
+		node.translation[0] = translation.x; node.translation[1] = translation.y; node.translation[2] = translation.z;
+		node.rotation[0] = rotation.w; node.rotation[1] = rotation.x; node.rotation[2] = rotation.y; node.rotation[3] = rotation.z;
+		node.scale[0] = scale.x; node.scale[1] = scale.y; node.scale[2] = scale.z;
+		scene.nodeIndex[name] = scene.nodes.size();
+		scene.nodes.push_back(node);
+	}
+	else if (keyword == "light")
+	{
+		SceneLightRecord light;
+		std::string type;
+		if (!Lookup(scene.nodeIndex, name, light.node) || light.node == SCENE_NONE || !(line >> type))
+			return false;
+		if (type == "point")
+			light.type = Light::LIGHT_POINT;
+		else if (type == "directional")
+			light.type = Light::LIGHT_DIRECTIONAL;
+		else if (type == "spot")
+			light.type = Light::LIGHT_SPOT;
+		else
+			return false;
+
+		if (!ReadFloats(line, light.color, 3) || !(line >> light.power >> light.kC >> light.kL >> light.kQ))
+			return false;
+
+		float cutoff = 45, inner = 30;
+		light.spotDirection[0] = 0; light.spotDirection[1] = 1; light.spotDirection[2] = 0;
+		light.exponent = 1;
+		std::string option;
+		if (line >> option)
+		{
+			if (option != "spot" || !ReadFloats(line, light.spotDirection, 3) || !(line >> cutoff >> inner >> light.exponent))
+				return false;
+		}
+		light.cosCutoff = cos(Math::DegreeToRadian(cutoff));
+		light.cosInner = cos(Math::DegreeToRadian(inner));
+		scene.lights.push_back(light);
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+//Append node and its subtree to order, depth first
+static void AddSubtree(unsigned node, const std::vector<std::vector<unsigned> > &children, std::vector<unsigned> &order)
+{
+	order.push_back(node);
+	for (unsigned i = 0; i < children[node].size(); ++i)
+	{
+		AddSubtree(children[node][i], children, order);
+	}
+}
+
+template<typename T>
+static void WriteSection(std::ofstream &fileStream, const std::vector<T> &records)
+{
+	if (!records.empty())
+		fileStream.write((const char*)&records[0], records.size() * sizeof(T));
+}
+
+/******************************************************************************/
+/*!
+\brief
+Parse a scene in the text form and write it in the binary form, with the
+nodes sorted depth first so the loader can add each one under its parent as
+it reads them
+
+\param text_path - scene source
+\param scene_path - .scene file to write
+
+\return false, after printing the line at fault, if the text has an error
+*/
+/******************************************************************************/
+bool CompileScene(const char *text_path, const char *scene_path)
+{
+	std::ifstream textStream(text_path);
+	if (!textStream.is_open())
+	{
+		std::cout << "Impossible to open " << text_path << ". Are you in the right directory ?\n";
+		return false;
+	}
+
+	SceneText scene;
+	std::string text;
+	for (unsigned lineNumber = 1; std::getline(textStream, text); ++lineNumber)
+	{
+		if (!ParseLine(text, scene))
+		{
+			std::cout << text_path << "(" << lineNumber << "): error in \"" << text << "\"\n";
+			return false;
+		}
+	}
+	if (scene.strings.empty())
+	{
+		scene.AddString("");
+	}
+
+	//Sort the nodes depth first and point parents and lights at the new order
+	std::vector<std::vector<unsigned> > children(scene.nodes.size());
+	std::vector<unsigned> order;
+	for (unsigned i = 0; i < scene.nodes.size(); ++i)
+	{
+		if (scene.nodes[i].parent != SCENE_NONE)
+			children[scene.nodes[i].parent].push_back(i);
+	}
+	for (unsigned i = 0; i < scene.nodes.size(); ++i)
+	{
+		if (scene.nodes[i].parent == SCENE_NONE)
+			AddSubtree(i, children, order);
+	}
+
+	std::vector<unsigned> newIndex(scene.nodes.size());
+	std::vector<SceneNodeRecord> nodes(scene.nodes.size());
+	for (unsigned i = 0; i < order.size(); ++i)
+	{
+		newIndex[order[i]] = i;
+	}
+	for (unsigned i = 0; i < order.size(); ++i)
+	{
+		nodes[i] = scene.nodes[order[i]];
+		if (nodes[i].parent != SCENE_NONE)
+			nodes[i].parent = newIndex[nodes[i].parent];
+	}
+	for (unsigned i = 0; i < scene.lights.size(); ++i)
+	{
+		scene.lights[i].node = newIndex[scene.lights[i].node];
+	}
+
+	SceneFileHeader header;
+	memcpy(header.magic, "SCNE", 4);
+	header.version = SCENE_VERSION;
+	header.meshes.offset = sizeof(header);
+	header.meshes.count = scene.meshes.size();
+	header.materials.offset = header.meshes.offset + header.meshes.count * sizeof(SceneMeshRecord);
+	header.materials.count = scene.materials.size();
+	header.nodes.offset = header.materials.offset + header.materials.count * sizeof(SceneMaterialRecord);
+	header.nodes.count = nodes.size();
+	header.lights.offset = header.nodes.offset + header.nodes.count * sizeof(SceneNodeRecord);
+	header.lights.count = scene.lights.size();
+	header.strings.offset = header.lights.offset + header.lights.count * sizeof(SceneLightRecord);
+	header.strings.count = scene.strings.size();
+
+	std::ofstream fileStream(scene_path, std::ios::binary);
+	if (!fileStream.is_open())
+	{
+		std::cout << "Impossible to write " << scene_path << "\n";
+		return false;
+	}
+	fileStream.write((const char*)&header, sizeof(header));
+	WriteSection(fileStream, scene.meshes);
+	WriteSection(fileStream, scene.materials);
+	WriteSection(fileStream, nodes);
+	WriteSection(fileStream, scene.lights);
+	WriteSection(fileStream, scene.strings);
+
+	return fileStream.good();
+}
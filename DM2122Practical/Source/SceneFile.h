@@ -0,0 +1,127 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include "FileSystem.h"
+
+//Compiled scenes are read in place from the mapped file: header, then the
+//record arrays and the string table at the offsets in the header. Records
+//refer to each other by index and to strings by offset, so nothing needs
+//fixing up after loading. Nodes are in depth first order, parents first.
+const unsigned SCENE_VERSION = 1;
+const unsigned SCENE_NONE = 0xFFFFFFFF;	// no parent, mesh or material
+
+struct SceneSection
+{
+	unsigned offset;			// from the start of the file, 4 byte aligned
+	unsigned count;				// records, or bytes for the string table
+};
+
+struct SceneFileHeader
+{
+	char magic[4];				// "SCNE"
+	unsigned version;
+	SceneSection meshes;
+	SceneSection materials;
+	SceneSection nodes;
+	SceneSection lights;
+	SceneSection strings;		// null terminated names and paths
+};
+
+struct SceneMeshRecord
+{
+	enum SOURCE
+	{
+		SOURCE_BAKED = 0,		// path is a BakedMeshes name: axes, quad, cube, skybox, text
+		SOURCE_OBJ,
+		SOURCE_COOKED,
+	};
+
+	unsigned name;				// string offset
+	unsigned path;				// string offset
+	unsigned source;
+	float color[3];				// baked only, with scale
+	float scale;				// baked only; 0 keeps the baked colors and size
+};
+
+struct SceneMaterialRecord
+{
+	float ambient[3];
+	float diffuse[3];
+	float specular[3];
+	float shininess;
+};
+
+struct SceneNodeRecord
+{
+	enum FLAG
+	{
+		FLAG_VISIBLE = 1,
+		FLAG_LIGHTING = 2,
+		FLAG_COLLISION = 4,			// a static collider for picking and the camera
+		FLAG_STATIC = 8,			// never moves; merged into a StaticBatch at load
+	};
+
+	unsigned name;				// string offset
+	unsigned parent;			// index of an earlier node, or SCENE_NONE
+	unsigned mesh;				// or SCENE_NONE
+	unsigned material;			// or SCENE_NONE for the mesh's own
+	unsigned flags;
+	float translation[3];
+	float rotation[4];			// unit quaternion w, x, y, z
+	float scale[3];
+};
+
+struct SceneLightRecord
+{
+	unsigned node;				// the light sits at this node
+	unsigned type;				// Light::LIGHT_TYPE
+	float color[3];
+	float power;
+	float kC, kL, kQ;
+	float spotDirection[3];
+	float cosCutoff;
+	float cosInner;
+	float exponent;
+};
+
+/******************************************************************************/
+/*!
+		Class SceneFile:
+\brief	A compiled scene opened through FileSystem. Open checks the header
+		and every index once; after that the records are used straight from
+		the mapping, valid until Close.
+*/
+/******************************************************************************/
+class SceneFile
+{
+public:
+	SceneFile();
+
+	bool Open(const char *file_path);
+	void Close();
+
+	unsigned MeshCount() const { return m_header.meshes.count; }
+	unsigned MaterialCount() const { return m_header.materials.count; }
+	unsigned NodeCount() const { return m_header.nodes.count; }
+	unsigned LightCount() const { return m_header.lights.count; }
+
+	const SceneMeshRecord* Meshes() const;
+	const SceneMaterialRecord* Materials() const;
+	const SceneNodeRecord* Nodes() const;
+	const SceneLightRecord* Lights() const;
+	const char* String(unsigned offset) const;
+
+private:
+	SceneFile(const SceneFile&);
+	SceneFile& operator=(const SceneFile&);
+
+	bool Validate() const;
+
+	FileData m_file;
+	SceneFileHeader m_header;
+};
+
+//Compile the text form of a scene into the binary form; see Scene//Scene1.txt
+bool CompileScene(const char *text_path, const char *scene_path);
+
+#endif
@@ -0,0 +1,196 @@
+#include <cassert>
+#include "SceneGraph.h"
+
+const SceneGraph::NodeID SceneGraph::NO_NODE;
+
+SceneGraph::SceneGraph()
+{
+}
+
+SceneGraph::~SceneGraph()
+{
+}
+
+/******************************************************************************/
+/*!
+\brief
+Add a node after the last descendant of its parent, keeping the depth first
+order, and mark it dirty
+
+\param parent - parent node, or NO_NODE for a root
+\param local - transform relative to the parent
+\param mesh - mesh to draw at this node, or NULL; not owned
+
+\return ID of the new node
+*/
+/******************************************************************************/
+SceneGraph::NodeID SceneGraph::AddNode(NodeID parent, const Transform &local, Mesh *mesh)
+{
+	unsigned parentPosition = parent == NO_NODE ? NO_NODE : m_position[parent];
+	unsigned position = parent == NO_NODE ? Size() : m_subtreeEnd[parentPosition];
+	Insert(position);
+
+	//Every ancestor's subtree grows by the new node
+	for (unsigned ancestor = parentPosition; ancestor != NO_NODE; ancestor = m_parent[ancestor])
+	{
+		++m_subtreeEnd[ancestor];
+	}
+
+	NodeID node = m_position.size();
+	m_position.push_back(position);
+	m_node[position] = node;
+	m_parent[position] = parentPosition;
+	m_subtreeEnd[position] = position + 1;
+	m_flags[position] = FLAG_DIRTY | FLAG_LOCAL_DIRTY | FLAG_VISIBLE | FLAG_LIGHTING;
+	m_local[position] = local;
+	m_mesh[position] = mesh;
+	m_material[position] = NULL;
+	return node;
+}
+
+void SceneGraph::Insert(unsigned position)
+{
+	m_world.insert(m_world.begin() + position, Mtx44());
+	m_localMatrix.insert(m_localMatrix.begin() + position, Mtx44());
+	m_parent.insert(m_parent.begin() + position, NO_NODE);
+	m_subtreeEnd.insert(m_subtreeEnd.begin() + position, position + 1);
+	m_flags.insert(m_flags.begin() + position, 0);
+	m_local.insert(m_local.begin() + position, Transform());
+	m_mesh.insert(m_mesh.begin() + position, (Mesh*)NULL);
+	m_material.insert(m_material.begin() + position, (const Material*)NULL);
+	m_node.insert(m_node.begin() + position, NO_NODE);
+
+	//Nodes after the new one move along by one, as do references to them
+	for (unsigned i = position + 1; i < Size(); ++i)
+	{
+		++m_position[m_node[i]];
+		++m_subtreeEnd[i];
+		if (m_parent[i] != NO_NODE && m_parent[i] >= position)
+		{
+			++m_parent[i];
+		}
+	}
+}
+
+void SceneGraph::Clear()
+{
+	m_world.clear();
+	m_localMatrix.clear();
+	m_parent.clear();
+	m_subtreeEnd.clear();
+	m_flags.clear();
+	m_local.clear();
+	m_mesh.clear();
+	m_material.clear();
+	m_node.clear();
+	m_position.clear();
+}
+
+const Transform& SceneGraph::GetLocal(NodeID node) const
+{
+	assert(node < m_position.size());
+	return m_local[m_position[node]];
+}
+
+void SceneGraph::SetLocal(NodeID node, const Transform &local)
+{
+	assert(node < m_position.size());
+	unsigned position = m_position[node];
+	m_local[position] = local;
+	m_flags[position] |= FLAG_DIRTY | FLAG_LOCAL_DIRTY;
+}
+
+const Mtx44& SceneGraph::GetWorld(NodeID node) const
+{
+	assert(node < m_position.size());
+	return m_world[m_position[node]];
+}
+
+void SceneGraph::SetMaterial(NodeID node, const Material *material)
+{
+	assert(node < m_position.size());
+	m_material[m_position[node]] = material;
+}
+
+void SceneGraph::SetVisible(NodeID node, bool visible)
+{
+	assert(node < m_position.size());
+	unsigned char &flags = m_flags[m_position[node]];
+	flags = visible ? flags | FLAG_VISIBLE : flags & ~FLAG_VISIBLE;
+}
+
+void SceneGraph::SetLighting(NodeID node, bool enableLight)
+{
+	assert(node < m_position.size());
+	unsigned char &flags = m_flags[m_position[node]];
+	flags = enableLight ? flags | FLAG_LIGHTING : flags & ~FLAG_LIGHTING;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Recompute world matrices. A dirty node's whole subtree is recomputed in one
+pass over its contiguous range, parents before children; clean subtrees are
+skipped without being touched.
+*/
+/******************************************************************************/
+void SceneGraph::Update()
+{
+	unsigned i = 0;
+	while (i < Size())
+	{
+		if (!(m_flags[i] & FLAG_DIRTY))
+		{
+			++i;
+			continue;
+		}
+
+		unsigned end = m_subtreeEnd[i];
+		for (unsigned j = i; j < end; ++j)
+		{
+			if (m_flags[j] & FLAG_LOCAL_DIRTY)
+			{
+				m_localMatrix[j] = m_local[j].GetMatrix();
+			}
+			unsigned parent = m_parent[j];
+			m_world[j] = parent == NO_NODE ? m_localMatrix[j] : m_world[parent] * m_localMatrix[j];
+			m_flags[j] &= ~(FLAG_DIRTY | FLAG_LOCAL_DIRTY);
+		}
+		i = end;
+	}
+}
+
+unsigned SceneGraph::Size() const
+{
+	return m_node.size();
+}
+
+SceneGraph::NodeID SceneGraph::GetNode(unsigned position) const
+{
+	return m_node[position];
+}
+
+Mesh* SceneGraph::GetMesh(unsigned position) const
+{
+	return m_mesh[position];
+}
+
+const Material& SceneGraph::GetMaterial(unsigned position) const
+{
+	return m_material[position] ? *m_material[position] : m_mesh[position]->material;
+}
+
+const Mtx44& SceneGraph::GetWorldAt(unsigned position) const
+{
+	return m_world[position];
+}
+
+bool SceneGraph::IsVisible(unsigned position) const
+{
+	return (m_flags[position] & FLAG_VISIBLE) != 0;
+}
+
+bool SceneGraph::IsLit(unsigned position) const
+{
+	return (m_flags[position] & FLAG_LIGHTING) != 0;
+}
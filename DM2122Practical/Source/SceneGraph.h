@@ -0,0 +1,87 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <vector>
+#include "Transform.h"
+#include "Mesh.h"
+
+/******************************************************************************/
+/*!
+		Class SceneGraph:
+\brief	Transform hierarchy stored flat in depth first order: every node
+		comes after its parent and its subtree is the contiguous range that
+		follows it. Each node has a local Transform, a cached world matrix
+		and optionally a mesh and material to draw.
+
+		Setting a local transform only marks the node dirty; Update then
+		recomputes the dirty subtrees and nothing else, so static nodes cost
+		nothing per frame. Node data is kept in parallel arrays so the update
+		walks only the matrices, parents and flags.
+
+		NodeIDs stay valid as nodes are added; positions in the flat order
+		do not.
+*/
+/******************************************************************************/
+class SceneGraph
+{
+public:
+	typedef unsigned NodeID;
+	static const NodeID NO_NODE = 0xFFFFFFFF;
+
+	SceneGraph();
+	~SceneGraph();
+
+	//Add a node as the last child of parent, or as a root if parent is NO_NODE
+	NodeID AddNode(NodeID parent, const Transform &local, Mesh *mesh = NULL);
+	void Clear();
+
+	const Transform& GetLocal(NodeID node) const;
+	void SetLocal(NodeID node, const Transform &local);
+	//World matrix as of the last Update
+	const Mtx44& GetWorld(NodeID node) const;
+
+	//Draw with this material instead of the mesh's own; NULL to reset
+	void SetMaterial(NodeID node, const Material *material);
+	void SetVisible(NodeID node, bool visible);
+	void SetLighting(NodeID node, bool enableLight);
+
+	//Recompute the world matrix of every node with a dirty ancestor or self
+	void Update();
+
+	//Nodes in depth first order, for drawing
+	unsigned Size() const;
+	NodeID GetNode(unsigned position) const;
+	Mesh* GetMesh(unsigned position) const;
+	const Material& GetMaterial(unsigned position) const; //mesh must not be NULL
+	const Mtx44& GetWorldAt(unsigned position) const;
+	bool IsVisible(unsigned position) const;
+	bool IsLit(unsigned position) const;
+
+private:
+	enum FLAG
+	{
+		FLAG_DIRTY = 1, //world matrix of this subtree is stale
+		FLAG_LOCAL_DIRTY = 2, //local matrix is stale
+		FLAG_VISIBLE = 4,
+		FLAG_LIGHTING = 8,
+	};
+
+	//Make room at position, shifting every later node along
+	void Insert(unsigned position);
+
+	//Per node, in depth first order
+	std::vector<Mtx44> m_world;
+	std::vector<Mtx44> m_localMatrix;
+	std::vector<unsigned> m_parent; //position of the parent, or NO_NODE
+	std::vector<unsigned> m_subtreeEnd; //one past the last descendant
+	std::vector<unsigned char> m_flags;
+	std::vector<Transform> m_local;
+	std::vector<Mesh*> m_mesh;
+	std::vector<const Material*> m_material;
+	std::vector<NodeID> m_node;
+
+	//Per NodeID
+	std::vector<unsigned> m_position;
+};
+
+#endif
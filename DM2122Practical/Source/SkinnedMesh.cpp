@@ -0,0 +1,107 @@
+#include <cstddef>
+#include "SkinnedMesh.h"
+#include "GL\glew.h"
+
+bool SkinnedMeshData::AddPart(const MeshData &part, const Mtx44 &bind, unsigned joint)
+{
+	std::vector<unsigned> triangles;
+	if (!MeshBuilder::TriangleIndices(part, triangles))
+		return false;
+
+	const float *m = bind.a;
+	Mtx44 normalMatrix = bind.GetNormalMatrix(false);
+	unsigned baseVertex = vertices.size();
+	vertices.resize(baseVertex + part.vertices.size());
+	for (unsigned i = 0; i < part.vertices.size(); ++i)
+	{
+		SkinnedVertex &v = vertices[baseVertex + i];
+		v.vertex = part.vertices[i];
+
+		const Position p = v.vertex.pos;
+		v.vertex.pos.Set(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+			m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+			m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+		v.vertex.normal = (normalMatrix * v.vertex.normal).NormalizedOrZero();
+
+		v.joints[0] = (unsigned char)joint;
+		v.joints[1] = v.joints[2] = v.joints[3] = 0;
+		v.weights[0] = 1;
+		v.weights[1] = v.weights[2] = v.weights[3] = 0;
+	}
+
+	for (unsigned i = 0; i < triangles.size(); ++i)
+	{
+		indices.push_back(baseVertex + triangles[i]);
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Default constructor - generate VBO/IBO here
+
+\param meshName - name of mesh
+*/
+/******************************************************************************/
+SkinnedMesh::SkinnedMesh(const std::string &meshName)
+	: name(meshName)
+	, indexSize(0)
+{
+	glGenBuffers(1, &vertexBuffer);
+	glGenBuffers(1, &indexBuffer);
+}
+
+SkinnedMesh::~SkinnedMesh()
+{
+	glDeleteBuffers(1, &vertexBuffer);
+	glDeleteBuffers(1, &indexBuffer);
+}
+
+void SkinnedMesh::Upload(const SkinnedMeshData &data)
+{
+	indexSize = 0;
+	if (data.vertices.empty() || data.indices.empty())
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(SkinnedVertex), &data.vertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), &data.indices[0], GL_STATIC_DRAW);
+	indexSize = data.indices.size();
+}
+
+/******************************************************************************/
+/*!
+\brief
+OpenGL render code; the palette uniform block must be filled and skinning
+enabled in the shader first
+*/
+/******************************************************************************/
+void SkinnedMesh::Render()
+{
+	glEnableVertexAttribArray(0); // 1st attribute buffer : vertices
+	glEnableVertexAttribArray(1); // 2nd attribute buffer : colors
+	glEnableVertexAttribArray(2); // 3rd attribute buffer : normal
+	glEnableVertexAttribArray(4); // joint indices
+	glEnableVertexAttribArray(5); // joint weights
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)sizeof(Position));
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)(sizeof(Position) + sizeof(Color)));
+	//Integer attribute, read as a uvec4 without conversion
+	glVertexAttribIPointer(4, 4, GL_UNSIGNED_BYTE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, joints));
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, weights));
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glDrawElements(GL_TRIANGLES, indexSize, GL_UNSIGNED_INT, 0);
+
+	glDisableVertexAttribArray(5);
+	glDisableVertexAttribArray(4);
+	glDisableVertexAttribArray(2);
+	glDisableVertexAttribArray(1);
+	glDisableVertexAttribArray(0);
+}
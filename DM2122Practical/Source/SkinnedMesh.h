@@ -0,0 +1,50 @@
+#ifndef SKINNED_MESH_H
+#define SKINNED_MESH_H
+
+#include <vector>
+#include "MeshBuilder.h"
+
+/******************************************************************************/
+/*!
+		Struct SkinnedMeshData:
+\brief	CPU copy of a skinned mesh, a triangle list in the skeleton's bind
+		pose. Rigid parts, such as the pieces of a character, are merged in
+		one at a time, each bound wholly to one joint.
+*/
+/******************************************************************************/
+struct SkinnedMeshData
+{
+	std::vector<SkinnedVertex> vertices;
+	std::vector<unsigned> indices;
+
+	//Append part placed by bind (part to model space in the bind pose),
+	//moved only by joint; false, adding nothing, if it has no triangles
+	bool AddPart(const MeshData &part, const Mtx44 &bind, unsigned joint);
+};
+
+/******************************************************************************/
+/*!
+		Class SkinnedMesh:
+\brief	VBO/IBO of a SkinnedMeshData, drawn as one triangle list. The vertex
+		shader moves each vertex by its joints' matrices in the palette
+		uniform block, so the whole mesh is a single draw call however many
+		parts it was made of. GL thread only.
+*/
+/******************************************************************************/
+class SkinnedMesh
+{
+public:
+	SkinnedMesh(const std::string &meshName);
+	~SkinnedMesh();
+
+	void Upload(const SkinnedMeshData &data);
+	void Render();
+
+	const std::string name;
+	unsigned vertexBuffer;
+	unsigned indexBuffer;
+	unsigned indexSize;
+	Material material;
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include "StaticBatch.h"
+
+const float StaticBatch::DEFAULT_CELL_SIZE = 100.0f;
+
+bool StaticBatch::Key::operator<(const Key &rhs) const
+{
+	if (x != rhs.x)
+		return x < rhs.x;
+	if (y != rhs.y)
+		return y < rhs.y;
+	if (z != rhs.z)
+		return z < rhs.z;
+	if (material != rhs.material)
+		return std::less<const Material*>()(material, rhs.material);
+	return enableLight < rhs.enableLight;
+}
+
+StaticBatch::StaticBatch() : m_cellSize(DEFAULT_CELL_SIZE), m_built(false)
+{
+}
+
+StaticBatch::~StaticBatch()
+{
+	Clear();
+}
+
+void StaticBatch::SetCellSize(float cellSize)
+{
+	assert(cellSize > 0 && m_batches.empty());
+	m_cellSize = cellSize;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Bake an instance into world space and append it to its batch. Strips and
+fans are unrolled, so every batch is a triangle list whatever it merges.
+
+\param data - CPU copy of the mesh
+\param world - the instance's world matrix
+\param material - kept by pointer; instances share a batch by address
+\param enableLight - lit and unlit instances are batched apart
+
+\return false, adding nothing, if the instance cannot be batched or the
+batches have been built; the caller then draws it unbatched
+*/
+/******************************************************************************/
+bool StaticBatch::Add(const MeshData &data, const Mtx44 &world, const Material &material, bool enableLight)
+{
+	//Built batches have released their CPU data and would never be re-uploaded
+	if (m_built)
+		return false;
+
+	std::vector<unsigned> triangles;
+	Mtx44 inverse;
+	if (!MeshBuilder::TriangleIndices(data, triangles) || !world.TryGetInverse(inverse))
+		return false;
+	Mtx44 normalMatrix = inverse.GetTranspose();
+
+	//Baked first, so the cell comes from the instance's world box
+	const float *m = world.a;
+	std::vector<Vertex> vertices(data.vertices);
+	AABB bounds;
+	for (unsigned i = 0; i < vertices.size(); ++i)
+	{
+		Vertex &v = vertices[i];
+		const Position p = v.pos;
+		v.pos.Set(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+			m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+			m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+		v.normal = (normalMatrix * v.normal).NormalizedOrZero();
+		bounds.Expand(Vector3(v.pos.x, v.pos.y, v.pos.z));
+	}
+
+	Vector3 center = bounds.Center();
+	Key key;
+	key.x = (int)floor(center.x / m_cellSize);
+	key.y = (int)floor(center.y / m_cellSize);
+	key.z = (int)floor(center.z / m_cellSize);
+	key.material = &material;
+	key.enableLight = enableLight;
+
+	std::map<Key, unsigned>::iterator found = m_index.find(key);
+	if (found == m_index.end())
+	{
+		found = m_index.insert(std::make_pair(key, (unsigned)m_batches.size())).first;
+		m_batches.push_back(Batch());
+		Batch &batch = m_batches.back();
+		batch.mesh = NULL;
+		batch.material = &material;
+		batch.enableLight = enableLight;
+	}
+
+	MeshData &merged = m_batches[found->second].data;
+	unsigned baseVertex = merged.vertices.size();
+	merged.vertices.insert(merged.vertices.end(), vertices.begin(), vertices.end());
+	for (unsigned i = 0; i < triangles.size(); ++i)
+	{
+		merged.indices.push_back(baseVertex + triangles[i]);
+	}
+	return true;
+}
+
+void StaticBatch::Build()
+{
+	assert(!m_built);
+	for (unsigned i = 0; i < m_batches.size(); ++i)
+	{
+		Batch &batch = m_batches[i];
+		batch.mesh = MeshBuilder::Create("static batch", batch.data);
+		batch.mesh->material = *batch.material;
+		m_bvh.Insert(batch.mesh->bounds, i);
+		MeshData().vertices.swap(batch.data.vertices);
+		MeshData().indices.swap(batch.data.indices);
+	}
+	m_bvh.Build();
+	m_built = true;
+}
+
+void StaticBatch::Clear()
+{
+	for (unsigned i = 0; i < m_batches.size(); ++i)
+	{
+		delete m_batches[i].mesh;
+	}
+	m_batches.clear();
+	m_index.clear();
+	m_bvh.Clear();
+	m_built = false;
+}
+
+void StaticBatch::Query(const Frustum &frustum, std::vector<unsigned> &out) const
+{
+	m_bvh.Query(frustum, out);
+}
+
+unsigned StaticBatch::Size() const
+{
+	return m_batches.size();
+}
+
+Mesh* StaticBatch::GetMesh(unsigned batch) const
+{
+	return m_batches[batch].mesh;
+}
+
+const Material& StaticBatch::GetMaterial(unsigned batch) const
+{
+	return *m_batches[batch].material;
+}
+
+bool StaticBatch::IsLit(unsigned batch) const
+{
+	return m_batches[batch].enableLight;
+}
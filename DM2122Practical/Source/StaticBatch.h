@@ -0,0 +1,74 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <map>
+#include <vector>
+#include "Bvh.h"
+#include "MeshBuilder.h"
+
+/******************************************************************************/
+/*!
+		Class StaticBatch:
+\brief	Props that never move, merged at load time. Each instance is baked
+		into world space and appended to the batch of its material and
+		lighting in the grid cell its box centre falls in, so every batch is
+		one mesh drawn with one call at the identity transform. The cells
+		keep batches small enough to cull; their boxes go in a Bvh.
+
+		Batch meshes are untextured, as a Mesh owns its texture; leave
+		textured meshes out. The materials are referenced, not copied.
+*/
+/******************************************************************************/
+class StaticBatch
+{
+public:
+	static const float DEFAULT_CELL_SIZE;
+
+	StaticBatch();
+	~StaticBatch();
+
+	//Width of the cubic cells; set before adding
+	void SetCellSize(float cellSize);
+
+	//Queue an instance; false, adding nothing, for lines, no triangles, a
+	//singular world matrix or once built
+	bool Add(const MeshData &data, const Mtx44 &world, const Material &material, bool enableLight);
+	//Upload a mesh per batch and build the tree over them; GL thread only.
+	//The batches are then sealed until Clear.
+	void Build();
+	void Clear();
+
+	//Batches whose boxes are in the frustum
+	void Query(const Frustum &frustum, std::vector<unsigned> &out) const;
+
+	unsigned Size() const;
+	Mesh* GetMesh(unsigned batch) const;
+	const Material& GetMaterial(unsigned batch) const;
+	bool IsLit(unsigned batch) const;
+
+private:
+	struct Key
+	{
+		int x, y, z;
+		const Material *material;
+		bool enableLight;
+
+		bool operator<(const Key &rhs) const;
+	};
+
+	struct Batch
+	{
+		MeshData data; //Released once uploaded
+		Mesh *mesh;
+		const Material *material;
+		bool enableLight;
+	};
+
+	float m_cellSize;
+	bool m_built;
+	std::map<Key, unsigned> m_index;
+	std::vector<Batch> m_batches;
+	Bvh m_bvh;
+};
+
+#endif
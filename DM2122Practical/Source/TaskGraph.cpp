@@ -0,0 +1,179 @@
+#include "TaskGraph.h"
+#include <iostream>
+
+TaskGraph::TaskGraph()
+	: m_pool(NULL)
+	, m_finished(0)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+	//Tasks hold references into the caller, never leave them running
+	Wait();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Add a task to the graph; must not be called while the graph is running
+
+\param task - work to do
+\param thread - MAIN_THREAD for tasks that make GL calls
+
+\return ID of the task, used with Depend
+*/
+/******************************************************************************/
+TaskGraph::TaskID TaskGraph::Add(const std::function<void()> &task, THREAD thread)
+{
+	Task newTask;
+	newTask.function = task;
+	newTask.thread = thread;
+	newTask.numDependencies = 0;
+	m_tasks.push_back(newTask);
+
+	return m_tasks.size() - 1;
+}
+
+void TaskGraph::Depend(TaskID task, TaskID dependency)
+{
+	m_tasks[dependency].dependents.push_back(task);
+	++m_tasks[task].numDependencies;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Queue every task without dependencies. Worker tasks start at once; main
+thread tasks wait for Wait.
+
+\param pool - pool that runs the ANY_THREAD tasks
+
+\return false if the dependencies form a cycle, in which case nothing runs
+*/
+/******************************************************************************/
+bool TaskGraph::Start(ThreadPool &pool)
+{
+	//Kahn's algorithm on a copy of the counts; every task is reached unless there is a cycle
+	std::vector<unsigned> counts(m_tasks.size());
+	std::vector<TaskID> ready;
+	for (TaskID id = 0; id < m_tasks.size(); ++id)
+	{
+		counts[id] = m_tasks[id].numDependencies;
+		if (counts[id] == 0)
+		{
+			ready.push_back(id);
+		}
+	}
+	for (unsigned i = 0; i < ready.size(); ++i)
+	{
+		const std::vector<TaskID> &dependents = m_tasks[ready[i]].dependents;
+		for (unsigned j = 0; j < dependents.size(); ++j)
+		{
+			if (--counts[dependents[j]] == 0)
+			{
+				ready.push_back(dependents[j]);
+			}
+		}
+	}
+	if (ready.size() != m_tasks.size())
+	{
+		std::cout << "Task graph has a dependency cycle, nothing was run" << std::endl;
+		return false;
+	}
+
+	m_pool = &pool;
+	m_finished = 0;
+	m_remaining.reset(new std::atomic<unsigned>[m_tasks.size()]);
+	for (TaskID id = 0; id < m_tasks.size(); ++id)
+	{
+		m_remaining[id] = m_tasks[id].numDependencies;
+	}
+	for (TaskID id = 0; id < m_tasks.size(); ++id)
+	{
+		if (m_tasks[id].numDependencies == 0)
+		{
+			Schedule(id);
+		}
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Run main thread tasks as they become ready, and help the pool when there are
+none, until every task in the graph has finished
+*/
+/******************************************************************************/
+void TaskGraph::Wait()
+{
+	if (!m_pool)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_finished < m_tasks.size())
+	{
+		if (!m_mainQueue.empty())
+		{
+			TaskID id = m_mainQueue.front();
+			m_mainQueue.pop_front();
+			lock.unlock();
+			Execute(id);
+			lock.lock();
+			continue;
+		}
+
+		lock.unlock();
+		bool ranJob = m_pool->RunOne();
+		lock.lock();
+		if (!ranJob && m_mainQueue.empty() && m_finished < m_tasks.size())
+		{
+			m_condition.wait(lock);
+		}
+	}
+	m_pool = NULL;
+}
+
+void TaskGraph::Run(ThreadPool &pool)
+{
+	if (Start(pool))
+	{
+		Wait();
+	}
+}
+
+void TaskGraph::Schedule(TaskID id)
+{
+	if (m_tasks[id].thread == MAIN_THREAD)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_mainQueue.push_back(id);
+		m_condition.notify_all();
+	}
+	else
+	{
+		m_pool->Submit([this, id]() { Execute(id); });
+	}
+}
+
+void TaskGraph::Execute(TaskID id)
+{
+	m_tasks[id].function();
+
+	const std::vector<TaskID> &dependents = m_tasks[id].dependents;
+	for (unsigned i = 0; i < dependents.size(); ++i)
+	{
+		if (--m_remaining[dependents[i]] == 0)
+		{
+			Schedule(dependents[i]);
+		}
+	}
+
+	//Notify while locked so Wait cannot return and destroy the graph first
+	std::lock_guard<std::mutex> lock(m_mutex);
+	++m_finished;
+	m_condition.notify_all();
+}
@@ -0,0 +1,65 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "ThreadPool.h"
+
+/******************************************************************************/
+/*!
+		Class TaskGraph:
+\brief	Runs a set of tasks in dependency order. ANY_THREAD tasks go to a
+		thread pool; MAIN_THREAD tasks (GL calls) run on the thread that calls
+		Wait. A task starts as soon as everything it depends on has finished.
+*/
+/******************************************************************************/
+class TaskGraph
+{
+public:
+	typedef unsigned TaskID;
+
+	enum THREAD
+	{
+		ANY_THREAD,
+		MAIN_THREAD,
+	};
+
+	TaskGraph();
+	~TaskGraph();
+
+	TaskID Add(const std::function<void()> &task, THREAD thread = ANY_THREAD);
+	void Depend(TaskID task, TaskID dependency); // task will not start before dependency finishes
+
+	bool Start(ThreadPool &pool);		// Queue the ready tasks; false if the graph has a cycle
+	void Wait();						// Run main thread tasks until the whole graph has finished
+	void Run(ThreadPool &pool);			// Start and Wait
+
+private:
+	struct Task
+	{
+		std::function<void()> function;
+		THREAD thread;
+		std::vector<TaskID> dependents;
+		unsigned numDependencies;
+	};
+
+	void Schedule(TaskID id);
+	void Execute(TaskID id);
+
+	std::vector<Task> m_tasks;
+
+	ThreadPool *m_pool;
+	std::unique_ptr<std::atomic<unsigned>[]> m_remaining; // unfinished dependencies per task
+	std::deque<TaskID> m_mainQueue;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	unsigned m_finished;
+};
+
+#endif
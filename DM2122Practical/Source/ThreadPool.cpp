@@ -0,0 +1,182 @@
+#include "ThreadPool.h"
+#include <atomic>
+
+ThreadPool::ThreadPool()
+	: m_pending(0)
+	, m_quit(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	Exit();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Start the worker threads
+
+\param numWorkers - number of threads, 0 to use one per spare hardware thread
+*/
+/******************************************************************************/
+void ThreadPool::Init(unsigned numWorkers)
+{
+	if (numWorkers == 0)
+	{
+		unsigned hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_quit = false;
+	for (unsigned i = 0; i < numWorkers; ++i)
+	{
+		m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+void ThreadPool::Exit()
+{
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_jobCondition.notify_all();
+	for (unsigned i = 0; i < m_workers.size(); ++i)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+}
+
+void ThreadPool::Submit(const std::function<void()> &job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+		++m_pending;
+	}
+	m_jobCondition.notify_one();
+	//Wake threads in Wait so they can help when there are no workers
+	m_idleCondition.notify_all();
+}
+
+/******************************************************************************/
+/*!
+\brief
+Run the oldest queued job on the calling thread
+
+\return false if the queue was empty
+*/
+/******************************************************************************/
+bool ThreadPool::RunOne()
+{
+	std::function<void()> job;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_jobs.empty())
+		{
+			return false;
+		}
+		job = m_jobs.front();
+		m_jobs.pop_front();
+	}
+
+	job();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_pending == 0)
+		{
+			m_idleCondition.notify_all();
+		}
+	}
+	return true;
+}
+
+void ThreadPool::Wait()
+{
+	for (;;)
+	{
+		if (RunOne())
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_pending == 0)
+		{
+			return;
+		}
+		m_idleCondition.wait(lock, [this]() { return m_pending == 0 || !m_jobs.empty(); });
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+Run body over [0, count) in ranges of at most grainSize. The calling thread
+runs the first range itself and helps with the rest, returning once every
+range has finished.
+
+\param count - number of items
+\param grainSize - largest range handed to one job
+\param body - called with [begin, end) of each range
+*/
+/******************************************************************************/
+void ThreadPool::ParallelFor(unsigned count, unsigned grainSize, const std::function<void(unsigned begin, unsigned end)> &body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (grainSize == 0)
+	{
+		grainSize = 1;
+	}
+
+	unsigned numRanges = (count + grainSize - 1) / grainSize;
+	std::atomic<unsigned> remaining(numRanges - 1);
+	for (unsigned range = 1; range < numRanges; ++range)
+	{
+		unsigned begin = range * grainSize;
+		unsigned end = begin + grainSize < count ? begin + grainSize : count;
+		Submit([&body, &remaining, begin, end]() {
+			body(begin, end);
+			--remaining;
+		});
+	}
+
+	body(0, grainSize < count ? grainSize : count);
+
+	while (remaining > 0)
+	{
+		if (!RunOne())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+unsigned ThreadPool::GetWorkerCount() const
+{
+	return m_workers.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobCondition.wait(lock, [this]() { return m_quit || !m_jobs.empty(); });
+			if (m_jobs.empty())
+			{
+				return;
+			}
+		}
+		RunOne();
+	}
+}
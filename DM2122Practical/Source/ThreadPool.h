@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/******************************************************************************/
+/*!
+		Class ThreadPool:
+\brief	A fixed set of worker threads running jobs from one shared queue.
+		Threads that wait on the pool help run queued jobs, so a pool with
+		no workers still completes everything on the waiting thread.
+*/
+/******************************************************************************/
+class ThreadPool
+{
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	void Init(unsigned numWorkers = 0); // 0 uses one worker per spare hardware thread
+	void Exit();						// Runs every queued job, then joins the workers
+
+	void Submit(const std::function<void()> &job);
+	bool RunOne();						// Run one queued job on this thread, false if none were queued
+	void Wait();						// Help until every submitted job has finished
+
+	//Split [0, count) into ranges of at most grainSize and run them across the pool
+	void ParallelFor(unsigned count, unsigned grainSize, const std::function<void(unsigned begin, unsigned end)> &body);
+
+	unsigned GetWorkerCount() const;
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()> > m_jobs;
+	std::mutex m_mutex;
+	std::condition_variable m_jobCondition;
+	std::condition_variable m_idleCondition;
+	unsigned m_pending;					// submitted but not finished
+	bool m_quit;
+};
+
+#endif
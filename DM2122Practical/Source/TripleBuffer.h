@@ -0,0 +1,55 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/******************************************************************************/
+/*!
+		Class TripleBuffer:
+\brief	Hands the latest value from one writer thread to one reader thread
+		without locks or either side waiting. The writer fills Back and
+		publishes it; the reader acquires the newest published value into
+		Front and keeps reading it until it acquires again. The third slot
+		sits between them, so neither ever touches the slot the other is
+		using. Values published faster than the reader acquires are
+		dropped; the reader always sees the newest.
+
+		Back holds whatever was published two swaps ago, so the writer
+		must set all of it each time.
+*/
+/******************************************************************************/
+template<typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : m_back(0), m_front(1), m_middle(2) {}
+
+	//Writer thread only
+	T& Back() { return m_slots[m_back]; }
+	void Publish()
+	{
+		m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	//Reader thread only; false, keeping the current Front, if nothing new was published
+	bool Acquire()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+			return false;
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+	const T& Front() const { return m_slots[m_front]; }
+
+private:
+	//The middle index carries a flag while it holds a value not yet acquired
+	static const unsigned INDEX = 3;
+	static const unsigned FRESH = 4;
+
+	T m_slots[3];
+	unsigned m_back; //Writer's
+	unsigned m_front; //Reader's
+	std::atomic<unsigned> m_middle;
+};
+
+#endif
@@ -1,9 +1,9 @@
 #include "Utility.h"
+#include "Mtx44Kernels.h"
 
 Position operator*(const Mtx44& lhs, const Position& rhs)
 {
-	float b[4];
-	for (int i = 0; i < 4; i++)
-		b[i] = lhs.a[0 * 4 + i] * rhs.x + lhs.a[1 * 4 + i] * rhs.y + lhs.a[2 * 4 + i] * rhs.z + lhs.a[3 * 4 + i] * 1;
+	float b[4] = { rhs.x, rhs.y, rhs.z, 1 };
+	Mtx44Kernels::Transform(lhs.a, b, b);
 	return Position(b[0], b[1], b[2]);
 }
\ No newline at end of file
@@ -1,21 +1,21 @@
 #ifndef VERTEX_H
 #define VERTEX_H
 
+#include <type_traits>
 #include "Vector3.h"
 
 struct Position
 {
 	float x, y, z;
-	Position(float x = 0, float y = 0, float z = 0) { Set(x, y, z); }
+	constexpr Position(float x = 0, float y = 0, float z = 0) : x(x), y(y), z(z) {}
 	void Set(float x, float y, float z) { this->x = x; this->y = y; this->z = z; }
 };
 
 struct TexCoord
 {
 	float u, v;
-	TexCoord(float u = 0, float v = 0)
+	constexpr TexCoord(float u = 0, float v = 0) : u(u), v(v)
 	{
-		Set(u, v);
 	}
 	void Set(float u, float v)
 	{
@@ -27,7 +27,7 @@ struct TexCoord
 struct Color 
 {
 	float r, g, b;
-	Color(float r = 1, float g = 1, float b = 1) { Set(r, g, b); }
+	constexpr Color(float r = 1, float g = 1, float b = 1) : r(r), g(g), b(b) {}
 	void Set(float r, float g, float b) { this->r = r; this->g = g; this->b = b; }
 };
 
@@ -38,4 +38,18 @@ struct Vertex
 	Vector3 normal;
 	TexCoord texCoord;
 };
+
+//A vertex moved by up to four joints of a skeleton, by the palette matrices
+//of joints[i] times weights[i]; the weights add up to 1
+struct SkinnedVertex
+{
+	Vertex vertex;
+	unsigned char joints[4];
+	float weights[4];
+};
+
+//Vertex arrays are copied with memcpy and uploaded as raw bytes, and the
+//fixed primitives in BakedMeshes are constexpr arrays of Vertex
+static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex must stay trivially copyable");
+static_assert(std::is_trivially_copyable<SkinnedVertex>::value, "SkinnedVertex must stay trivially copyable");
 #endif
@@ -1,9 +1,25 @@
-
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "Application.h"
+#include "PackFile.h"
+#include "SceneFile.h"
 
-int main( void )
+int main( int argc, char *argv[] )
 {
+	//"-pack Assets.pack Image//front.tga ..." writes the listed files into a pack and exits
+	if (argc >= 3 && strcmp(argv[1], "-pack") == 0)
+	{
+		std::vector<std::string> file_paths(argv + 3, argv + argc);
+		return SavePack(argv[2], file_paths, true) ? 0 : 1;
+	}
+	//"-scene Scene//Scene1.txt Scene//Scene1.scene" compiles a scene and exits
+	if (argc == 4 && strcmp(argv[1], "-scene") == 0)
+	{
+		return CompileScene(argv[2], argv[3]) ? 0 : 1;
+	}
+
 	Application app;
 	app.Init();
 	app.Run();
@@ -12,6 +12,7 @@ using namespace std;
 #include <GL/glew.h>
 
 #include "shader.hpp"
+#include "FileSystem.h"
 
 GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path){
 
@@ -20,37 +21,25 @@ GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path
 	GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
 	
 
-	// Read the Vertex Shader code from the file
-	std::string VertexShaderCode;
-	std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
-	if(VertexShaderStream.is_open()){
-		std::string Line = "";
-		while(getline(VertexShaderStream, Line))
-			VertexShaderCode += "\n" + Line;
-		VertexShaderStream.close();
-	}else{
+	// Read the shader code from the pack or file; the sources are passed to GL
+	// with their lengths so they are used in place without a copy
+	FileData VertexShaderFile;
+	if(!FileSystem::Open(vertex_file_path, VertexShaderFile)){
 		printf("Impossible to open %s. Are you in the right directory ? Don't forget to read the FAQ !\n", vertex_file_path);
 		getchar();
 		return 0;
 	}
-
-	// Read the Fragment Shader code from the file
-	std::string FragmentShaderCode;
-	std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
-	if(FragmentShaderStream.is_open()){
-		std::string Line = "";
-		while(getline(FragmentShaderStream, Line))
-			FragmentShaderCode += "\n" + Line;
-		FragmentShaderStream.close();
-	}
+	FileData FragmentShaderFile;
+	FileSystem::Open(fragment_file_path, FragmentShaderFile);
 
 	GLint Result = GL_FALSE;
 	int InfoLogLength;
 
 	// Compile Vertex Shader
 	printf("Compiling shader : %s\n", vertex_file_path);
-	char const * VertexSourcePointer = VertexShaderCode.c_str();
-	glShaderSource(VertexShaderID, 1, &VertexSourcePointer , NULL);
+	char const * VertexSourcePointer = (char const *)VertexShaderFile.Data();
+	GLint VertexSourceLength = (GLint)VertexShaderFile.Size();
+	glShaderSource(VertexShaderID, 1, &VertexSourcePointer , &VertexSourceLength);
 	glCompileShader(VertexShaderID);
 
 	// Check Vertex Shader
@@ -64,8 +53,9 @@ GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path
 
 	// Compile Fragment Shader
 	printf("Compiling shader : %s\n", fragment_file_path);
-	char const * FragmentSourcePointer = FragmentShaderCode.c_str();
-	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer , NULL);
+	char const * FragmentSourcePointer = FragmentShaderFile.IsOpen() ? (char const *)FragmentShaderFile.Data() : "";
+	GLint FragmentSourceLength = (GLint)FragmentShaderFile.Size();
+	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer , &FragmentSourceLength);
 	glCompileShader(FragmentShaderID);
 
 	// Check Fragment Shader